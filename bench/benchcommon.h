@@ -0,0 +1,206 @@
+// benchcommon.h
+#ifndef BENCHCOMMON_H
+#define BENCHCOMMON_H
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QDate>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QRandomGenerator>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+#include <limits>
+#include "book.h"
+#include "bookcopy.h"
+
+#if defined(Q_OS_WIN)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+// 各基准程序共用的工具：输出、计时、常驻内存、数据目录和测试数据生成
+namespace Bench {
+
+inline QTextStream& out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+// 命令行第index个参数为正整数时返回它，否则返回默认值
+inline int intArg(int argc, char *argv[], int index, int defaultValue)
+{
+    if (index < argc) {
+        bool ok = false;
+        const int value = QByteArray(argv[index]).toInt(&ok);
+        if (ok && value > 0) {
+            return value;
+        }
+    }
+    return defaultValue;
+}
+
+// 当前进程的常驻内存（字节），不支持的平台返回-1
+inline qint64 residentBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return qint64(counters.WorkingSetSize);
+    }
+    return -1;
+#elif defined(Q_OS_LINUX)
+    // statm第二项是常驻页数
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2) {
+        return -1;
+    }
+    return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return -1;
+#endif
+}
+
+// 执行fn共repeat次，返回最快一次的耗时（纳秒），排除首次运行和调度带来的抖动
+template <typename Function>
+qint64 bestOf(int repeat, Function fn)
+{
+    qint64 best = std::numeric_limits<qint64>::max();
+    QElapsedTimer timer;
+    for (int i = 0; i < repeat; ++i) {
+        timer.start();
+        fn();
+        best = std::min(best, timer.nsecsElapsed());
+    }
+    return best;
+}
+
+inline QString millis(qint64 nanos)
+{
+    return QString::number(nanos / 1e6, 'f', 2) + " ms";
+}
+
+// 生成count本结构与真实馆藏相近的图书：中英文书名混合，类别、馆藏地址、出版社、作者取值很少。
+// 同一seed每次生成的数据相同，便于前后对比。
+inline QVector<Book> generateBooks(int count, bool withDescription, quint32 seed = 20240901)
+{
+    static const QStringList subjects = {
+        "数据结构", "操作系统", "计算机网络", "线性代数", "概率论", "信号与系统", "电路分析",
+        "明代史", "中国哲学", "西方经济学", "红楼梦", "唐诗", "量子力学", "有机化学", "微观经济学"};
+    static const QStringList suffixes = {"教程", "导论", "原理", "实践", "研究", "十讲", "精解"};
+    static const QStringList englishTopics = {
+        "Algorithms", "Operating Systems", "Compilers", "Machine Learning", "Linear Algebra",
+        "Distributed Systems", "Modern Physics", "World History", "Microeconomics", "Databases"};
+    static const QStringList englishPrefixes = {
+        "Introduction to", "Principles of", "A Guide to", "Advanced", "Essentials of", "Practical"};
+    static const QStringList categories = {
+        "计算机科学", "文学", "历史", "科学", "外语", "艺术", "经济", "哲学", "数学", "医学", "法律", "教育"};
+    static const QStringList locations = {"三牌楼图书馆", "仙林图书馆"};
+    static const QStringList publishers = {
+        "清华大学出版社", "机械工业出版社", "人民文学出版社", "高等教育出版社", "电子工业出版社",
+        "商务印书馆", "科学出版社", "中信出版社", "O'Reilly Media", "Addison-Wesley"};
+
+    QStringList authors;
+    for (int i = 0; i < 500; ++i) {
+        authors.append(QString("作者%1").arg(i));
+    }
+
+    QRandomGenerator random(seed);
+    const QDate firstDay(2015, 1, 1);
+    QVector<Book> books;
+    books.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Book book;
+        book.indexId = QString("B%1").arg(i, 7, 10, QChar('0'));
+        if (random.bounded(3) == 0) {
+            book.name = englishPrefixes.at(random.bounded(englishPrefixes.size())) + ' '
+                        + englishTopics.at(random.bounded(englishTopics.size()))
+                        + QString(" (%1th Edition)").arg(random.bounded(2, 12));
+        } else {
+            book.name = subjects.at(random.bounded(subjects.size()))
+                        + suffixes.at(random.bounded(suffixes.size()))
+                        + QString("（第%1版）").arg(random.bounded(1, 9));
+        }
+        book.author = authors.at(random.bounded(authors.size()));
+        book.publisher = publishers.at(random.bounded(publishers.size()));
+        book.location = locations.at(random.bounded(locations.size()));
+        book.category = categories.at(random.bounded(categories.size()));
+        book.price = random.bounded(1000, 20000) / 100.0;
+        book.inDate = firstDay.addDays(random.bounded(3650));
+        book.borrowCount = random.bounded(60);
+        if (withDescription) {
+            book.description = QString("%1一书系统介绍了相关领域的基本概念、方法和典型应用，适合作为高等院校教材或自学参考。")
+                                   .arg(book.name);
+        }
+        books.append(book);
+    }
+    return books;
+}
+
+// 各管理器的数据目录是 <可执行文件目录>/../src/resource；基准程序输出到构建目录的bench/bin，
+// 只有数据目录确实位于构建目录下（BENCH_DATA_DIR）时才清空它，返回false表示不是从构建目录运行
+inline bool resetDataDir()
+{
+    const QString dataDir = QDir(QCoreApplication::applicationDirPath() + "/../src/resource").absolutePath();
+    if (dataDir != QDir(QStringLiteral(BENCH_DATA_DIR)).absolutePath()) {
+        out() << "请从构建目录运行本程序（数据目录应为 " << BENCH_DATA_DIR << "）" << Qt::endl;
+        return false;
+    }
+    QDir(dataDir).removeRecursively();
+    return QDir().mkpath(dataDir);
+}
+
+// 按导入格式（DatabaseManager::importFromJson）写出图书文件，每本书带copiesPerBook个副本
+inline bool writeCatalog(const QString &filePath, const QVector<Book> &books, int copiesPerBook = 1)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Cannot open catalog file for writing:" << file.errorString();
+        return false;
+    }
+
+    file.write("[\n");
+    for (int i = 0; i < books.size(); ++i) {
+        const Book &book = books.at(i);
+        QJsonObject obj;
+        toJson(obj, book);
+
+        QJsonArray copies;
+        for (int n = 1; n <= copiesPerBook; ++n) {
+            BookCopy copy;
+            copy.copyId = book.indexId + "_" + QString::number(n);
+            copy.indexId = book.indexId;
+            copy.copyNumber = n;
+            copies.append(copy.toJson());
+        }
+        obj["copies"] = copies;
+
+        file.write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+        file.write(i + 1 < books.size() ? ",\n" : "\n");
+    }
+    file.write("]\n");
+    return true;
+}
+
+} // namespace Bench
+
+#endif // BENCHCOMMON_H
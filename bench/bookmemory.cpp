@@ -0,0 +1,83 @@
+// bookmemory.cpp
+// 内存基准：导入N本图书，分阶段报告常驻内存及每本书摊到的字节数，
+// 用来确认图书只在DatabaseManager的存储中常驻一份，LibraryManager加载时不再复制。
+// 用法：bench_book_memory [图书数量，默认200000]
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include "benchcommon.h"
+#include "databasemanager.h"
+#include "librarymanager.h"
+
+namespace {
+
+void report(const QString &stage, qint64 rss, qint64 baseline, int count)
+{
+    const double perBook = count > 0 ? double(rss - baseline) / count : 0.0;
+    Bench::out() << stage.leftJustified(28)
+                 << QString::number(rss / (1024.0 * 1024.0), 'f', 1).rightJustified(10) << " MB"
+                 << QString::number(perBook, 'f', 0).rightJustified(10) << " 字节/本" << Qt::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int count = Bench::intArg(argc, argv, 1, 200000);
+
+    if (Bench::residentBytes() < 0) {
+        Bench::out() << "当前平台无法读取常驻内存" << Qt::endl;
+        return 1;
+    }
+
+    if (!Bench::resetDataDir()) {
+        return 1;
+    }
+
+    QTemporaryDir tempDir;
+    const QString catalogPath = tempDir.filePath("catalog.json");
+    {
+        // 生成的数据只在这个作用域内存在，测量前已经释放
+        const QVector<Book> books = Bench::generateBooks(count, true);
+        if (!tempDir.isValid() || !Bench::writeCatalog(catalogPath, books)) {
+            return 1;
+        }
+    }
+
+    // 创建各单例（空库时会导入少量示例数据），此时的内存作为基线
+    LibraryManager &library = LibraryManager::instance();
+    DatabaseManager &db = DatabaseManager::instance();
+    const int initialBooks = db.getTotalBookCount();
+    const qint64 baseline = Bench::residentBytes();
+
+    if (!db.importFromJson(catalogPath)) {
+        Bench::out() << "导入失败" << Qt::endl;
+        return 1;
+    }
+    const int loaded = db.getTotalBookCount() - initialBooks;
+    const qint64 afterStore = Bench::residentBytes();
+
+    // LibraryManager只重建统计和索引，图书本身仍由DatabaseManager持有
+    library.loadFromDatabase();
+    const qint64 afterLibrary = Bench::residentBytes();
+
+    int sameRecord = 0;
+    for (int slot = 0; slot < db.slotCount(); ++slot) {
+        const Book *book = db.bookAt(slot);
+        if (book && library.findByIndexId(book->indexId) == book) {
+            ++sameRecord;
+        }
+    }
+
+    // 对照：旧实现中LibraryManager::books_那样再保存一份整表
+    const QVector<Book> duplicate = db.getAllBooks();
+    const qint64 afterDuplicate = Bench::residentBytes();
+
+    Bench::out() << "图书数量: " << loaded << Qt::endl;
+    report("基线（各单例已创建）", baseline, baseline, loaded);
+    report("导入到DatabaseManager", afterStore, baseline, loaded);
+    report("LibraryManager加载（增量）", afterLibrary, afterStore, loaded);
+    report("对照：再复制一份整表（增量）", afterDuplicate, afterLibrary, duplicate.size());
+    Bench::out() << "LibraryManager返回存储中同一条记录: " << sameRecord << "/" << db.getTotalBookCount() << Qt::endl;
+    return sameRecord == db.getTotalBookCount() ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+// bookscan.cpp
+// 列式扫描基准：BookStore的热数据列上的聚合/筛选，对比原先在QVector<Book>上逐本扫描的写法。
+// 对照表中两边都在调用线程上顺序执行；BookStore的筛选平时经ParallelScan并行，并行的耗时单独报告。
+// 用法：bench_book_scan [行数，默认1000000] [重复次数，默认10]
+#include <QCoreApplication>
+#include <QHash>
+#include <climits>
+#include "benchcommon.h"
+#include "bookstore.h"
+#include "parallelscan.h"
+#include "stringpool.h"
+
+namespace {
+
+// 原先的写法：遍历完整的Book，比较字符串字段
+double vectorTotalPrice(const QVector<Book> &books)
+{
+    double total = 0.0;
+    for (const Book &book : books) {
+        total += book.price;
+    }
+    return total;
+}
+
+QVector<int> vectorWithCategory(const QVector<Book> &books, const QString &category)
+{
+    QVector<int> result;
+    for (int i = 0; i < books.size(); ++i) {
+        if (books.at(i).category == category) {
+            result.append(i);
+        }
+    }
+    return result;
+}
+
+QHash<QString, int> vectorCountByLocation(const QVector<Book> &books)
+{
+    QHash<QString, int> counts;
+    for (const Book &book : books) {
+        counts[book.location]++;
+    }
+    return counts;
+}
+
+void report(const QString &name, qint64 vectorNanos, qint64 columnNanos, bool same)
+{
+    Bench::out() << name.leftJustified(18)
+                 << Bench::millis(vectorNanos).rightJustified(12)
+                 << Bench::millis(columnNanos).rightJustified(12)
+                 << QString::number(double(vectorNanos) / std::max<qint64>(columnNanos, 1), 'f', 1).rightJustified(8) << "x"
+                 << (same ? "" : "  结果不一致!") << Qt::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int rows = Bench::intArg(argc, argv, 1, 1000000);
+    const int repeat = Bench::intArg(argc, argv, 2, 10);
+
+    const QVector<Book> books = Bench::generateBooks(rows, false);
+    StringPool &pool = StringPool::instance();
+    BookStore store;
+    store.reserve(rows);
+    for (const Book &book : books) {
+        store.append(book, pool.idOf(book.category), pool.idOf(book.location));
+    }
+
+    const QString category = QStringLiteral("历史");
+    const int categoryId = pool.findId(category);
+    const QString location = QStringLiteral("仙林图书馆");
+    const int locationId = pool.findId(location);
+
+    // 对照表只比较存储布局，先关掉并行，筛选在调用线程上顺序扫描
+    ParallelScan &scan = ParallelScan::instance();
+    const int minParallelCount = scan.minParallelCount();
+    scan.setMinParallelCount(INT_MAX);
+
+    Bench::out() << rows << " 行，每项取 " << repeat << " 次中最快的一次，均为单线程" << Qt::endl;
+    Bench::out() << QString("操作").leftJustified(18) << QString("QVector<Book>").rightJustified(12)
+                 << QString("BookStore").rightJustified(12) << QString("加速比").rightJustified(8) << Qt::endl;
+
+    double vectorTotal = 0.0;
+    double columnTotal = 0.0;
+    const qint64 vectorPrice = Bench::bestOf(repeat, [&] { vectorTotal = vectorTotalPrice(books); });
+    const qint64 columnPrice = Bench::bestOf(repeat, [&] { columnTotal = store.totalPrice(); });
+    report("总价值", vectorPrice, columnPrice, qFuzzyCompare(vectorTotal, columnTotal));
+
+    QVector<int> vectorSlots;
+    QVector<int> columnSlots;
+    const qint64 vectorFilter = Bench::bestOf(repeat, [&] { vectorSlots = vectorWithCategory(books, category); });
+    const qint64 columnFilter = Bench::bestOf(repeat, [&] { columnSlots = store.slotsWithCategory(categoryId); });
+    report("按类别筛选", vectorFilter, columnFilter, vectorSlots == columnSlots);
+
+    QHash<QString, int> vectorCounts;
+    QVector<int> columnCounts;
+    const qint64 vectorCount = Bench::bestOf(repeat, [&] { vectorCounts = vectorCountByLocation(books); });
+    const qint64 columnCount = Bench::bestOf(repeat, [&] { columnCounts = store.countByLocation(); });
+    report("按馆藏地址计数", vectorCount, columnCount,
+           locationId < columnCounts.size() && vectorCounts.value(location) == columnCounts.at(locationId));
+
+    // 恢复默认阈值，单独报告实际使用的并行筛选相对顺序列扫描的加速
+    scan.setMinParallelCount(minParallelCount);
+    QVector<int> parallelSlots;
+    const qint64 parallelFilter = Bench::bestOf(repeat, [&] { parallelSlots = store.slotsWithCategory(categoryId); });
+    Bench::out() << Qt::endl << QString("操作").leftJustified(18) << QString("顺序").rightJustified(12)
+                 << QString("%1线程").arg(scan.threadCount()).rightJustified(12)
+                 << QString("加速比").rightJustified(8) << Qt::endl;
+    report("按类别筛选（列）", columnFilter, parallelFilter, parallelSlots == columnSlots);
+    return 0;
+}
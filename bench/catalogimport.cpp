@@ -0,0 +1,156 @@
+// catalogimport.cpp
+// 图书导入基准与格式检查：
+// 1. 流式导入N本图书（每本带若干副本），报告吞吐、导入过程中的常驻内存峰值和导入后的常驻内存，
+//    并核对新增的图书数和副本数（副本按批插入，批次边界上不能丢也不能重）
+// 2. 四种格式错误的小文件：开头多余逗号、两个连续逗号、']' 之后还有内容、文件被截断。
+//    每种都应导入失败，且出错位置之前的记录照常保存
+// 任何一项不符时返回非零。
+// 用法：bench_catalog_import [图书数量，默认200000] [每本副本数，默认3]
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include "benchcommon.h"
+#include "bookcopymanager.h"
+#include "databasemanager.h"
+
+namespace {
+
+double megabytes(qint64 bytes)
+{
+    return bytes / (1024.0 * 1024.0);
+}
+
+struct MalformedCase {
+    QString label;
+    QByteArray content;
+    int expectedBooks;   // 出错之前应保存的图书数
+};
+
+// 用writeCatalog写出5条合法记录再按行拆开，拼成各种格式错误的文件
+QVector<MalformedCase> malformedCases(const QString &dir, int copiesPerBook)
+{
+    const QStringList labels = {"开头多余逗号", "两个连续逗号", "']'之后还有内容", "文件被截断"};
+    QVector<MalformedCase> cases;
+    for (int c = 0; c < labels.size(); ++c) {
+        QVector<Book> books = Bench::generateBooks(5, false, 20240904 + c);
+        for (int i = 0; i < books.size(); ++i) {
+            books[i].indexId = QString("E%1-%2").arg(c).arg(i);
+        }
+        const QString path = dir + QString("/valid-%1.json").arg(c);
+        if (!Bench::writeCatalog(path, books, copiesPerBook)) {
+            return {};
+        }
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return {};
+        }
+        QList<QByteArray> records;
+        for (const QByteArray &line : file.readAll().split('\n')) {
+            if (line.startsWith('{')) {
+                records.append(line.endsWith(',') ? line.chopped(1) : line);
+            }
+        }
+
+        MalformedCase item{labels.at(c), QByteArray(), 0};
+        switch (c) {
+        case 0:
+            item.content = "[,\n" + records.join(",\n") + "\n]\n";
+            item.expectedBooks = 0;
+            break;
+        case 1:
+            item.content = "[\n" + records.first() + ",,\n" + records.mid(1).join(",\n") + "\n]\n";
+            item.expectedBooks = 1;
+            break;
+        case 2:
+            item.content = "[\n" + records.join(",\n") + "\n]\n{\"indexId\":\"extra\"}\n";
+            item.expectedBooks = records.size();
+            break;
+        default:
+            item.content = "[\n" + records.mid(0, records.size() - 1).join(",\n") + ",\n"
+                           + records.last().left(records.last().size() / 2);
+            item.expectedBooks = records.size() - 1;
+            break;
+        }
+        cases.append(item);
+    }
+    return cases;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int count = Bench::intArg(argc, argv, 1, 200000);
+    const int copiesPerBook = Bench::intArg(argc, argv, 2, 3);
+
+    if (!Bench::resetDataDir()) {
+        return 1;
+    }
+
+    QTemporaryDir tempDir;
+    const QString catalogPath = tempDir.filePath("catalog.json");
+    if (!tempDir.isValid() || !Bench::writeCatalog(catalogPath, Bench::generateBooks(count, true), copiesPerBook)) {
+        return 1;
+    }
+    const qint64 fileBytes = QFileInfo(catalogPath).size();
+
+    // 创建各单例（空库时会导入少量示例数据），此时的图书数、副本数和内存作为基线
+    DatabaseManager &db = DatabaseManager::instance();
+    BookCopyManager &copies = BookCopyManager::instance();
+    int books = db.getTotalBookCount();
+    int copyTotal = copies.getAllCopies().size();
+    const qint64 baseline = Bench::residentBytes();
+
+    // 进度回调约每0.5%调用一次，借它采样导入过程中的常驻内存
+    qint64 peak = baseline;
+    QElapsedTimer timer;
+    timer.start();
+    const bool imported = db.importFromJson(catalogPath, [&](qint64, qint64) {
+        peak = std::max(peak, Bench::residentBytes());
+    });
+    const qint64 nanos = timer.nsecsElapsed();
+    const qint64 after = Bench::residentBytes();
+
+    const int addedBooks = db.getTotalBookCount() - books;
+    const int addedCopies = copies.getAllCopies().size() - copyTotal;
+    bool allPassed = imported && addedBooks == count && addedCopies == count * copiesPerBook;
+    Bench::out() << count << " 本图书，每本 " << copiesPerBook << " 个副本，文件 "
+                 << QString::number(megabytes(fileBytes), 'f', 1) << " MB" << Qt::endl;
+    Bench::out() << "导入耗时 " << Bench::millis(nanos) << "，"
+                 << QString::number(megabytes(fileBytes) / std::max(nanos / 1e9, 1e-9), 'f', 1) << " MB/s，"
+                 << QString::number(count / std::max(nanos / 1e9, 1e-9), 'f', 0) << " 本/s" << Qt::endl;
+    if (baseline >= 0) {
+        Bench::out() << "常驻内存：基线 " << QString::number(megabytes(baseline), 'f', 1)
+                     << " MB，导入中峰值 " << QString::number(megabytes(peak), 'f', 1)
+                     << " MB，导入后 " << QString::number(megabytes(after), 'f', 1) << " MB" << Qt::endl;
+    }
+    Bench::out() << "新增图书 " << addedBooks << "/" << count << "，新增副本 " << addedCopies << "/"
+                 << count * copiesPerBook << (allPassed ? "" : "  不符!") << Qt::endl;
+
+    const QVector<MalformedCase> cases = malformedCases(tempDir.path(), copiesPerBook);
+    if (cases.isEmpty()) {
+        return 1;
+    }
+    for (const MalformedCase &item : cases) {
+        const QString path = tempDir.filePath("malformed.json");
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(item.content) != item.content.size()) {
+            return 1;
+        }
+        file.close();
+
+        books = db.getTotalBookCount();
+        copyTotal = copies.getAllCopies().size();
+        const bool accepted = db.importFromJson(path);
+        const int keptBooks = db.getTotalBookCount() - books;
+        const int keptCopies = copies.getAllCopies().size() - copyTotal;
+        const bool ok = !accepted && keptBooks == item.expectedBooks
+                        && keptCopies == item.expectedBooks * copiesPerBook;
+        allPassed = allPassed && ok;
+        Bench::out() << item.label.leftJustified(16) << (accepted ? "导入成功" : "导入失败")
+                     << "，保留图书 " << keptBooks << "/" << item.expectedBooks
+                     << "，副本 " << keptCopies << (ok ? "" : "  不符!") << Qt::endl;
+    }
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+// circulation.cpp
+// 流通日志基准与持久化检查：在临时目录中依次运行
+// 1. 迁移：U个用户、每人B条旧borrows记录迁移为事件
+// 2. 中断后重新迁移：恢复迁移前的users.json，并截掉日志末尾最后一个用户的标记和几条事件，
+//    模拟在该用户写到一半时崩溃；再次迁移应只补上被截掉的借阅，不重复写入
+// 3. 追加：N次借出和N/2次归还，报告每条事件的耗时
+// 4. 重放：复制日志目录并在末尾追加半条记录（模拟写到一半断电），重新打开并核对记录数
+// 5. 归档：保留期限设为30天，归档全部迁移来的已还记录后重新打开，核对热日志、归档和合并后的历史
+// 每一步都核对结果，任何一项不符时返回非零。
+// 用法：bench_circulation [用户数，默认2000] [每人旧记录数，默认20] [新事件数，默认100000]
+#include <QCoreApplication>
+#include <QDirIterator>
+#include <QTemporaryDir>
+#include "benchcommon.h"
+#include "circulationlog.h"
+#include "userstore.h"
+
+namespace {
+
+bool allPassed = true;
+
+void report(const QString &stage, qint64 nanos, const QString &detail, bool ok)
+{
+    allPassed = allPassed && ok;
+    Bench::out() << stage.leftJustified(20) << Bench::millis(nanos).rightJustified(12) << "  "
+                 << detail << (ok ? "" : "  不符!") << Qt::endl;
+}
+
+bool copyDir(const QString &from, const QString &to)
+{
+    QDir().mkpath(to);
+    QDirIterator it(from, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        const QString target = to + "/" + QDir(from).relativeFilePath(path);
+        if (it.fileInfo().isDir()) {
+            QDir().mkpath(target);
+        } else if (!QFile::copy(path, target)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 旧格式的users.json：每个用户带borrows数组，约八成已归还，日期都在一年以前
+QJsonArray legacyUsers(int userCount, int borrowsPerUser, int &returnedCount)
+{
+    QRandomGenerator random(20240903);
+    const QDate today = QDate::currentDate();
+    QJsonArray users;
+    returnedCount = 0;
+    for (int u = 0; u < userCount; ++u) {
+        QJsonArray borrows;
+        for (int b = 0; b < borrowsPerUser; ++b) {
+            const QDate borrowDate = today.addDays(-random.bounded(400, 1500));
+            QJsonObject borrow;
+            borrow["indexId"] = QString("B%1").arg(random.bounded(500000), 7, 10, QChar('0'));
+            borrow["bookName"] = QString("旧书%1").arg(b);
+            borrow["borrowDate"] = borrowDate.toString(Qt::ISODate);
+            borrow["dueDate"] = borrowDate.addDays(30).toString(Qt::ISODate);
+            const bool returned = random.bounded(5) != 0;
+            borrow["returned"] = returned;
+            if (returned) {
+                borrow["returnDate"] = borrowDate.addDays(random.bounded(7, 60)).toString(Qt::ISODate);
+                ++returnedCount;
+            }
+            borrows.append(borrow);
+        }
+
+        QJsonObject user;
+        user["username"] = QString("user%1").arg(u);
+        user["password"] = "123456";
+        user["role"] = "student";
+        user["borrows"] = borrows;
+        users.append(user);
+    }
+    return users;
+}
+
+int returnedRecords(const CirculationLog &log, int userCount)
+{
+    int returned = 0;
+    for (int u = 0; u < userCount; ++u) {
+        for (const BorrowRecord &record : log.recordsForUser(QString("user%1").arg(u))) {
+            returned += record.returned;
+        }
+    }
+    return returned;
+}
+
+// 截掉最后一个分段末尾的迁移标记和它之前的eventCount条事件，返回其中借出事件的条数
+int cutMigrationTail(const QString &circulationDir, int eventCount)
+{
+    const QStringList segments = QDir(circulationDir).entryList(QStringList() << "segment-*.log", QDir::Files, QDir::Name);
+    if (segments.isEmpty()) {
+        return -1;
+    }
+    QFile file(circulationDir + "/" + segments.last());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    QList<QByteArray> lines = file.readAll().split('\n');
+    file.close();
+    while (!lines.isEmpty() && lines.last().isEmpty()) {
+        lines.removeLast();
+    }
+    if (lines.isEmpty() || QJsonDocument::fromJson(lines.last()).object().value("type").toString() != "migrated") {
+        return -1;
+    }
+
+    lines.removeLast();
+    int cutBorrows = 0;
+    for (int i = 0; i < eventCount && !lines.isEmpty(); ++i) {
+        cutBorrows += QJsonDocument::fromJson(lines.takeLast()).object().value("type").toString() == "borrow";
+    }
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return -1;
+    }
+    for (const QByteArray &line : std::as_const(lines)) {
+        file.write(line + '\n');
+    }
+    return cutBorrows;
+}
+
+bool writeUsers(const QString &path, const QJsonArray &users)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(QJsonDocument(users).toJson(QJsonDocument::Compact)) > 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int userCount = Bench::intArg(argc, argv, 1, 2000);
+    const int borrowsPerUser = Bench::intArg(argc, argv, 2, 20);
+    const int newEvents = Bench::intArg(argc, argv, 3, 100000);
+    const int legacyTotal = userCount * borrowsPerUser;
+
+    QTemporaryDir tempDir;
+    if (!tempDir.isValid()) {
+        return 1;
+    }
+    const QString root = tempDir.path();
+    int legacyReturned = 0;
+    const QJsonArray legacy = legacyUsers(userCount, borrowsPerUser, legacyReturned);
+    QDir().mkpath(root + "/a");
+    QDir().mkpath(root + "/b");
+    if (!writeUsers(root + "/a/users.json", legacy) || !writeUsers(root + "/b/users.json", legacy)) {
+        return 1;
+    }
+
+    UserStore &users = UserStore::instance();
+    CirculationLog &log = CirculationLog::instance();
+    QElapsedTimer timer;
+    Bench::out() << userCount << " 个用户，每人 " << borrowsPerUser << " 条旧记录，"
+                 << newEvents << " 次新借出" << Qt::endl;
+
+    // 1. 迁移
+    timer.start();
+    bool opened = users.open(root + "/a/users.json") && log.open(root + "/a/circulation");
+    int migrated = opened ? log.migrateLegacyBorrows(users) : -1;
+    report("迁移旧记录", timer.nsecsElapsed(),
+           QString("迁移 %1 条，旧数组剩余 %2 个用户").arg(migrated).arg(users.legacyBorrows().size()),
+           migrated == legacyTotal && log.recordCount() == legacyTotal && users.legacyBorrows().isEmpty());
+
+    // 2. 中断后重新迁移：b/users.json仍是迁移前的内容，日志截掉最后一个用户的标记和三条事件
+    const int cutEvents = std::min(3, borrowsPerUser);
+    const int cutBorrows = copyDir(root + "/a/circulation", root + "/b/circulation")
+                           ? cutMigrationTail(root + "/b/circulation", cutEvents) : -1;
+    timer.start();
+    opened = cutBorrows >= 0 && users.open(root + "/b/users.json") && log.open(root + "/b/circulation");
+    migrated = opened ? log.migrateLegacyBorrows(users) : -1;
+    const int returned = returnedRecords(log, userCount);
+    report("中断后重新迁移", timer.nsecsElapsed(),
+           QString("补写 %1 条（截掉借出 %2 条），已还 %3/%4").arg(migrated).arg(cutBorrows).arg(returned).arg(legacyReturned),
+           migrated == cutBorrows && log.recordCount() == legacyTotal && returned == legacyReturned
+               && users.legacyBorrows().isEmpty());
+
+    // 3. 追加借还事件
+    const QDate today = QDate::currentDate();
+    bool appended = true;
+    timer.start();
+    for (int i = 0; i < newEvents && appended; ++i) {
+        appended = log.recordBorrow(QString("user%1").arg(i % userCount), QString("N%1").arg(i),
+                                    QString("新书%1").arg(i), today, today.addDays(30));
+    }
+    for (int i = 0; i < newEvents / 2 && appended; ++i) {
+        appended = log.recordReturn(QString("user%1").arg(i % userCount), QString("N%1").arg(i), today);
+    }
+    const qint64 appendNanos = timer.nsecsElapsed();
+    const int eventCount = newEvents + newEvents / 2;
+    report("追加借还事件", appendNanos,
+           QString("%1 条事件，每条 %2 µs").arg(eventCount).arg(appendNanos / 1e3 / std::max(1, eventCount), 0, 'f', 1),
+           appended && log.recordCount() == legacyTotal + newEvents);
+    const int hotTotal = log.recordCount();
+
+    // 4. 重放：复制一份目录，末尾追加半条记录后重新打开
+    bool copied = copyDir(root + "/b/circulation", root + "/c/circulation");
+    const QStringList segments = QDir(root + "/c/circulation").entryList(QStringList() << "segment-*.log", QDir::Files, QDir::Name);
+    QFile tail(root + "/c/circulation/" + segments.value(segments.size() - 1));
+    copied = copied && !segments.isEmpty() && tail.open(QIODevice::Append) && tail.write("{\"type\":\"borrow\",\"us") > 0;
+    tail.close();
+    timer.start();
+    opened = copied && log.open(root + "/c/circulation");
+    report("重放日志", timer.nsecsElapsed(),
+           QString("%1 条记录，末尾半条记录已丢弃").arg(log.recordCount()),
+           opened && log.recordCount() == hotTotal);
+
+    // 5. 归档后重新打开：旧记录的归还日期都在三百多天以前，今天的归还留在热日志中
+    log.setArchiveHorizonDays(30);
+    const int sampleHistory = log.recordsForUser("user0", true).size();
+    timer.start();
+    const int archived = log.archiveClosedRecords(true);
+    const qint64 archiveNanos = timer.nsecsElapsed();
+    copied = copyDir(root + "/c/circulation", root + "/d/circulation");
+    opened = copied && log.open(root + "/d/circulation");
+    report("归档已还记录", archiveNanos,
+           QString("归档 %1 条，热日志剩 %2 条，user0 完整历史 %3/%4 条")
+               .arg(archived).arg(log.recordCount()).arg(log.recordsForUser("user0", true).size()).arg(sampleHistory),
+           opened && archived == legacyReturned && log.recordCount() == hotTotal - archived
+               && log.archivedRecordCount() == archived && log.recordsForUser("user0", true).size() == sampleHistory);
+
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+// passwordhash.cpp
+// 口令哈希基准：在不同的迭代次数下运行 PasswordHasher::verify，报告每秒可完成的登录验证数。
+// 与登录时一样带用户名验证；每次验证前清空登录缓存，测的是真正计算PBKDF2的开销；
+// 最后另报命中缓存（计算一次HMAC）时的速度。
+// 用法：bench_password_hash [每档至少运行的毫秒数，默认1000]
+#include <QCoreApplication>
+#include "benchcommon.h"
+#include "passwordhasher.h"
+
+namespace {
+
+// 在budgetMs毫秒内反复验证，返回每秒验证次数；clearCache为真时每次都重新计算
+double loginsPerSecond(const QString &stored, qint64 budgetMs, bool clearCache)
+{
+    PasswordHasher &hasher = PasswordHasher::instance();
+    QElapsedTimer timer;
+    timer.start();
+    int logins = 0;
+    do {
+        if (clearCache) {
+            hasher.clearCache();
+        }
+        if (!hasher.verify(QStringLiteral("correct horse"), stored, QStringLiteral("reader"))) {
+            Bench::out() << "验证失败" << Qt::endl;
+            return 0.0;
+        }
+        ++logins;
+    } while (timer.elapsed() < budgetMs || logins < 3);
+    return logins * 1e9 / timer.nsecsElapsed();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int budgetMs = Bench::intArg(argc, argv, 1, 1000);
+
+    PasswordHasher &hasher = PasswordHasher::instance();
+    const int defaultIterations = hasher.iterations();
+    const QVector<int> costs = {1000, 10000, 25000, defaultIterations, 100000, 200000};
+
+    Bench::out() << QString("迭代次数").leftJustified(12) << QString("登录/秒").rightJustified(12)
+                 << QString("单次耗时").rightJustified(14) << Qt::endl;
+    for (int iterations : costs) {
+        hasher.setIterations(iterations);
+        const QString stored = hasher.hash(QStringLiteral("correct horse"));
+        const double rate = loginsPerSecond(stored, budgetMs, true);
+        Bench::out() << (QString::number(iterations) + (iterations == defaultIterations ? "（默认）" : "")).leftJustified(12)
+                     << QString::number(rate, 'f', 1).rightJustified(12)
+                     << (QString::number(rate > 0 ? 1000.0 / rate : 0.0, 'f', 2) + " ms").rightJustified(14) << Qt::endl;
+    }
+
+    hasher.setIterations(defaultIterations);
+    const QString stored = hasher.hash(QStringLiteral("correct horse"));
+    hasher.clearCache();
+    hasher.verify(QStringLiteral("correct horse"), stored, QStringLiteral("reader"));
+    Bench::out() << "命中登录缓存: " << QString::number(loginsPerSecond(stored, budgetMs, false), 'f', 0)
+                 << " 登录/秒" << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,85 @@
+// scanscaling.cpp
+// 并行扫描的扩展性：用不同的线程数运行ParallelScan上的两类扫描，报告耗时和相对单线程的加速比。
+// - 全文匹配：与DatabaseManager::searchBooks相同的谓词，每行在六个字段上做TextMatcher匹配，计算密集
+// - 类别筛选：BookStore::slotsWithCategory，只读一列整数，受内存带宽限制
+// 线程数从1开始翻倍直到核心数，最后一档总是核心数本身。
+// 用法：bench_scan_scaling [行数，默认1000000] [重复次数，默认10]
+#include <QCoreApplication>
+#include <QThread>
+#include "benchcommon.h"
+#include "bookstore.h"
+#include "parallelscan.h"
+#include "stringpool.h"
+#include "textmatcher.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int rows = Bench::intArg(argc, argv, 1, 1000000);
+    const int repeat = Bench::intArg(argc, argv, 2, 10);
+
+    StringPool &pool = StringPool::instance();
+    BookStore store;
+    store.reserve(rows);
+    for (const Book &book : Bench::generateBooks(rows, false)) {
+        store.append(book, pool.idOf(book.category), pool.idOf(book.location));
+    }
+    const int categoryId = pool.findId(QStringLiteral("历史"));
+
+    const TextMatcher matcher(QStringLiteral("systems"));
+    const Book *books = store.books().constData();
+    const auto textMatch = [&](int slot) {
+        const Book &book = books[slot];
+        return !book.indexId.isEmpty() &&
+               (matcher.matches(book.name) ||
+                matcher.matches(book.category) ||
+                matcher.matches(book.location) ||
+                matcher.matches(book.indexId) ||
+                matcher.matches(book.author) ||
+                matcher.matches(book.publisher));
+    };
+
+    QVector<int> threadCounts;
+    const int cores = std::max(1, QThread::idealThreadCount());
+    for (int threads = 1; threads < cores; threads *= 2) {
+        threadCounts.append(threads);
+    }
+    threadCounts.append(cores);
+
+    ParallelScan &scan = ParallelScan::instance();
+    Bench::out() << rows << " 行，" << cores << " 个逻辑核心，每项取 " << repeat << " 次中最快的一次" << Qt::endl;
+    Bench::out() << QString("线程数").leftJustified(8)
+                 << QString("全文匹配").rightJustified(12) << QString("加速比").rightJustified(8)
+                 << QString("类别筛选").rightJustified(12) << QString("加速比").rightJustified(8) << Qt::endl;
+
+    qint64 serialText = 0;
+    qint64 serialColumn = 0;
+    QVector<int> expectedText;
+    QVector<int> expectedColumn;
+    bool consistent = true;
+    for (int threads : std::as_const(threadCounts)) {
+        scan.setThreadCount(threads);
+
+        QVector<int> textHits;
+        QVector<int> columnHits;
+        const qint64 text = Bench::bestOf(repeat, [&] { textHits = scan.filter(rows, textMatch); });
+        const qint64 column = Bench::bestOf(repeat, [&] { columnHits = store.slotsWithCategory(categoryId); });
+        if (threads == 1) {
+            serialText = text;
+            serialColumn = column;
+            expectedText = textHits;
+            expectedColumn = columnHits;
+        }
+        const bool same = textHits == expectedText && columnHits == expectedColumn;
+        consistent = consistent && same;
+
+        Bench::out() << QString::number(threads).leftJustified(8)
+                     << Bench::millis(text).rightJustified(12)
+                     << QString::number(double(serialText) / std::max<qint64>(text, 1), 'f', 2).rightJustified(8)
+                     << Bench::millis(column).rightJustified(12)
+                     << QString::number(double(serialColumn) / std::max<qint64>(column, 1), 'f', 2).rightJustified(8)
+                     << (same ? "" : "  结果与单线程不一致!") << Qt::endl;
+    }
+    Bench::out() << "全文匹配命中 " << expectedText.size() << "，类别筛选命中 " << expectedColumn.size() << Qt::endl;
+    return consistent ? 0 : 1;
+}
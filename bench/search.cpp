@@ -0,0 +1,127 @@
+// search.cpp
+// 检索基准：导入N本图书后，计时LibraryManager的倒排索引检索、拼音前缀检索和容错检索，
+// 对照每次查询5 ms的目标。数据走正常的导入和加载流程，索引与程序运行时建立的完全相同。
+// 英文书配上拉丁字母的作者名，容错检索的词表和倒排表规模接近真实馆藏。
+// 用法：bench_search [图书数量，默认500000] [重复次数，默认20]
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include "benchcommon.h"
+#include "databasemanager.h"
+#include "librarymanager.h"
+
+namespace {
+
+const double kTargetMs = 5.0;
+
+// 拉丁作者名：音节拼出约两千个姓，另有少量真实作者，供容错检索的拼写错误查询命中
+QString latinAuthor(QRandomGenerator &random)
+{
+    static const QStringList famous = {
+        "Silberschatz", "Alexander", "Tanenbaum", "Stroustrup", "Sedgewick", "Kernighan", "Cormen", "Knuth"};
+    static const QStringList heads = {
+        "Al", "Bren", "Car", "Dal", "El", "Fer", "Gar", "Hol", "Is", "Jan",
+        "Kel", "Lin", "Mar", "Nor", "Ol", "Per", "Ros", "Sil", "Tan", "Wal"};
+    static const QStringList mids = {"", "a", "er", "in", "o", "ver", "lan", "den"};
+    static const QStringList tails = {
+        "berg", "der", "ex", "man", "son", "ton", "ner", "ling", "schatz", "ford", "ski", "ez"};
+    static const QStringList given = {
+        "Abraham", "Peter", "Greg", "Andrew", "Thomas", "Donald", "Robert", "Maria", "Linda", "James"};
+
+    const QString surname = random.bounded(20) == 0
+                            ? famous.at(random.bounded(famous.size()))
+                            : heads.at(random.bounded(heads.size())) + mids.at(random.bounded(mids.size()))
+                                  + tails.at(random.bounded(tails.size()));
+    return given.at(random.bounded(given.size())) + ' ' + surname;
+}
+
+struct Query {
+    QString label;
+    QString keyword;
+    int kind;   // 0 倒排索引，1 拼音，2 容错
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int count = Bench::intArg(argc, argv, 1, 500000);
+    const int repeat = Bench::intArg(argc, argv, 2, 20);
+
+    if (!Bench::resetDataDir()) {
+        return 1;
+    }
+
+    QTemporaryDir tempDir;
+    const QString catalogPath = tempDir.filePath("catalog.json");
+    {
+        QVector<Book> books = Bench::generateBooks(count, false);
+        QRandomGenerator random(20240902);
+        for (Book &book : books) {
+            if (!book.name.contains(QChar(0xFF08))) {   // 英文书名（中文书名带全角括号）
+                book.author = latinAuthor(random);
+            }
+        }
+        if (!tempDir.isValid() || !Bench::writeCatalog(catalogPath, books)) {
+            return 1;
+        }
+    }
+
+    LibraryManager &library = LibraryManager::instance();
+    DatabaseManager &db = DatabaseManager::instance();
+    if (!db.importFromJson(catalogPath)) {
+        Bench::out() << "导入失败" << Qt::endl;
+        return 1;
+    }
+
+    // loadFromDatabase会重建倒排、拼音和容错三个索引
+    QElapsedTimer buildTimer;
+    buildTimer.start();
+    library.loadFromDatabase();
+    Bench::out() << db.getTotalBookCount() << " 本图书，建立检索索引 "
+                 << Bench::millis(buildTimer.nsecsElapsed()) << Qt::endl;
+    Bench::out() << "每项运行 " << repeat << " 次，目标 " << kTargetMs << " ms/次" << Qt::endl;
+    Bench::out() << QString("查询").leftJustified(28) << QString("命中").rightJustified(8)
+                 << QString("最快").rightJustified(12) << QString("平均").rightJustified(12) << Qt::endl;
+
+    const QVector<Query> queries = {
+        {"倒排 操作系统", "操作系统", 0},
+        {"倒排 Distributed Systems", "Distributed Systems", 0},
+        {"倒排 edition", "edition", 0},
+        {"倒排 Silberschatz", "Silberschatz", 0},
+        {"拼音 czxt", "czxt", 1},
+        {"拼音 hongloumeng", "hongloumeng", 1},
+        {"拼音 shu", "shu", 1},
+        {"容错 Silberchatz", "Silberchatz", 2},
+        {"容错 Alexnder", "Alexnder", 2},
+        {"容错 Distribted Systms", "Distribted Systms", 2},
+        {"容错 Algoritms", "Algoritms", 2},
+    };
+
+    bool allWithinTarget = true;
+    for (const Query &query : queries) {
+        int hits = 0;
+        QElapsedTimer total;
+        total.start();
+        const qint64 best = Bench::bestOf(repeat, [&] {
+            switch (query.kind) {
+            case 0:
+                hits = library.searchSlots(query.keyword).size();
+                break;
+            case 1:
+                hits = library.searchPinyinSlots(query.keyword).size();
+                break;
+            default:
+                hits = library.searchFuzzySlots(query.keyword).size();
+                break;
+            }
+        });
+        const qint64 mean = total.nsecsElapsed() / repeat;
+        const bool within = mean / 1e6 <= kTargetMs;
+        allWithinTarget = allWithinTarget && within;
+        Bench::out() << query.label.leftJustified(28) << QString::number(hits).rightJustified(8)
+                     << Bench::millis(best).rightJustified(12) << Bench::millis(mean).rightJustified(12)
+                     << (within ? "" : "  超出目标") << Qt::endl;
+    }
+    return allWithinTarget ? 0 : 2;
+}
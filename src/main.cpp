@@ -3,10 +3,15 @@
 #include <QDialog> // 包含 QDialog 头文件
 #include <QTimer>   // 用于延迟关闭登录窗口
 #include <QIcon>    // 用于设置应用图标
+#include <QSettings> // 读取数据目录下的settings.ini
+#include <QFileInfo>
+#include <QDebug>
 
 // 包含你的头文件
 #include "./widget/mainwindow.h"
 #include "./utils/log.h" // <--- 1. 包含登录对话框头文件
+#include "./utils/databasemanager.h"
+#include "./utils/passwordhasher.h"
 
 /**
  * @brief 主函数
@@ -28,6 +33,28 @@ int main(int argc, char *argv[])
     // 设置应用图标（使用ICO格式用于Windows任务栏和标题栏）
     a.setWindowIcon(QIcon(":/library.ico"));
 
+    // --- 加载图书数据并读取配置 ---
+    // 配置保存在数据目录下的settings.ini，文件或某项不存在时使用默认值
+    DatabaseManager &db = DatabaseManager::instance();
+    QSettings settings(QFileInfo(db.getDatabasePath()).absolutePath() + "/settings.ini", QSettings::IniFormat);
+    // 二进制列式快照默认关闭，需要时在配置中打开：[storage] binarySnapshot=true
+    db.setBinarySnapshotEnabled(settings.value("storage/binarySnapshot", false).toBool());
+    // 口令哈希的迭代次数（工作因子），须在登录对话框创建之前设置：[security] passwordIterations=50000
+    // 调高后旧账号在下次登录成功时自动按新值重新计算；bench_password_hash可测出各档的登录耗时
+    if (settings.contains("security/passwordIterations")) {
+        bool ok = false;
+        const int iterations = settings.value("security/passwordIterations").toInt(&ok);
+        // 写错或过小的值不采用，避免意外把口令哈希降成几乎没有成本
+        if (ok && iterations >= 1000) {
+            PasswordHasher::instance().setIterations(iterations);
+        } else {
+            qWarning() << "Ignoring invalid security/passwordIterations:" << settings.value("security/passwordIterations");
+        }
+    }
+    if (!db.loadError().isEmpty()) {
+        QMessageBox::critical(nullptr, "图书数据加载失败", db.loadError());
+    }
+
     // --- 创建并显示登录对话框 ---
     Log log;
 
@@ -0,0 +1,186 @@
+// asyncsearch.cpp
+#include "asyncsearch.h"
+#include "librarymanager.h"
+#include "databasemanager.h"
+#include <QPair>
+#include <algorithm>
+
+namespace {
+
+// 超过这个数量的上一次结果不再逐本细化，复制图书的代价反而比查索引高
+const int kMaxRefineRows = 5000;
+
+} // namespace
+
+struct AsyncSearch::Job {
+    quint64 generation;
+    QString keyword;
+    QString mode;
+    int fieldMask;
+
+    // 只有当前模式用到的那一个索引非空
+    SearchIndex searchIndex;
+    PinyinIndex pinyinIndex;
+    FuzzyIndex fuzzyIndex;
+
+    bool refine;                          // 是否在上一次结果中细化
+    QVector<QPair<int, Book>> previous;   // 上一次结果的槽位及图书副本
+};
+
+AsyncSearch::AsyncSearch(const LibraryManager &library, QObject *parent)
+    : QObject(parent)
+    , library_(library)
+    , generation_(0)
+    , lastFieldMask_(0)
+    , lastValid_(false)
+{
+    // 查询按提交顺序执行，新查询到来时旧查询很快就会放弃
+    pool_.setMaxThreadCount(1);
+
+    // 图书增删改后上一次结果可能已不准确，不能再拿来细化
+    connect(&library_, &LibraryManager::dataChanged, this, &AsyncSearch::invalidateCache);
+}
+
+AsyncSearch::~AsyncSearch()
+{
+    cancel();
+    pool_.waitForDone();
+}
+
+void AsyncSearch::cancel()
+{
+    ++generation_;
+    pool_.clear();   // 尚未开始的查询直接丢弃
+}
+
+void AsyncSearch::invalidateCache()
+{
+    lastValid_ = false;
+    lastSlots_.clear();
+}
+
+void AsyncSearch::submit(const QString &keyword, const QString &mode, int fieldMask)
+{
+    cancel();
+
+    Job job;
+    job.generation = generation_.load();
+    job.keyword = keyword;
+    job.mode = mode;
+    job.fieldMask = fieldMask;
+
+    // 容错模式允许的错误数随词长变化，延长查询不保证结果缩小，不做细化
+    job.refine = lastValid_ && mode != "typo" && mode == lastMode_ && fieldMask == lastFieldMask_ &&
+                 keyword.startsWith(lastKeyword_) && lastSlots_.size() <= kMaxRefineRows;
+
+    if (job.refine) {
+        const DatabaseManager &db = DatabaseManager::instance();
+        job.previous.reserve(lastSlots_.size());
+        for (int slot : std::as_const(lastSlots_)) {
+            if (const Book *book = db.bookAt(slot)) {
+                job.previous.append(qMakePair(slot, *book));
+            }
+        }
+    } else if (mode == "pinyin") {
+        job.pinyinIndex = library_.pinyinIndex();
+    } else if (mode == "typo") {
+        job.fuzzyIndex = library_.fuzzyIndex();
+    } else {
+        job.searchIndex = library_.searchIndex();
+    }
+
+    pool_.start([job, this]() {
+        run(job, generation_, this);
+    });
+}
+
+void AsyncSearch::run(const Job &job, const std::atomic<quint64> &generation, AsyncSearch *receiver)
+{
+    auto cancelled = [&]() { return generation.load() != job.generation; };
+    if (cancelled()) {
+        return;
+    }
+
+    QVector<int> slotList;
+    QVector<int> distances;
+
+    if (job.refine) {
+        // 在上一次结果中逐本重新打分，排序规则与索引查询一致：得分降序、槽位升序
+        struct Scored {
+            int slot;
+            int score;
+        };
+        QVector<Scored> scored;
+        scored.reserve(job.previous.size());
+        for (int i = 0; i < job.previous.size(); ++i) {
+            if ((i & 0xFF) == 0 && cancelled()) {
+                return;
+            }
+            const QPair<int, Book> &item = job.previous[i];
+            const int score = (job.mode == "pinyin")
+                                  ? PinyinIndex::scoreBook(item.second, job.keyword, job.fieldMask)
+                                  : SearchIndex::scoreBook(item.second, job.keyword, job.fieldMask);
+            if (score >= 0) {
+                scored.append(Scored{item.first, score});
+            }
+        }
+        std::sort(scored.begin(), scored.end(), [](const Scored &a, const Scored &b) {
+            return a.score != b.score ? a.score > b.score : a.slot < b.slot;
+        });
+        slotList.reserve(scored.size());
+        for (const Scored &s : std::as_const(scored)) {
+            slotList.append(s.slot);
+        }
+    } else if (job.mode == "pinyin") {
+        slotList = job.pinyinIndex.search(job.keyword, job.fieldMask);
+    } else if (job.mode == "typo") {
+        const QVector<FuzzyIndex::Match> matches = job.fuzzyIndex.search(job.keyword, job.fieldMask);
+        slotList.reserve(matches.size());
+        distances.reserve(matches.size());
+        for (const FuzzyIndex::Match &m : matches) {
+            slotList.append(m.slot);
+            distances.append(m.distance);
+        }
+    } else {
+        slotList = job.searchIndex.search(job.keyword, job.fieldMask);
+    }
+
+    if (cancelled()) {
+        return;
+    }
+
+    // 回到主线程送出结果；接收对象析构时排队中的调用会被丢弃
+    const quint64 gen = job.generation;
+    const QString keyword = job.keyword;
+    const QString mode = job.mode;
+    const int fieldMask = job.fieldMask;
+    QMetaObject::invokeMethod(receiver, [=]() {
+        receiver->deliver(gen, keyword, mode, fieldMask, slotList, distances);
+    }, Qt::QueuedConnection);
+}
+
+void AsyncSearch::deliver(quint64 generation, const QString &keyword, const QString &mode, int fieldMask,
+                          const QVector<int> &slotList, const QVector<int> &distances)
+{
+    if (generation != generation_.load()) {
+        return;   // 结果到达前又有新的输入
+    }
+
+    QVector<int> ranked = slotList;
+    if (mode == "typo") {
+        QVector<FuzzyIndex::Match> matches;
+        matches.reserve(slotList.size());
+        for (int i = 0; i < slotList.size(); ++i) {
+            matches.append(FuzzyIndex::Match{slotList[i], distances[i]});
+        }
+        ranked = library_.rankFuzzyMatches(matches);
+    }
+
+    lastKeyword_ = keyword;
+    lastMode_ = mode;
+    lastFieldMask_ = fieldMask;
+    lastSlots_ = ranked;
+    lastValid_ = true;
+
+    emit finished(keyword, mode, ranked);
+}
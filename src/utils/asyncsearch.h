@@ -0,0 +1,57 @@
+// asyncsearch.h
+#ifndef ASYNCSEARCH_H
+#define ASYNCSEARCH_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QThreadPool>
+#include <atomic>
+
+class LibraryManager;
+
+// 边输入边搜索的后台执行器
+// - submit() 复制一份当前模式要用的索引（隐式共享，代价是常数）交给工作线程查询，
+//   每次提交递增代号，旧代号的查询在各阶段检查到后直接放弃，结果也不会送达
+// - 新查询是上一次已完成查询的延长（如 "sil" -> "silb"）时，命中集合只会缩小，
+//   直接在上一次的结果里逐本细化，不再查索引
+// - 结果在主线程通过 finished 信号送出；容错模式在主线程按借阅次数做最终排序
+class AsyncSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AsyncSearch(const LibraryManager &library, QObject *parent = nullptr);
+    ~AsyncSearch() override;
+
+    // mode 取值同主窗口搜索方式："pinyin"、"typo"，其余按 fieldMask 走全文索引
+    void submit(const QString &keyword, const QString &mode, int fieldMask);
+    // 作废所有未完成的查询
+    void cancel();
+
+signals:
+    void finished(const QString &keyword, const QString &mode, const QVector<int> &slotList);
+
+private slots:
+    void invalidateCache();
+
+private:
+    struct Job;
+
+    static void run(const Job &job, const std::atomic<quint64> &generation, AsyncSearch *receiver);
+    void deliver(quint64 generation, const QString &keyword, const QString &mode, int fieldMask,
+                 const QVector<int> &slotList, const QVector<int> &distances);
+
+    const LibraryManager &library_;
+    QThreadPool pool_;
+    std::atomic<quint64> generation_;
+
+    // 上一次送达的结果，供延长的查询细化
+    QString lastKeyword_;
+    QString lastMode_;
+    int lastFieldMask_;
+    QVector<int> lastSlots_;
+    bool lastValid_;
+};
+
+#endif // ASYNCSEARCH_H
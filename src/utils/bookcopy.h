@@ -4,6 +4,7 @@
 
 #include <QString>
 #include <QDate>
+#include "stringpool.h"
 
 struct BookCopy {
     QString copyId;           // 副本唯一标识 (格式: indexId_copyNumber)
@@ -32,9 +33,9 @@ inline QJsonObject BookCopy::toJson() const {
 inline BookCopy BookCopy::fromJson(const QJsonObject &obj) {
     BookCopy copy;
     copy.copyId = obj.value("copyId").toString();
-    copy.indexId = obj.value("indexId").toString();
+    copy.indexId = StringPool::instance().intern(obj.value("indexId").toString());
     copy.copyNumber = obj.value("copyNumber").toInt();
-    copy.borrowedBy = obj.value("borrowedBy").toString();
+    copy.borrowedBy = StringPool::instance().intern(obj.value("borrowedBy").toString());
     copy.borrowDate = obj.value("borrowDate").toString().isEmpty() ?
                       QDate() : QDate::fromString(obj.value("borrowDate").toString(), Qt::ISODate);
     copy.dueDate = obj.value("dueDate").toString().isEmpty() ?
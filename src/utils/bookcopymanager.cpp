@@ -1,8 +1,18 @@
 // bookcopymanager.cpp
 #include "bookcopymanager.h"
+#include "stringpool.h"
+#include "parallelscan.h"
 #include <QDebug>
 #include <QDir>
 #include <QCoreApplication>
+#include <QSaveFile>
+#include <QTimer>
+#include <algorithm>
+
+namespace {
+// 组提交窗口：窗口内的多次借还合并成一次写入和一次刷盘
+const int kGroupCommitIntervalMs = 20;
+}
 
 BookCopyManager& BookCopyManager::instance()
 {
@@ -11,14 +21,42 @@ BookCopyManager& BookCopyManager::instance()
 }
 
 BookCopyManager::BookCopyManager(QObject *parent)
-    : QObject(parent), isInitialized_(false)
+    : QObject(parent)
+    , tombstoneCount_(0)
+    , commitTimer_(new QTimer(this))
+    , compactionRunning_(false)
+    , compactMaxRecords_(5000)
+    , compactMaxBytes_(2 * 1024 * 1024)
+    , isInitialized_(false)
+    , unsavedChanges_(false)
 {
+    compactionPool_.setMaxThreadCount(1);
+
+    commitTimer_->setSingleShot(true);
+    commitTimer_->setInterval(kGroupCommitIntervalMs);
+    connect(commitTimer_, &QTimer::timeout, this, &BookCopyManager::commitJournal);
+
+    // 退出事件循环时收尾；单例析构发生在静态对象销毁阶段，那时不再做文件I/O
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                this, &BookCopyManager::shutdown);
+    }
+
     initializeDatabase();
 }
 
 BookCopyManager::~BookCopyManager()
 {
-    saveToFile();
+}
+
+void BookCopyManager::shutdown()
+{
+    // 提交组提交缓存；日志为空说明快照已是最新，不必重写整个book_copies.json
+    flush();
+    compactionPool_.waitForDone();
+    if (unsavedChanges_ || journal_.recordCount() > 0 || journal_.hasRotated()) {
+        checkpoint();
+    }
 }
 
 bool BookCopyManager::initializeDatabase()
@@ -41,18 +79,20 @@ bool BookCopyManager::initializeDatabase()
     }
 
     dbFilePath_ = absoluteTargetPath + "/book_copies.json";
+    journal_.setFilePath(absoluteTargetPath + "/book_copies.journal");
     qDebug() << "Book copies database file path:" << dbFilePath_;
 
-    if (QFile::exists(dbFilePath_)) {
+    if (QFile::exists(dbFilePath_) || QFile::exists(journal_.filePath()) || journal_.hasRotated()) {
         if (loadFromFile()) {
-            qDebug() << "Book copies database loaded successfully with" << copies_.size() << "copies";
+            qDebug() << "Book copies database loaded successfully with" << slotById_.size() << "copies";
+            journal_.open();
             isInitialized_ = true;
             return true;
         }
     }
 
-    copies_.clear();
-    if (saveToFile()) {
+    clearCopies();
+    if (checkpoint()) {
         qDebug() << "New book copies database created successfully";
         isInitialized_ = true;
         return true;
@@ -74,222 +114,536 @@ QString BookCopyManager::getDatabasePath() const
 
 bool BookCopyManager::loadFromFile()
 {
-    QFile file(dbFilePath_);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qDebug() << "Cannot open book copies database file for reading:" << file.errorString();
-        return false;
-    }
+    clearCopies();
 
-    QByteArray data = file.readAll();
-    file.close();
+    // 1. 加载快照
+    if (QFile::exists(dbFilePath_)) {
+        QFile file(dbFilePath_);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qDebug() << "Cannot open book copies database file for reading:" << file.errorString();
+            return false;
+        }
 
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (!doc.isArray()) {
-        qDebug() << "Invalid book copies database format: expected JSON array";
-        return false;
-    }
+        QByteArray data = file.readAll();
+        file.close();
 
-    copies_.clear();
-    QJsonArray jsonArray = doc.array();
-    for (const QJsonValue &value : jsonArray) {
-        if (value.isObject()) {
-            copies_.append(BookCopy::fromJson(value.toObject()));
+        QJsonDocument doc = QJsonDocument::fromJson(data);
+        if (!doc.isArray()) {
+            qDebug() << "Invalid book copies database format: expected JSON array";
+            return false;
+        }
+
+        QJsonArray jsonArray = doc.array();
+        for (const QJsonValue &value : jsonArray) {
+            if (value.isObject()) {
+                BookCopy copy = BookCopy::fromJson(value.toObject());
+                if (!copy.copyId.isEmpty() && !slotById_.contains(copy.copyId)) {
+                    insertCopy(copy);
+                }
+            }
         }
     }
 
-    qDebug() << "Loaded" << copies_.size() << "book copies from database";
+    // 2. 重放快照之后的变更（包括上次未完成压缩留下的 .old 日志）
+    int replayed = journal_.replay([this](const QJsonObject &record) {
+        applyJournalRecord(record);
+    });
+    if (replayed < 0) {
+        return false;
+    }
+
+    qDebug() << "Loaded" << slotById_.size() << "book copies from database," << replayed << "journal records replayed";
     return true;
 }
 
 bool BookCopyManager::saveToFile()
 {
-    QFile file(dbFilePath_);
+    return writeSnapshot(dbFilePath_, copies_);
+}
+
+bool BookCopyManager::writeSnapshot(const QString &filePath, const QVector<BookCopy> &copies)
+{
+    // 可能在后台线程执行，只能访问参数，不能访问成员
+    QSaveFile file(filePath);
     if (!file.open(QIODevice::WriteOnly)) {
         qDebug() << "Cannot open book copies database file for writing:" << file.errorString();
         return false;
     }
 
     QJsonArray jsonArray;
-    for (const BookCopy &copy : copies_) {
-        jsonArray.append(copy.toJson());
+    for (const BookCopy &copy : copies) {
+        if (!copy.copyId.isEmpty()) {
+            jsonArray.append(copy.toJson());
+        }
     }
 
     QJsonDocument doc(jsonArray);
-    file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
+    file.write(doc.toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qDebug() << "Failed to commit book copies database file:" << file.errorString();
+        return false;
+    }
 
-    qDebug() << "Saved" << copies_.size() << "book copies to database";
+    qDebug() << "Saved" << jsonArray.size() << "book copies to database";
     return true;
 }
 
-bool BookCopyManager::addCopy(const BookCopy &copy)
+bool BookCopyManager::flush()
 {
-    for (const BookCopy &existingCopy : copies_) {
-        if (existingCopy.copyId == copy.copyId) {
-            qDebug() << "Book copy with ID" << copy.copyId << "already exists";
-            return false;
+    commitTimer_->stop();
+    const bool ok = journal_.commit();
+    unsavedChanges_ = !ok;
+    return ok;
+}
+
+bool BookCopyManager::hasUnsavedChanges() const
+{
+    return unsavedChanges_ || journal_.pendingCount() > 0;
+}
+
+bool BookCopyManager::checkpoint()
+{
+    commitTimer_->stop();
+
+    // 等待后台压缩结束，避免它用较旧的数据覆盖本次快照
+    compactionPool_.waitForDone();
+
+    if (!saveToFile()) {
+        unsavedChanges_ = !journal_.commit();
+        return false;
+    }
+    unsavedChanges_ = !journal_.reset();
+    return !unsavedChanges_;
+}
+
+void BookCopyManager::setCompactionThresholds(int maxRecords, qint64 maxBytes)
+{
+    compactMaxRecords_ = maxRecords;
+    compactMaxBytes_ = maxBytes;
+}
+
+void BookCopyManager::commitJournal()
+{
+    if (!journal_.commit()) {
+        // 日志写不进去时退回到同步写完整快照，保证数据不丢；快照也写不进去时记下有未保存的修改，
+        // 缓存的记录保留在日志中，下次提交或检查点时再试
+        qWarning() << "Book copies journal commit failed, falling back to checkpoint";
+        if (!checkpoint()) {
+            qWarning() << "Book copies checkpoint failed; changes are only in memory";
         }
+        return;
     }
+    unsavedChanges_ = false;
 
-    copies_.append(copy);
-    return saveToFile();
+    if (journal_.recordCount() >= compactMaxRecords_ ||
+        journal_.sizeInBytes() >= compactMaxBytes_) {
+        startCompaction();
+    }
 }
 
-bool BookCopyManager::removeCopy(const QString &copyId)
+bool BookCopyManager::startCompaction()
+{
+    if (compactionRunning_) {
+        return false;
+    }
+
+    // 上次压缩没有删掉 .old（快照写入失败），直接做一次同步检查点
+    if (journal_.hasRotated()) {
+        return checkpoint();
+    }
+
+    // 轮转后新记录写入新日志；快照内容即轮转时刻的内存状态
+    if (!journal_.rotate()) {
+        return false;
+    }
+
+    compactionRunning_ = true;
+    const QVector<BookCopy> snapshot = copies_;   // 隐式共享，这里不会复制数据
+    const QString filePath = dbFilePath_;
+    const QString rotatedPath = journal_.rotatedFilePath();
+
+    compactionPool_.start([this, snapshot, filePath, rotatedPath]() {
+        if (writeSnapshot(filePath, snapshot)) {
+            QFile::remove(rotatedPath);
+        }
+        compactionRunning_ = false;
+    });
+    return true;
+}
+
+void BookCopyManager::applyJournalRecord(const QJsonObject &record)
 {
-    for (int i = 0; i < copies_.size(); ++i) {
-        if (copies_[i].copyId == copyId) {
-            copies_.removeAt(i);
-            return saveToFile();
+    const QString op = record.value("op").toString();
+
+    if (op == "put") {
+        BookCopy copy = BookCopy::fromJson(record.value("copy").toObject());
+        const int slot = slotById_.value(copy.copyId, -1);
+        if (slot >= 0) {
+            replaceSlot(slot, copy);
+        } else if (!copy.copyId.isEmpty()) {
+            insertCopy(copy);
+        }
+    } else if (op == "del") {
+        const int slot = slotById_.value(record.value("copyId").toString(), -1);
+        if (slot >= 0) {
+            eraseSlot(slot);
         }
+    } else {
+        qDebug() << "Unknown book copies journal operation:" << op;
     }
+}
 
-    qDebug() << "Book copy with ID" << copyId << "not found for removal";
-    return false;
+void BookCopyManager::queueMutation(const QJsonObject &record)
+{
+    journal_.enqueue(record);
+    if (!commitTimer_->isActive()) {
+        commitTimer_->start();
+    }
 }
 
-bool BookCopyManager::updateCopy(const BookCopy &copy)
+void BookCopyManager::queuePut(const BookCopy &copy)
+{
+    QJsonObject record;
+    record["op"] = "put";
+    record["copy"] = copy.toJson();
+    queueMutation(record);
+}
+
+void BookCopyManager::clearCopies()
+{
+    copies_.clear();
+    slotById_.clear();
+    slotsByIndexId_.clear();
+    availableByIndexId_.clear();
+    slotsByBorrower_.clear();
+    tombstoneCount_ = 0;
+}
+
+int BookCopyManager::insertCopy(const BookCopy &copy)
+{
+    const int slot = copies_.size();
+    copies_.append(internedCopy(copy));
+    indexSlot(slot);
+    emit copyCountsChanged(copy.indexId, 1, copy.isAvailable() ? 1 : 0);
+    emit copyChanged(copy.indexId);
+    return slot;
+}
+
+void BookCopyManager::replaceSlot(int slot, const BookCopy &copy)
+{
+    const QString oldIndexId = copies_[slot].indexId;
+    const bool wasAvailable = copies_[slot].isAvailable();
+
+    unindexSlot(slot);
+    copies_[slot] = internedCopy(copy);
+    indexSlot(slot);
+
+    if (oldIndexId != copy.indexId) {
+        emit copyCountsChanged(oldIndexId, -1, wasAvailable ? -1 : 0);
+        emit copyCountsChanged(copy.indexId, 1, copy.isAvailable() ? 1 : 0);
+    } else if (wasAvailable != copy.isAvailable()) {
+        emit copyCountsChanged(copy.indexId, 0, copy.isAvailable() ? 1 : -1);
+    }
+
+    if (oldIndexId != copy.indexId) {
+        emit copyChanged(oldIndexId);
+    }
+    emit copyChanged(copy.indexId);
+}
+
+BookCopy BookCopyManager::internedCopy(const BookCopy &copy)
+{
+    // 索引号与图书共享，借阅者在同一用户的所有副本间共享
+    StringPool &pool = StringPool::instance();
+    BookCopy result = copy;
+    result.indexId = pool.intern(copy.indexId);
+    result.borrowedBy = pool.intern(copy.borrowedBy);
+    return result;
+}
+
+void BookCopyManager::eraseSlot(int slot)
+{
+    const QString indexId = copies_[slot].indexId;
+    const bool wasAvailable = copies_[slot].isAvailable();
+
+    // 留下墓碑而不是removeAt，其他槽位号保持不变，索引无需整体重建
+    unindexSlot(slot);
+    copies_[slot] = BookCopy();
+    ++tombstoneCount_;
+
+    emit copyCountsChanged(indexId, -1, wasAvailable ? -1 : 0);
+    emit copyChanged(indexId);
+}
+
+void BookCopyManager::indexSlot(int slot)
 {
-    for (int i = 0; i < copies_.size(); ++i) {
-        if (copies_[i].copyId == copy.copyId) {
-            copies_[i] = copy;
-            return saveToFile();
+    const BookCopy &copy = copies_[slot];
+    slotById_.insert(copy.copyId, slot);
+
+    // 按副本编号有序插入，编号相同时排在已有副本之后
+    QVector<int> &slotList = slotsByIndexId_[copy.indexId];
+    auto pos = std::upper_bound(slotList.begin(), slotList.end(), copy.copyNumber,
+                                [this](int number, int other) {
+                                    return number < copies_[other].copyNumber;
+                                });
+    slotList.insert(pos, slot);
+
+    int &available = availableByIndexId_[copy.indexId];
+    if (copy.isAvailable()) {
+        ++available;
+    } else {
+        slotsByBorrower_[copy.borrowedBy].append(slot);
+    }
+}
+
+void BookCopyManager::unindexSlot(int slot)
+{
+    const BookCopy &copy = copies_[slot];
+    slotById_.remove(copy.copyId);
+
+    auto slotsIt = slotsByIndexId_.find(copy.indexId);
+    if (slotsIt != slotsByIndexId_.end()) {
+        slotsIt->removeOne(slot);
+        if (slotsIt->isEmpty()) {
+            slotsByIndexId_.erase(slotsIt);
+            availableByIndexId_.remove(copy.indexId);
         }
     }
 
-    qDebug() << "Book copy with ID" << copy.copyId << "not found for update";
-    return false;
+    if (copy.isAvailable()) {
+        auto availableIt = availableByIndexId_.find(copy.indexId);
+        if (availableIt != availableByIndexId_.end()) {
+            --availableIt.value();
+        }
+    } else {
+        auto borrowerIt = slotsByBorrower_.find(copy.borrowedBy);
+        if (borrowerIt != slotsByBorrower_.end()) {
+            borrowerIt->removeOne(slot);
+            if (borrowerIt->isEmpty()) {
+                slotsByBorrower_.erase(borrowerIt);
+            }
+        }
+    }
 }
 
-QVector<BookCopy> BookCopyManager::getAllCopies() const
+bool BookCopyManager::addCopy(const BookCopy &copy)
 {
-    return copies_;
+    if (copy.copyId.isEmpty()) {
+        qDebug() << "Cannot add book copy with empty ID";
+        return false;
+    }
+
+    if (slotById_.contains(copy.copyId)) {
+        qDebug() << "Book copy with ID" << copy.copyId << "already exists";
+        return false;
+    }
+
+    insertCopy(copy);
+    queuePut(copy);
+    return true;
 }
 
-QVector<BookCopy> BookCopyManager::getCopiesByIndexId(const QString &indexId) const
+int BookCopyManager::addCopies(const QVector<BookCopy> &copies, bool saveNow)
+{
+    int addedCount = 0;
+    for (const BookCopy &copy : copies) {
+        if (copy.copyId.isEmpty() || slotById_.contains(copy.copyId)) {
+            continue;
+        }
+        insertCopy(copy);
+        ++addedCount;
+    }
+
+    if (saveNow && addedCount > 0 && !checkpoint()) {
+        return -1;
+    }
+    return addedCount;
+}
+
+bool BookCopyManager::removeCopy(const QString &copyId)
+{
+    const int slot = slotById_.value(copyId, -1);
+    if (slot < 0) {
+        qDebug() << "Book copy with ID" << copyId << "not found for removal";
+        return false;
+    }
+
+    eraseSlot(slot);
+
+    QJsonObject record;
+    record["op"] = "del";
+    record["copyId"] = copyId;
+    queueMutation(record);
+    return true;
+}
+
+bool BookCopyManager::updateCopy(const BookCopy &copy)
 {
+    const int slot = slotById_.value(copy.copyId, -1);
+    if (slot < 0) {
+        qDebug() << "Book copy with ID" << copy.copyId << "not found for update";
+        return false;
+    }
+
+    replaceSlot(slot, copy);
+    queuePut(copy);
+    return true;
+}
+
+QVector<BookCopy> BookCopyManager::getAllCopies() const
+{
+    if (tombstoneCount_ == 0) {
+        return copies_;
+    }
+
     QVector<BookCopy> result;
+    result.reserve(slotById_.size());
     for (const BookCopy &copy : copies_) {
-        if (copy.indexId == indexId) {
+        if (!copy.copyId.isEmpty()) {
             result.append(copy);
         }
     }
     return result;
 }
 
-BookCopy BookCopyManager::getCopyById(const QString &copyId) const
+QVector<BookCopy> BookCopyManager::getCopiesByIndexId(const QString &indexId) const
 {
-    for (const BookCopy &copy : copies_) {
-        if (copy.copyId == copyId) {
-            return copy;
-        }
+    QVector<BookCopy> result;
+    const QVector<int> slotList = slotsByIndexId_.value(indexId);
+    result.reserve(slotList.size());
+    for (int slot : slotList) {
+        result.append(copies_[slot]);
     }
-    return BookCopy();
+    return result;
+}
+
+BookCopy BookCopyManager::getCopyById(const QString &copyId) const
+{
+    const int slot = slotById_.value(copyId, -1);
+    return slot >= 0 ? copies_[slot] : BookCopy();
 }
 
 QVector<BookCopy> BookCopyManager::getAvailableCopies(const QString &indexId) const
 {
+    // 索引中的副本已按编号排好序，直接过滤即可
     QVector<BookCopy> result;
-    QVector<BookCopy> allCopies = getCopiesByIndexId(indexId);
-
-    std::sort(allCopies.begin(), allCopies.end(), [](const BookCopy &a, const BookCopy &b) {
-        return a.copyNumber < b.copyNumber;
-    });
-
-    for (const BookCopy &copy : allCopies) {
-        if (copy.isAvailable()) {
-            result.append(copy);
+    const QVector<int> slotList = slotsByIndexId_.value(indexId);
+    for (int slot : slotList) {
+        if (copies_[slot].isAvailable()) {
+            result.append(copies_[slot]);
         }
     }
-
     return result;
 }
 
 BookCopy BookCopyManager::getFirstAvailableCopy(const QString &indexId) const
 {
-    QVector<BookCopy> availableCopies = getAvailableCopies(indexId);
-    return availableCopies.isEmpty() ? BookCopy() : availableCopies.first();
+    if (getAvailableCopyCount(indexId) == 0) {
+        return BookCopy();
+    }
+
+    const QVector<int> slotList = slotsByIndexId_.value(indexId);
+    for (int slot : slotList) {
+        if (copies_[slot].isAvailable()) {
+            return copies_[slot];
+        }
+    }
+    return BookCopy();
 }
 
 bool BookCopyManager::borrowCopy(const QString &copyId, const QString &username, const QDate &dueDate)
 {
-    for (int i = 0; i < copies_.size(); ++i) {
-        if (copies_[i].copyId == copyId && copies_[i].isAvailable()) {
-            copies_[i].borrowedBy = username;
-            copies_[i].borrowDate = QDate::currentDate();
-            copies_[i].dueDate = dueDate;
-            return saveToFile();
-        }
+    const int slot = slotById_.value(copyId, -1);
+    if (slot < 0 || !copies_[slot].isAvailable()) {
+        return false;
     }
-    return false;
+
+    BookCopy copy = copies_[slot];
+    copy.borrowedBy = username;
+    copy.borrowDate = QDate::currentDate();
+    copy.dueDate = dueDate;
+    replaceSlot(slot, copy);
+    queuePut(copy);
+    return true;
 }
 
 bool BookCopyManager::returnCopy(const QString &copyId)
 {
-    for (int i = 0; i < copies_.size(); ++i) {
-        if (copies_[i].copyId == copyId) {
-            copies_[i].borrowedBy = QString();
-            copies_[i].borrowDate = QDate();
-            copies_[i].dueDate = QDate();
-            return saveToFile();
-        }
+    const int slot = slotById_.value(copyId, -1);
+    if (slot < 0) {
+        return false;
     }
-    return false;
+
+    BookCopy copy = copies_[slot];
+    copy.borrowedBy = QString();
+    copy.borrowDate = QDate();
+    copy.dueDate = QDate();
+    replaceSlot(slot, copy);
+    queuePut(copy);
+    return true;
 }
 
 bool BookCopyManager::renewCopy(const QString &copyId, int extendDays)
 {
-    for (int i = 0; i < copies_.size(); ++i) {
-        if (copies_[i].copyId == copyId) {
-            // 检查副本是否被借阅
-            if (copies_[i].borrowedBy.isEmpty()) {
-                return false;  // 副本未被借阅，无法续借
-            }
-
-            // 延长归还日期
-            QDate newDueDate = copies_[i].dueDate.isValid() ?
-                              copies_[i].dueDate.addDays(extendDays) :
-                              QDate::currentDate().addDays(extendDays);
+    const int slot = slotById_.value(copyId, -1);
+    if (slot < 0) {
+        return false;
+    }
 
-            copies_[i].dueDate = newDueDate;
-            return saveToFile();
-        }
+    // 检查副本是否被借阅
+    BookCopy &copy = copies_[slot];
+    if (copy.borrowedBy.isEmpty()) {
+        return false;  // 副本未被借阅，无法续借
     }
-    return false;
+
+    // 延长归还日期（借阅者和可借状态都不变，索引无需调整）
+    copy.dueDate = copy.dueDate.isValid() ?
+                   copy.dueDate.addDays(extendDays) :
+                   QDate::currentDate().addDays(extendDays);
+    emit copyChanged(copy.indexId);
+    queuePut(copy);
+    return true;
 }
 
 QVector<BookCopy> BookCopyManager::getBorrowedCopies(const QString &username) const
 {
     QVector<BookCopy> result;
-    for (const BookCopy &copy : copies_) {
-        if (copy.borrowedBy == username) {
-            result.append(copy);
-        }
+    const QVector<int> slotList = slotsByBorrower_.value(username);
+    result.reserve(slotList.size());
+    for (int slot : slotList) {
+        result.append(copies_[slot]);
     }
     return result;
 }
 
 QVector<BookCopy> BookCopyManager::getDueSoonCopies(int days) const
 {
-    QVector<BookCopy> result;
-    QDate futureDate = QDate::currentDate().addDays(days);
+    // 分块并行扫描副本槽位，只有借出中的副本才有归还日期；结果按槽位顺序，与哈希表遍历顺序无关
+    const QDate futureDate = QDate::currentDate().addDays(days);
+    const BookCopy *copies = copies_.constData();
 
-    for (const BookCopy &copy : copies_) {
-        if (!copy.isAvailable() && copy.dueDate.isValid() && copy.dueDate <= futureDate) {
-            result.append(copy);
-        }
+    const QVector<int> slotList = ParallelScan::instance().filter(copies_.size(), [&](int slot) {
+        const BookCopy &copy = copies[slot];
+        return !copy.isAvailable() && copy.dueDate.isValid() && copy.dueDate <= futureDate;
+    });
+
+    QVector<BookCopy> result;
+    result.reserve(slotList.size());
+    for (int slot : slotList) {
+        result.append(copies_[slot]);
     }
     return result;
 }
 
 int BookCopyManager::getTotalCopyCount(const QString &indexId) const
 {
-    return getCopiesByIndexId(indexId).size();
+    auto it = slotsByIndexId_.constFind(indexId);
+    return it != slotsByIndexId_.constEnd() ? it->size() : 0;
 }
 
 int BookCopyManager::getAvailableCopyCount(const QString &indexId) const
 {
-    return getAvailableCopies(indexId).size();
+    return availableByIndexId_.value(indexId, 0);
 }
 
 int BookCopyManager::getBorrowedCopyCount(const QString &indexId) const
@@ -299,17 +653,10 @@ int BookCopyManager::getBorrowedCopyCount(const QString &indexId) const
 
 int BookCopyManager::getNextCopyNumber(const QString &indexId) const
 {
-    QVector<BookCopy> copies = getCopiesByIndexId(indexId);
-    if (copies.isEmpty()) {
+    // 索引按编号升序，最后一个就是最大编号
+    auto it = slotsByIndexId_.constFind(indexId);
+    if (it == slotsByIndexId_.constEnd() || it->isEmpty()) {
         return 1;
     }
-
-    int maxNumber = 0;
-    for (const BookCopy &copy : copies) {
-        if (copy.copyNumber > maxNumber) {
-            maxNumber = copy.copyNumber;
-        }
-    }
-
-    return maxNumber + 1;
+    return copies_[it->last()].copyNumber + 1;
 }
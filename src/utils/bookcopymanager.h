@@ -4,12 +4,18 @@
 
 #include <QObject>
 #include <QVector>
+#include <QHash>
 #include <QString>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QFile>
+#include <QThreadPool>
+#include <atomic>
 #include "bookcopy.h"
+#include "journal.h"
+
+class QTimer;
 
 class BookCopyManager : public QObject
 {
@@ -24,7 +30,14 @@ public:
     QString getDatabasePath() const;
 
     // 副本操作
+    // 单条修改返回true表示内存已更新、日志记录已排入组提交缓存，约20ms内由定时器写盘；
+    // 写盘失败会退回写完整快照，仍失败时记录日志并由hasUnsavedChanges()报告。
+    // 需要确认已写盘时调用flush()
     bool addCopy(const BookCopy &copy);
+    // 批量添加（用于导入）：跳过已存在的副本号，全部插入后只写一次检查点，不逐条记日志
+    // 返回新增的副本数，写检查点失败返回-1
+    // 分批导入时除最后一批外saveNow传false，只插入内存，由最后一次调用（或checkpoint()）统一保存
+    int addCopies(const QVector<BookCopy> &copies, bool saveNow = true);
     bool removeCopy(const QString &copyId);
     bool updateCopy(const BookCopy &copy);
     QVector<BookCopy> getAllCopies() const;
@@ -50,6 +63,28 @@ public:
     // 获取下一个编号
     int getNextCopyNumber(const QString &indexId) const;
 
+    // 立即提交组提交缓存中的日志记录，返回是否已写盘
+    bool flush();
+    // 是否有尚未写盘的修改（缓存中等待组提交，或上次提交失败）
+    bool hasUnsavedChanges() const;
+    // 同步检查点：写完整快照并清空日志（会等待进行中的后台压缩）
+    bool checkpoint();
+    // 日志累计记录数或字节数超过阈值时在后台压缩
+    void setCompactionThresholds(int maxRecords, qint64 maxBytes);
+
+public slots:
+    // 程序退出前（QCoreApplication::aboutToQuit）调用：提交缓存的日志，日志非空时写检查点
+    void shutdown();
+
+signals:
+    // 某本书的副本总数/可借数发生变化（增量），供上层维护统计计数
+    void copyCountsChanged(const QString &indexId, int totalDelta, int availableDelta);
+    // 某本书的任一副本被增删或修改（包括续借），供界面刷新对应的行
+    void copyChanged(const QString &indexId);
+
+private slots:
+    void commitJournal();
+
 private:
     explicit BookCopyManager(QObject *parent = nullptr);
     ~BookCopyManager();
@@ -58,10 +93,36 @@ private:
 
     bool loadFromFile();
     bool saveToFile();
-
+    void applyJournalRecord(const QJsonObject &record);
+    void clearCopies();
+    int insertCopy(const BookCopy &copy);
+    void replaceSlot(int slot, const BookCopy &copy);
+    static BookCopy internedCopy(const BookCopy &copy);
+    void eraseSlot(int slot);
+    void indexSlot(int slot);
+    void unindexSlot(int slot);
+    // 排入组提交缓存，不等待写盘；写盘结果见commitJournal()
+    void queueMutation(const QJsonObject &record);
+    void queuePut(const BookCopy &copy);
+    bool startCompaction();
+    static bool writeSnapshot(const QString &filePath, const QVector<BookCopy> &copies);
+
+    // 副本槽位，已删除的槽位为墓碑（copyId为空）；下面的二级索引都保存槽位号，借还时增量维护
     QVector<BookCopy> copies_;
+    QHash<QString, int> slotById_;                  // copyId -> 槽位
+    QHash<QString, QVector<int>> slotsByIndexId_;   // indexId -> 槽位，按副本编号升序
+    QHash<QString, int> availableByIndexId_;        // indexId -> 可借副本数
+    QHash<QString, QVector<int>> slotsByBorrower_;  // 借阅者 -> 借出的槽位
+    int tombstoneCount_;
     QString dbFilePath_;
+    Journal journal_;                          // 副本变更日志，借还只追加一条记录
+    QTimer *commitTimer_;                      // 组提交定时器，合并短时间内的多次写入
+    QThreadPool compactionPool_;               // 后台压缩线程（单线程）
+    std::atomic<bool> compactionRunning_;
+    int compactMaxRecords_;
+    qint64 compactMaxBytes_;
     bool isInitialized_;
+    bool unsavedChanges_;                      // 日志提交和检查点都失败过，内存中有未写盘的修改
 };
 
 #endif // BOOKCOPYMANAGER_H
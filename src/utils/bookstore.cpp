@@ -0,0 +1,122 @@
+// bookstore.cpp
+#include "bookstore.h"
+#include "parallelscan.h"
+#include <algorithm>
+
+void BookStore::clear()
+{
+    books_.clear();
+    price_.clear();
+    borrowCount_.clear();
+    inDay_.clear();
+    categoryId_.clear();
+    locationId_.clear();
+    live_.clear();
+}
+
+void BookStore::reserve(int count)
+{
+    books_.reserve(count);
+    price_.reserve(count);
+    borrowCount_.reserve(count);
+    inDay_.reserve(count);
+    categoryId_.reserve(count);
+    locationId_.reserve(count);
+    live_.reserve(count);
+}
+
+int BookStore::append(const Book &book, int categoryId, int locationId)
+{
+    const int slot = books_.size();
+    books_.append(book);
+    price_.append(book.price);
+    borrowCount_.append(book.borrowCount);
+    inDay_.append(book.inDate.toJulianDay());
+    categoryId_.append(categoryId);
+    locationId_.append(locationId);
+    live_.append(1);
+    return slot;
+}
+
+void BookStore::replace(int slot, const Book &book, int categoryId, int locationId)
+{
+    books_[slot] = book;
+    price_[slot] = book.price;
+    borrowCount_[slot] = book.borrowCount;
+    inDay_[slot] = book.inDate.toJulianDay();
+    categoryId_[slot] = categoryId;
+    locationId_[slot] = locationId;
+    live_[slot] = 1;
+}
+
+void BookStore::erase(int slot)
+{
+    // 数值列清零，聚合时无需再判断墓碑
+    books_[slot] = Book();
+    price_[slot] = 0.0;
+    borrowCount_[slot] = 0;
+    inDay_[slot] = 0;
+    categoryId_[slot] = 0;
+    locationId_[slot] = 0;
+    live_[slot] = 0;
+}
+
+double BookStore::totalPrice() const
+{
+    const double *price = price_.constData();
+    const int n = price_.size();
+    double total = 0.0;
+    for (int i = 0; i < n; ++i) {
+        total += price[i];
+    }
+    return total;
+}
+
+QVector<int> BookStore::slotsMatching(const QVector<qint32> &column, int value) const
+{
+    const qint32 *values = column.constData();
+    const quint8 *live = live_.constData();
+    const int n = column.size();
+
+    return ParallelScan::instance().filter(n, [values, live, value](int i) {
+        return values[i] == value && live[i];
+    });
+}
+
+QVector<int> BookStore::slotsWithCategory(int categoryId) const
+{
+    return slotsMatching(categoryId_, categoryId);
+}
+
+QVector<int> BookStore::slotsWithLocation(int locationId) const
+{
+    return slotsMatching(locationId_, locationId);
+}
+
+QVector<int> BookStore::countByLocation() const
+{
+    return countByValue(locationId_);
+}
+
+QVector<int> BookStore::countByCategory() const
+{
+    return countByValue(categoryId_);
+}
+
+QVector<int> BookStore::countByValue(const QVector<qint32> &column) const
+{
+    const qint32 *ids = column.constData();
+    const quint8 *live = live_.constData();
+    const int n = column.size();
+
+    int maxId = 0;
+    for (int i = 0; i < n; ++i) {
+        maxId = std::max(maxId, int(ids[i]));
+    }
+
+    QVector<int> counts(maxId + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        counts[ids[i]] += live[i];
+    }
+    return counts;
+}
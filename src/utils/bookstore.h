@@ -0,0 +1,58 @@
+// bookstore.h
+#ifndef BOOKSTORE_H
+#define BOOKSTORE_H
+
+#include <QVector>
+#include <QString>
+#include "book.h"
+
+// 图书槽位存储（列式热数据 + 行式冷数据）
+// 完整的Book（十个QString和简介）按槽位存成一行，供界面显示和编辑读取；
+// 筛选、排序、统计常用的数值列（价格、借阅次数、入库日期、类别/馆藏地址驻留编号）
+// 另外按列连续存放，聚合和筛选只扫描需要的那一两列，循环简单、可被编译器向量化。
+// 删除的槽位留下墓碑：Book的indexId为空，数值列清零，live列为0。
+class BookStore
+{
+public:
+    void clear();
+    void reserve(int count);
+
+    // 追加一本书，返回槽位号；类别/馆藏地址编号由调用方通过StringPool分配
+    int append(const Book &book, int categoryId, int locationId);
+    void replace(int slot, const Book &book, int categoryId, int locationId);
+    void erase(int slot);
+
+    int size() const { return books_.size(); }
+    bool isLive(int slot) const { return slot >= 0 && slot < live_.size() && live_[slot]; }
+    const Book* bookAt(int slot) const { return isLive(slot) ? &books_[slot] : nullptr; }
+    const QVector<Book>& books() const { return books_; }
+
+    // 热数据列，下标即槽位号
+    double priceAt(int slot) const { return price_[slot]; }
+    int borrowCountAt(int slot) const { return borrowCount_[slot]; }
+    qint64 inDayAt(int slot) const { return inDay_[slot]; }
+    int categoryIdAt(int slot) const { return categoryId_[slot]; }
+    int locationIdAt(int slot) const { return locationId_[slot]; }
+
+    // 聚合与筛选
+    double totalPrice() const;
+    QVector<int> slotsWithCategory(int categoryId) const;
+    QVector<int> slotsWithLocation(int locationId) const;
+    // 按驻留编号统计每个馆藏地址/类别的图书数，下标为编号
+    QVector<int> countByLocation() const;
+    QVector<int> countByCategory() const;
+
+private:
+    QVector<int> slotsMatching(const QVector<qint32> &column, int value) const;
+    QVector<int> countByValue(const QVector<qint32> &column) const;
+
+    QVector<Book> books_;          // 冷数据：完整图书记录
+    QVector<double> price_;        // 热数据列
+    QVector<qint32> borrowCount_;
+    QVector<qint64> inDay_;        // 入库日期的儒略日
+    QVector<qint32> categoryId_;
+    QVector<qint32> locationId_;
+    QVector<quint8> live_;         // 1表示有效，0表示墓碑
+};
+
+#endif // BOOKSTORE_H
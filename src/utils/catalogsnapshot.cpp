@@ -0,0 +1,267 @@
+// catalogsnapshot.cpp
+#include "catalogsnapshot.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QHash>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+
+const char kMagic[8] = { 'L', 'I', 'B', 'C', 'A', 'T', 'S', 'N' };
+
+// 头部：magic(8) + 4个quint32 + 7个quint64
+struct Header {
+    quint32 version;
+    quint32 bookCount;
+    quint32 stringCount;
+    quint32 reserved;
+    quint64 priceOffset;
+    quint64 dateOffset;
+    quint64 borrowOffset;
+    quint64 textOffset;
+    quint64 stringIndexOffset;
+    quint64 poolOffset;
+    quint64 fileSize;
+};
+
+const int kHeaderSize = 8 + 4 * 4 + 7 * 8;
+
+qint64 alignTo8(qint64 n)
+{
+    return (n + 7) & ~qint64(7);
+}
+
+template <typename T>
+void putLE(QByteArray &out, qint64 offset, T value)
+{
+    qToLittleEndian<T>(value, out.data() + offset);
+}
+
+template <typename T>
+T getLE(const uchar *base, quint64 offset)
+{
+    return qFromLittleEndian<T>(base + offset);
+}
+
+} // namespace
+
+bool CatalogSnapshot::write(const QString &filePath, const QVector<Book> &books)
+{
+    // 1. 收集图书并为文本分配字符串编号，相同文本共用一个编号
+    QVector<const Book *> live;
+    live.reserve(books.size());
+    for (const Book &book : books) {
+        if (!book.indexId.isEmpty()) {
+            live.append(&book);
+        }
+    }
+    const qint64 n = live.size();
+
+    QHash<QString, quint32> stringIds;
+    QVector<const QString *> strings;
+    QVector<quint32> textIds(n * TextColumnCount);
+    qint64 poolChars = 0;
+
+    for (qint64 i = 0; i < n; ++i) {
+        const Book &book = *live[i];
+        const QString *fields[TextColumnCount] = {
+            &book.indexId, &book.name, &book.author, &book.publisher,
+            &book.location, &book.category, &book.description
+        };
+        for (int c = 0; c < TextColumnCount; ++c) {
+            auto it = stringIds.constFind(*fields[c]);
+            quint32 id;
+            if (it == stringIds.constEnd()) {
+                id = quint32(strings.size());
+                stringIds.insert(*fields[c], id);
+                strings.append(fields[c]);
+                poolChars += fields[c]->size();
+            } else {
+                id = it.value();
+            }
+            textIds[c * n + i] = id;
+        }
+    }
+    const qint64 stringCount = strings.size();
+
+    // 2. 计算各段偏移
+    Header h;
+    h.version = kVersion;
+    h.bookCount = quint32(n);
+    h.stringCount = quint32(stringCount);
+    h.reserved = 0;
+    h.priceOffset = alignTo8(kHeaderSize);
+    h.dateOffset = alignTo8(h.priceOffset + n * 8);
+    h.borrowOffset = alignTo8(h.dateOffset + n * 8);
+    h.textOffset = alignTo8(h.borrowOffset + n * 4);
+    h.stringIndexOffset = alignTo8(h.textOffset + n * TextColumnCount * 4);
+    h.poolOffset = alignTo8(h.stringIndexOffset + (stringCount + 1) * 4);
+    h.fileSize = h.poolOffset + poolChars * 2;
+
+    // 3. 填充缓冲区
+    QByteArray out(qsizetype(h.fileSize), '\0');
+    std::memcpy(out.data(), kMagic, sizeof(kMagic));
+    qint64 pos = 8;
+    putLE<quint32>(out, pos, h.version);      pos += 4;
+    putLE<quint32>(out, pos, h.bookCount);    pos += 4;
+    putLE<quint32>(out, pos, h.stringCount);  pos += 4;
+    putLE<quint32>(out, pos, h.reserved);     pos += 4;
+    for (quint64 offset : { h.priceOffset, h.dateOffset, h.borrowOffset, h.textOffset,
+                            h.stringIndexOffset, h.poolOffset, h.fileSize }) {
+        putLE<quint64>(out, pos, offset);
+        pos += 8;
+    }
+
+    for (qint64 i = 0; i < n; ++i) {
+        const Book &book = *live[i];
+        const QDate date = book.inDate.isValid() ? book.inDate : QDate::currentDate();
+        putLE<double>(out, h.priceOffset + i * 8, book.price);
+        putLE<qint64>(out, h.dateOffset + i * 8, date.toJulianDay());
+        putLE<qint32>(out, h.borrowOffset + i * 4, book.borrowCount);
+    }
+    for (qint64 k = 0; k < textIds.size(); ++k) {
+        putLE<quint32>(out, h.textOffset + k * 4, textIds[k]);
+    }
+
+    quint32 charOffset = 0;
+    for (qint64 s = 0; s < stringCount; ++s) {
+        putLE<quint32>(out, h.stringIndexOffset + s * 4, charOffset);
+        const QString &text = *strings[s];
+        for (qsizetype j = 0; j < text.size(); ++j) {
+            putLE<quint16>(out, h.poolOffset + (qint64(charOffset) + j) * 2, text[j].unicode());
+        }
+        charOffset += quint32(text.size());
+    }
+    putLE<quint32>(out, h.stringIndexOffset + stringCount * 4, charOffset);
+
+    // 4. 原子替换
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Cannot open catalog snapshot for writing:" << file.errorString();
+        return false;
+    }
+    if (file.write(out) != out.size() || !file.commit()) {
+        qDebug() << "Failed to write catalog snapshot:" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool CatalogSnapshot::read(const QString &filePath, QVector<Book> &books)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Cannot open catalog snapshot:" << file.errorString();
+        return false;
+    }
+
+    const quint64 size = quint64(file.size());
+    if (size < quint64(kHeaderSize)) {
+        qDebug() << "Catalog snapshot too small:" << filePath;
+        return false;
+    }
+
+    const uchar *base = file.map(0, qint64(size));
+    if (!base) {
+        qDebug() << "Cannot map catalog snapshot:" << file.errorString();
+        return false;
+    }
+
+    // 1. 校验头部和各段边界，任何一项不符都视为损坏，由调用方退回JSON
+    if (std::memcmp(base, kMagic, sizeof(kMagic)) != 0) {
+        qDebug() << "Invalid catalog snapshot magic:" << filePath;
+        return false;
+    }
+
+    Header h;
+    quint64 pos = 8;
+    h.version = getLE<quint32>(base, pos);      pos += 4;
+    h.bookCount = getLE<quint32>(base, pos);    pos += 4;
+    h.stringCount = getLE<quint32>(base, pos);  pos += 4;
+    h.reserved = getLE<quint32>(base, pos);     pos += 4;
+    quint64 *offsets[] = { &h.priceOffset, &h.dateOffset, &h.borrowOffset, &h.textOffset,
+                           &h.stringIndexOffset, &h.poolOffset, &h.fileSize };
+    for (quint64 *offset : offsets) {
+        *offset = getLE<quint64>(base, pos);
+        pos += 8;
+    }
+
+    if (h.version != kVersion) {
+        qDebug() << "Unsupported catalog snapshot version:" << h.version;
+        return false;
+    }
+
+    const quint64 n = h.bookCount;
+    const quint64 stringCount = h.stringCount;
+    // 段 [offset, offset + length) 落在 limit 之内；偏移量来自文件，先与上界比较再用减法，
+    // 避免 offset + length 溢出回绕后通过检查
+    auto sectionFits = [](quint64 offset, quint64 length, quint64 limit) {
+        return offset <= limit && length <= limit - offset;
+    };
+    // 计数都是32位的，下面的长度乘积不会溢出64位
+    const bool layoutOk = h.fileSize == size
+        && h.priceOffset >= quint64(kHeaderSize)
+        && h.poolOffset <= size
+        && sectionFits(h.priceOffset, n * 8, h.dateOffset)
+        && sectionFits(h.dateOffset, n * 8, h.borrowOffset)
+        && sectionFits(h.borrowOffset, n * 4, h.textOffset)
+        && sectionFits(h.textOffset, n * TextColumnCount * 4, h.stringIndexOffset)
+        && sectionFits(h.stringIndexOffset, (stringCount + 1) * 4, h.poolOffset)
+        && h.dateOffset <= size && h.borrowOffset <= size && h.textOffset <= size
+        && h.stringIndexOffset <= size;
+    if (!layoutOk) {
+        qDebug() << "Corrupted catalog snapshot layout:" << filePath;
+        return false;
+    }
+
+    // 2. 每个不同的文本只构造一次，之后各图书隐式共享
+    const quint64 poolChars = (size - h.poolOffset) / 2;
+    QVector<QString> strings;
+    strings.reserve(qsizetype(stringCount));
+    quint32 begin = getLE<quint32>(base, h.stringIndexOffset);
+    for (quint64 s = 0; s < stringCount; ++s) {
+        const quint32 end = getLE<quint32>(base, h.stringIndexOffset + (s + 1) * 4);
+        if (end < begin || end > poolChars) {
+            qDebug() << "Corrupted catalog snapshot string table:" << filePath;
+            return false;
+        }
+        QString text(qsizetype(end - begin), Qt::Uninitialized);
+        const uchar *src = base + h.poolOffset + quint64(begin) * 2;
+        if (QSysInfo::ByteOrder == QSysInfo::LittleEndian) {
+            std::memcpy(text.data(), src, size_t(end - begin) * 2);
+        } else {
+            for (quint32 j = 0; j < end - begin; ++j) {
+                text[j] = QChar(qFromLittleEndian<quint16>(src + j * 2));
+            }
+        }
+        strings.append(text);
+        begin = end;
+    }
+
+    // 3. 按列组装图书
+    QVector<Book> result;
+    result.resize(qsizetype(n));
+    for (quint64 i = 0; i < n; ++i) {
+        Book &book = result[qsizetype(i)];
+        QString *fields[TextColumnCount] = {
+            &book.indexId, &book.name, &book.author, &book.publisher,
+            &book.location, &book.category, &book.description
+        };
+        for (int c = 0; c < TextColumnCount; ++c) {
+            const quint32 id = getLE<quint32>(base, h.textOffset + (quint64(c) * n + i) * 4);
+            if (id >= stringCount) {
+                qDebug() << "Corrupted catalog snapshot text column:" << filePath;
+                return false;
+            }
+            *fields[c] = strings[id];
+        }
+        book.price = getLE<double>(base, h.priceOffset + i * 8);
+        book.inDate = QDate::fromJulianDay(getLE<qint64>(base, h.dateOffset + i * 8));
+        book.borrowCount = getLE<qint32>(base, h.borrowOffset + i * 4);
+    }
+
+    books = result;
+    return true;
+}
@@ -0,0 +1,46 @@
+// catalogsnapshot.h
+#ifndef CATALOGSNAPSHOT_H
+#define CATALOGSNAPSHOT_H
+
+#include <QString>
+#include <QVector>
+#include "book.h"
+
+// 图书目录的二进制列式快照
+// 启动时不再解析整份JSON：文件通过QFile::map映射进内存，定长列直接按下标读取，
+// 文本字段只存字符串池中的编号，相同的文本（类别、馆藏地址、出版社等）只保存和构造一次，
+// 加载后各图书共享同一个QString。JSON只用于导入导出。
+//
+// 文件布局（小端序，各段按8字节对齐）：
+//   头部         magic "LIBCATSN"、版本、图书数、字符串数、各段偏移、文件总长
+//   price        double[图书数]
+//   inDate       qint64[图书数]，儒略日
+//   borrowCount  qint32[图书数]
+//   文本列       quint32[7][图书数]，按列存放字符串编号，列顺序见 TextColumn
+//   字符串索引   quint32[字符串数 + 1]，各字符串在字符池中的起点（UTF-16码元）
+//   字符池       char16_t[]，UTF-16文本，加载时整段拷贝即可，无需解码
+class CatalogSnapshot
+{
+public:
+    static const quint32 kVersion = 1;
+
+    // 写出快照（跳过indexId为空的墓碑），使用QSaveFile原子替换
+    static bool write(const QString &filePath, const QVector<Book> &books);
+
+    // 映射并读取快照；格式、版本或长度校验失败时返回false且不修改books
+    static bool read(const QString &filePath, QVector<Book> &books);
+
+private:
+    enum TextColumn {
+        IndexIdText = 0,
+        NameText,
+        AuthorText,
+        PublisherText,
+        LocationText,
+        CategoryText,
+        DescriptionText,
+        TextColumnCount
+    };
+};
+
+#endif // CATALOGSNAPSHOT_H
@@ -0,0 +1,701 @@
+// circulationlog.cpp
+#include "circulationlog.h"
+#include "userstore.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QSet>
+#include <QMap>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <algorithm>
+
+CirculationLog& CirculationLog::instance()
+{
+    static CirculationLog instance;
+    return instance;
+}
+
+CirculationLog::CirculationLog()
+    : segmentNumber_(0)
+    , maxSegmentBytes_(4 * 1024 * 1024)
+    , nextSeq_(1)
+    , archiveHorizonDays_(365)
+    , archiveMinBatch_(256)
+    , archiveLoaded_(false)
+{
+}
+
+bool CirculationLog::open(const QString &dirPath)
+{
+    if (dirPath.isEmpty()) {
+        return false;
+    }
+    if (dirPath_ == dirPath) {
+        return true;
+    }
+
+    QDir dir(dirPath);
+    if (!dir.exists() && !dir.mkpath(".")) {
+        qDebug() << "Cannot create circulation log directory:" << dirPath;
+        return false;
+    }
+
+    segment_.close();
+    clearRecords();
+    archived_.clear();
+    archivedByUser_.clear();
+    archivedByBook_.clear();
+    archiveLoaded_ = false;
+    dirPath_ = dirPath;
+    segmentNumber_ = 0;
+    nextSeq_ = 1;
+
+    // 分段按文件名中的序号排序，即按写入时间排序
+    QMap<int, QString> segments;
+    const QStringList names = dir.entryList(QStringList() << "segment-*.log", QDir::Files, QDir::Name);
+    for (const QString &name : names) {
+        bool ok = false;
+        const int number = name.mid(8, name.size() - 12).toInt(&ok);
+        if (ok) {
+            segments.insert(number, dir.filePath(name));
+        }
+    }
+
+    // 从最新的基准分段开始重放；更早的分段已被它取代，是上次归档删到一半留下的
+    int baseNumber = 0;
+    for (auto it = segments.constEnd(); it != segments.constBegin();) {
+        --it;
+        if (isBaseSegment(it.value())) {
+            baseNumber = it.key();
+            break;
+        }
+    }
+
+    int replayed = 0;
+    for (auto it = segments.constBegin(); it != segments.constEnd(); ++it) {
+        const int number = it.key();
+        if (number < baseNumber) {
+            QFile::remove(it.value());
+            continue;
+        }
+
+        Journal reader(it.value());
+        const int count = reader.replay([this](const QJsonObject &event) {
+            applyEvent(event);
+        });
+        if (count < 0) {
+            qDebug() << "Failed to replay circulation segment" << it.value();
+            return false;
+        }
+        replayed += count;
+        segmentNumber_ = std::max(segmentNumber_, number);
+    }
+
+    qDebug() << "Loaded" << records_.size() << "borrow records from" << replayed << "circulation events";
+    return startSegment(std::max(segmentNumber_, 1));
+}
+
+bool CirculationLog::isOpen() const
+{
+    return !dirPath_.isEmpty();
+}
+
+QString CirculationLog::dirPath() const
+{
+    return dirPath_;
+}
+
+bool CirculationLog::recordBorrow(const QString &username, const QString &indexId, const QString &bookName,
+                                  const QDate &borrowDate, const QDate &dueDate)
+{
+    QJsonObject event;
+    event["type"] = "borrow";
+    event["user"] = username;
+    event["indexId"] = indexId;
+    event["bookName"] = bookName;
+    event["borrowDate"] = borrowDate.toString(Qt::ISODate);
+    event["dueDate"] = dueDate.toString(Qt::ISODate);
+    return appendEvent(event);
+}
+
+bool CirculationLog::recordReturn(const QString &username, const QString &indexId, const QDate &returnDate)
+{
+    if (!hasOpenBorrow(username, indexId)) {
+        return false;
+    }
+
+    // 记下对应的借出序号，重放和归档压缩后都能精确对应到同一条记录
+    QJsonObject event;
+    event["type"] = "return";
+    event["user"] = username;
+    event["indexId"] = indexId;
+    event["borrowSeq"] = records_.at(openByPair_.value(openKey(username, indexId)).first()).seq;
+    event["returnDate"] = returnDate.toString(Qt::ISODate);
+    return appendEvent(event);
+}
+
+bool CirculationLog::hasOpenBorrow(const QString &username, const QString &indexId) const
+{
+    return openByPair_.contains(openKey(username, indexId));
+}
+
+QVector<BorrowRecord> CirculationLog::recordsForUser(const QString &username, bool includeArchive) const
+{
+    const auto it = byUser_.constFind(username);
+    const QVector<int> *hot = it != byUser_.constEnd() ? &*it : nullptr;
+    if (!includeArchive) {
+        return mergeWithArchive(hot, nullptr);
+    }
+
+    loadArchive();
+    const auto ait = archivedByUser_.constFind(username);
+    return mergeWithArchive(hot, ait != archivedByUser_.constEnd() ? &*ait : nullptr);
+}
+
+QVector<BorrowRecord> CirculationLog::recordsForBook(const QString &indexId, bool includeArchive) const
+{
+    const auto it = byBook_.constFind(indexId);
+    const QVector<int> *hot = it != byBook_.constEnd() ? &*it : nullptr;
+    if (!includeArchive) {
+        return mergeWithArchive(hot, nullptr);
+    }
+
+    loadArchive();
+    const auto ait = archivedByBook_.constFind(indexId);
+    return mergeWithArchive(hot, ait != archivedByBook_.constEnd() ? &*ait : nullptr);
+}
+
+int CirculationLog::recordCount() const
+{
+    return records_.size();
+}
+
+int CirculationLog::migrateLegacyBorrows(UserStore &users)
+{
+    if (!isOpen()) {
+        return -1;
+    }
+
+    const QVector<QPair<QString, QJsonArray>> legacy = users.legacyBorrows();
+    if (legacy.isEmpty()) {
+        return 0;
+    }
+
+    // 按用户迁移：每个用户的事件写完后追加一条 migrated 标记，有标记的用户不再重复迁移；
+    // 全部用户都写完标记后才从users.json中删除旧数据，中途失败或中断时旧数据保持不变
+    int migrated = 0;
+    for (const auto &entry : legacy) {
+        const QString &username = entry.first;
+        if (migratedUsers_.contains(username)) {
+            continue;
+        }
+
+        // 上次在该用户写到一半时中断：按 (索引号, 借出日期) 对上已写入的借阅，不重复写入
+        QHash<QString, QVector<int>> written;
+        for (int index : byUser_.value(username)) {
+            const BorrowRecord &record = records_.at(index);
+            written[record.indexId + '\n' + record.borrowDate.toString(Qt::ISODate)].append(index);
+        }
+
+        // 把每条旧记录拆成借出/归还两个事件，按发生日期稳定排序后写入，保持日志的时间顺序
+        QVector<QPair<QDate, QJsonObject>> events;
+        for (const QJsonValue &value : entry.second) {
+            const QJsonObject old = value.toObject();
+            const QString indexId = old.value("indexId").toString();
+            if (indexId.isEmpty()) {
+                continue;
+            }
+
+            const QDate borrowDate = QDate::fromString(old.value("borrowDate").toString(), Qt::ISODate);
+            const bool returned = old.value("returned").toBool(false);
+            const QDate returnDate = QDate::fromString(old.value("returnDate").toString(), Qt::ISODate);
+            const QDate returnOrder = returnDate >= borrowDate ? returnDate : borrowDate;
+
+            QVector<int> &matches = written[indexId + '\n' + borrowDate.toString(Qt::ISODate)];
+            if (!matches.isEmpty()) {
+                const BorrowRecord &record = records_.at(matches.takeFirst());
+                if (returned && !record.returned) {
+                    QJsonObject ret;
+                    ret["type"] = "return";
+                    ret["user"] = username;
+                    ret["indexId"] = indexId;
+                    ret["borrowSeq"] = record.seq;
+                    ret["returnDate"] = old.value("returnDate").toString();
+                    events.append(qMakePair(returnOrder, ret));
+                }
+                continue;
+            }
+
+            QJsonObject borrow;
+            borrow["type"] = "borrow";
+            borrow["user"] = username;
+            borrow["indexId"] = indexId;
+            borrow["bookName"] = old.value("bookName").toString();
+            borrow["borrowDate"] = old.value("borrowDate").toString();
+            borrow["dueDate"] = old.value("dueDate").toString();
+            events.append(qMakePair(borrowDate, borrow));
+            ++migrated;
+
+            if (returned) {
+                QJsonObject ret;
+                ret["type"] = "return";
+                ret["user"] = username;
+                ret["indexId"] = indexId;
+                ret["returnDate"] = old.value("returnDate").toString();
+                events.append(qMakePair(returnOrder, ret));
+            }
+        }
+
+        std::stable_sort(events.begin(), events.end(), [](const auto &a, const auto &b) {
+            return a.first < b.first;
+        });
+        for (const auto &event : std::as_const(events)) {
+            if (!appendEvent(event.second)) {
+                return -1;
+            }
+        }
+
+        QJsonObject marker;
+        marker["type"] = "migrated";
+        marker["user"] = username;
+        if (!appendEvent(marker)) {
+            return -1;
+        }
+    }
+
+    if (!users.dropLegacyBorrows()) {
+        return -1;
+    }
+    qDebug() << "Migrated" << migrated << "borrow records from users file to circulation log";
+    return migrated;
+}
+
+int CirculationLog::archiveClosedRecords(bool force)
+{
+    if (!isOpen()) {
+        return -1;
+    }
+
+    const QDate cutoff = QDate::currentDate().addDays(-archiveHorizonDays_);
+    QMap<QString, QVector<BorrowRecord>> byMonth;
+    QVector<BorrowRecord> kept;
+    int archivedCount = 0;
+    for (const BorrowRecord &record : std::as_const(records_)) {
+        if (record.returned && record.returnDate.isValid() && record.returnDate < cutoff) {
+            byMonth[record.returnDate.toString("yyyy-MM")].append(record);
+            ++archivedCount;
+        } else {
+            kept.append(record);
+        }
+    }
+    if (archivedCount == 0 || (!force && archivedCount < archiveMinBatch_)) {
+        return 0;
+    }
+
+    // 1. 先写归档：此后崩溃时记录同时存在于归档和热日志中，按序号去重即可
+    for (auto it = byMonth.constBegin(); it != byMonth.constEnd(); ++it) {
+        if (!appendToArchive(it.key(), it.value())) {
+            return -1;
+        }
+    }
+
+    // 2. 原子写出新的基准分段，它一旦存在，更早的分段就不再参与重放
+    const int baseNumber = segmentNumber_ + 1;
+    if (!writeBaseSegment(baseNumber, kept)) {
+        return -1;
+    }
+
+    // 3. 删除被取代的分段，内存中只保留未归档的记录
+    segment_.close();
+    for (int number = 1; number < baseNumber; ++number) {
+        QFile::remove(segmentPath(number));
+    }
+    clearRecords();
+    for (const BorrowRecord &record : std::as_const(kept)) {
+        addRecord(record);
+    }
+    if (archiveLoaded_) {
+        for (auto it = byMonth.constBegin(); it != byMonth.constEnd(); ++it) {
+            for (const BorrowRecord &record : it.value()) {
+                cacheArchived(record);
+            }
+        }
+    }
+
+    qDebug() << "Archived" << archivedCount << "closed borrow records," << kept.size() << "kept in hot log";
+    if (!startSegment(baseNumber)) {
+        return -1;
+    }
+    return archivedCount;
+}
+
+int CirculationLog::archivedRecordCount() const
+{
+    loadArchive();
+    return archived_.size();
+}
+
+void CirculationLog::setMaxSegmentBytes(qint64 maxBytes)
+{
+    maxSegmentBytes_ = maxBytes;
+}
+
+void CirculationLog::setArchiveHorizonDays(int days)
+{
+    archiveHorizonDays_ = days;
+}
+
+void CirculationLog::setArchiveMinBatch(int count)
+{
+    archiveMinBatch_ = count;
+}
+
+void CirculationLog::clearRecords()
+{
+    records_.clear();
+    byUser_.clear();
+    byBook_.clear();
+    openByPair_.clear();
+    migratedUsers_.clear();
+}
+
+int CirculationLog::addRecord(const BorrowRecord &record)
+{
+    const int index = records_.size();
+    records_.append(record);
+    byUser_[record.username].append(index);
+    byBook_[record.indexId].append(index);
+    if (!record.returned) {
+        openByPair_[openKey(record.username, record.indexId)].append(index);
+    }
+    return index;
+}
+
+void CirculationLog::applyEvent(const QJsonObject &event)
+{
+    nextSeq_ = std::max<qint64>(nextSeq_, event.value("seq").toInteger() + 1);
+
+    const QString type = event.value("type").toString();
+    const QString username = event.value("user").toString();
+    const QString indexId = event.value("indexId").toString();
+    const QString key = openKey(username, indexId);
+
+    if (type == "borrow") {
+        BorrowRecord record;
+        record.seq = event.value("seq").toInteger();
+        record.username = username;
+        record.indexId = indexId;
+        record.bookName = event.value("bookName").toString();
+        record.borrowDate = QDate::fromString(event.value("borrowDate").toString(), Qt::ISODate);
+        record.dueDate = QDate::fromString(event.value("dueDate").toString(), Qt::ISODate);
+        addRecord(record);
+    } else if (type == "return") {
+        auto it = openByPair_.find(key);
+        if (it == openByPair_.end()) {
+            return;
+        }
+
+        // 优先按借出序号对应；旧事件没有序号时取最早的一条未还记录
+        int pos = 0;
+        if (event.contains("borrowSeq")) {
+            const qint64 borrowSeq = event.value("borrowSeq").toInteger();
+            for (int i = 0; i < it->size(); ++i) {
+                if (records_.at(it->at(i)).seq == borrowSeq) {
+                    pos = i;
+                    break;
+                }
+            }
+        }
+
+        BorrowRecord &record = records_[it->takeAt(pos)];
+        record.returned = true;
+        record.returnDate = QDate::fromString(event.value("returnDate").toString(), Qt::ISODate);
+        if (it->isEmpty()) {
+            openByPair_.erase(it);
+        }
+    } else if (type == "migrated") {
+        migratedUsers_.insert(username);
+    } else if (type == "base") {
+        // 基准分段的头部：记录压缩前的序号上限和已迁移旧数据的用户
+        nextSeq_ = std::max<qint64>(nextSeq_, event.value("nextSeq").toInteger());
+        for (const QJsonValue &user : event.value("migratedUsers").toArray()) {
+            migratedUsers_.insert(user.toString());
+        }
+    } else {
+        qDebug() << "Unknown circulation event type:" << type;
+    }
+}
+
+bool CirculationLog::appendEvent(QJsonObject event)
+{
+    if (!isOpen()) {
+        return false;
+    }
+
+    event["seq"] = nextSeq_;
+    event["time"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+
+    if (segment_.sizeInBytes() >= maxSegmentBytes_ && !startSegment(segmentNumber_ + 1)) {
+        return false;
+    }
+    if (!segment_.append(event)) {
+        return false;
+    }
+
+    applyEvent(event);
+    return true;
+}
+
+bool CirculationLog::startSegment(int number)
+{
+    segment_.setFilePath(segmentPath(number));
+    if (!segment_.open()) {
+        return false;
+    }
+    segmentNumber_ = number;
+    return true;
+}
+
+bool CirculationLog::writeBaseSegment(int number, const QVector<BorrowRecord> &kept) const
+{
+    // 头部 + 每条记录的借出事件 + 已还记录的归还事件（按归还日期排序），事件保留原序号
+    QByteArray data;
+    auto appendLine = [&data](const QJsonObject &event) {
+        data.append(QJsonDocument(event).toJson(QJsonDocument::Compact));
+        data.append('\n');
+    };
+
+    QJsonObject header;
+    header["type"] = "base";
+    header["nextSeq"] = nextSeq_;
+    QStringList migratedUsers(migratedUsers_.cbegin(), migratedUsers_.cend());
+    migratedUsers.sort();
+    header["migratedUsers"] = QJsonArray::fromStringList(migratedUsers);
+    header["time"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    appendLine(header);
+
+    QVector<const BorrowRecord *> returned;
+    for (const BorrowRecord &record : kept) {
+        QJsonObject event;
+        event["seq"] = record.seq;
+        event["type"] = "borrow";
+        event["user"] = record.username;
+        event["indexId"] = record.indexId;
+        event["bookName"] = record.bookName;
+        event["borrowDate"] = record.borrowDate.toString(Qt::ISODate);
+        event["dueDate"] = record.dueDate.toString(Qt::ISODate);
+        appendLine(event);
+        if (record.returned) {
+            returned.append(&record);
+        }
+    }
+
+    std::stable_sort(returned.begin(), returned.end(), [](const BorrowRecord *a, const BorrowRecord *b) {
+        return a->returnDate < b->returnDate;
+    });
+    for (const BorrowRecord *record : std::as_const(returned)) {
+        QJsonObject event;
+        event["type"] = "return";
+        event["user"] = record->username;
+        event["indexId"] = record->indexId;
+        event["borrowSeq"] = record->seq;
+        event["returnDate"] = record->returnDate.toString(Qt::ISODate);
+        appendLine(event);
+    }
+
+    QSaveFile file(segmentPath(number));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Cannot open circulation base segment for writing:" << file.errorString();
+        return false;
+    }
+    file.write(data);
+    if (!file.commit()) {
+        qDebug() << "Failed to commit circulation base segment:" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QString CirculationLog::segmentPath(int number) const
+{
+    return QDir(dirPath_).filePath(QStringLiteral("segment-%1.log").arg(number, 6, 10, QLatin1Char('0')));
+}
+
+QString CirculationLog::openKey(const QString &username, const QString &indexId)
+{
+    return username + QLatin1Char('\x1f') + indexId;
+}
+
+bool CirculationLog::isBaseSegment(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readLine().trimmed());
+    return doc.isObject() && doc.object().value("type").toString() == "base";
+}
+
+QString CirculationLog::archiveDirPath() const
+{
+    return QDir(dirPath_).filePath("archive");
+}
+
+bool CirculationLog::appendToArchive(const QString &month, const QVector<BorrowRecord> &records) const
+{
+    QDir dir(archiveDirPath());
+    if (!dir.exists() && !dir.mkpath(".")) {
+        qDebug() << "Cannot create circulation archive directory:" << dir.path();
+        return false;
+    }
+
+    // 归档分段很少改写，直接读出整月数据合并后整体重写；按序号去重，重复归档不会产生重复记录
+    const QString path = dir.filePath(month + ".arc");
+    QVector<BorrowRecord> existing;
+    if (QFile::exists(path) && !readArchiveFile(path, existing)) {
+        return false;
+    }
+
+    QSet<qint64> seen;
+    for (const BorrowRecord &record : std::as_const(existing)) {
+        seen.insert(record.seq);
+    }
+
+    QByteArray data;
+    auto appendLine = [&data](const BorrowRecord &record) {
+        data.append(QJsonDocument(recordToJson(record)).toJson(QJsonDocument::Compact));
+        data.append('\n');
+    };
+    for (const BorrowRecord &record : std::as_const(existing)) {
+        appendLine(record);
+    }
+    for (const BorrowRecord &record : records) {
+        if (!seen.contains(record.seq)) {
+            appendLine(record);
+        }
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Cannot open circulation archive for writing:" << file.errorString();
+        return false;
+    }
+    file.write(qCompress(data));
+    if (!file.commit()) {
+        qDebug() << "Failed to commit circulation archive:" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool CirculationLog::readArchiveFile(const QString &path, QVector<BorrowRecord> &records)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Cannot open circulation archive:" << file.errorString();
+        return false;
+    }
+
+    const QByteArray data = qUncompress(file.readAll());
+    if (data.isEmpty()) {
+        qDebug() << "Circulation archive is empty or corrupted:" << path;
+        return false;
+    }
+
+    for (const QByteArray &line : data.split('\n')) {
+        if (line.isEmpty()) {
+            continue;
+        }
+        const QJsonDocument doc = QJsonDocument::fromJson(line);
+        if (doc.isObject()) {
+            records.append(recordFromJson(doc.object()));
+        }
+    }
+    return true;
+}
+
+void CirculationLog::loadArchive() const
+{
+    if (archiveLoaded_ || !isOpen()) {
+        return;
+    }
+    archiveLoaded_ = true;
+
+    const QDir dir(archiveDirPath());
+    const QStringList names = dir.entryList(QStringList() << "*.arc", QDir::Files, QDir::Name);
+    for (const QString &name : names) {
+        QVector<BorrowRecord> records;
+        if (!readArchiveFile(dir.filePath(name), records)) {
+            continue;
+        }
+        for (const BorrowRecord &record : std::as_const(records)) {
+            cacheArchived(record);
+        }
+    }
+    qDebug() << "Loaded" << archived_.size() << "archived borrow records from" << names.size() << "segments";
+}
+
+void CirculationLog::cacheArchived(const BorrowRecord &record) const
+{
+    const int index = archived_.size();
+    archived_.append(record);
+    archivedByUser_[record.username].append(index);
+    archivedByBook_[record.indexId].append(index);
+}
+
+QVector<BorrowRecord> CirculationLog::mergeWithArchive(const QVector<int> *hot, const QVector<int> *archived) const
+{
+    QVector<BorrowRecord> result;
+    result.reserve((hot ? hot->size() : 0) + (archived ? archived->size() : 0));
+
+    QSet<qint64> hotSeqs;
+    if (hot) {
+        for (int index : *hot) {
+            result.append(records_.at(index));
+            hotSeqs.insert(records_.at(index).seq);
+        }
+    }
+    if (!archived) {
+        return result;
+    }
+
+    // 归档写完而热日志尚未压缩时同一条记录会出现两次，以热日志为准
+    for (int index : *archived) {
+        if (!hotSeqs.contains(archived_.at(index).seq)) {
+            result.append(archived_.at(index));
+        }
+    }
+    std::stable_sort(result.begin(), result.end(), [](const BorrowRecord &a, const BorrowRecord &b) {
+        return a.seq < b.seq;
+    });
+    return result;
+}
+
+QJsonObject CirculationLog::recordToJson(const BorrowRecord &record)
+{
+    QJsonObject obj;
+    obj["seq"] = record.seq;
+    obj["user"] = record.username;
+    obj["indexId"] = record.indexId;
+    obj["bookName"] = record.bookName;
+    obj["borrowDate"] = record.borrowDate.toString(Qt::ISODate);
+    obj["dueDate"] = record.dueDate.toString(Qt::ISODate);
+    obj["returnDate"] = record.returnDate.toString(Qt::ISODate);
+    return obj;
+}
+
+BorrowRecord CirculationLog::recordFromJson(const QJsonObject &obj)
+{
+    BorrowRecord record;
+    record.seq = obj.value("seq").toInteger();
+    record.username = obj.value("user").toString();
+    record.indexId = obj.value("indexId").toString();
+    record.bookName = obj.value("bookName").toString();
+    record.borrowDate = QDate::fromString(obj.value("borrowDate").toString(), Qt::ISODate);
+    record.dueDate = QDate::fromString(obj.value("dueDate").toString(), Qt::ISODate);
+    record.returnDate = QDate::fromString(obj.value("returnDate").toString(), Qt::ISODate);
+    record.returned = true;
+    return record;
+}
@@ -0,0 +1,123 @@
+// circulationlog.h
+#ifndef CIRCULATIONLOG_H
+#define CIRCULATIONLOG_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QDate>
+#include <QDateTime>
+#include <QJsonObject>
+#include "journal.h"
+
+class UserStore;
+
+// 一次借阅：借出事件与对应的归还事件合并而成
+struct BorrowRecord {
+    qint64 seq = 0;       // 借出事件的序号，全局唯一
+    QString username;
+    QString indexId;
+    QString bookName;
+    QDate borrowDate;
+    QDate dueDate;
+    QDate returnDate;     // 未归还时无效
+    bool returned = false;
+};
+
+// 流通事件日志（借出/归还）
+// - 只追加、按时间顺序写入分段文件 circulation/segment-NNNNNN.log，每行一条紧凑JSON事件；
+//   当前分段超过大小上限后另起新分段，旧分段不再改写
+// - 启动时按分段顺序重放一次，在内存中按用户和按索引号建立借阅记录索引，
+//   查某个用户或某本书的借阅历史只与结果数量有关，写入一条事件是O(1)
+// - 取代users.json中每个用户的borrows数组；旧数据由migrateLegacyBorrows()一次性迁移
+// - 归还日期早于保留期限的记录由archiveClosedRecords()移入按月分段的压缩归档
+//   circulation/archive/yyyy-MM.arc，热日志随之压缩成一个只含未还和近期记录的基准分段；
+//   启动时只重放最新的基准分段及其后的分段，归档只在需要完整历史的查询中才加载
+// - 只在主线程使用，不加锁
+class CirculationLog
+{
+public:
+    static CirculationLog& instance();
+
+    // 打开日志目录（不存在时创建）；已经打开同一个目录时直接返回true
+    bool open(const QString &dirPath);
+    bool isOpen() const;
+    QString dirPath() const;
+
+    // 写入事件
+    bool recordBorrow(const QString &username, const QString &indexId, const QString &bookName,
+                      const QDate &borrowDate, const QDate &dueDate);
+    // 把该用户该书最早一条未归还记录标记为已归还，没有未归还记录时返回false
+    bool recordReturn(const QString &username, const QString &indexId, const QDate &returnDate);
+
+    // 查询（按借出时间顺序）；includeArchive为true时合并归档中的历史记录
+    bool hasOpenBorrow(const QString &username, const QString &indexId) const;
+    QVector<BorrowRecord> recordsForUser(const QString &username, bool includeArchive = false) const;
+    QVector<BorrowRecord> recordsForBook(const QString &indexId, bool includeArchive = false) const;
+    // 热日志中的记录数（不含归档）
+    int recordCount() const;
+
+    // 把用户对象中遗留的borrows数组迁移为事件并从users.json中删除，返回迁移的记录数，失败返回-1
+    // 按用户写迁移标记，中断后再次调用只迁移尚未完成的用户；所有用户都写完后才删除旧数据
+    int migrateLegacyBorrows(UserStore &users);
+
+    // 归档超过保留期限的已还记录，返回归档的记录数，失败返回-1
+    // 可归档的记录少于最小批量时不做任何事，除非force为true
+    int archiveClosedRecords(bool force = false);
+    int archivedRecordCount() const;
+
+    // 单个分段文件的大小上限
+    void setMaxSegmentBytes(qint64 maxBytes);
+    // 已还记录在热日志中的保留天数（按归还日期计算）
+    void setArchiveHorizonDays(int days);
+    void setArchiveMinBatch(int count);
+
+private:
+    CirculationLog();
+    ~CirculationLog() = default;
+    CirculationLog(const CirculationLog&) = delete;
+    CirculationLog& operator=(const CirculationLog&) = delete;
+
+    void clearRecords();
+    int addRecord(const BorrowRecord &record);
+    void applyEvent(const QJsonObject &event);
+    bool appendEvent(QJsonObject event);
+    bool startSegment(int number);
+    bool writeBaseSegment(int number, const QVector<BorrowRecord> &kept) const;
+    QString segmentPath(int number) const;
+    static bool isBaseSegment(const QString &path);
+    static QString openKey(const QString &username, const QString &indexId);
+
+    // 归档
+    QString archiveDirPath() const;
+    bool appendToArchive(const QString &month, const QVector<BorrowRecord> &records) const;
+    static bool readArchiveFile(const QString &path, QVector<BorrowRecord> &records);
+    void loadArchive() const;
+    void cacheArchived(const BorrowRecord &record) const;
+    QVector<BorrowRecord> mergeWithArchive(const QVector<int> *hot, const QVector<int> *archived) const;
+    static QJsonObject recordToJson(const BorrowRecord &record);
+    static BorrowRecord recordFromJson(const QJsonObject &obj);
+
+    QString dirPath_;
+    Journal segment_;                          // 当前写入的分段
+    int segmentNumber_;
+    qint64 maxSegmentBytes_;
+    qint64 nextSeq_;                           // 下一条事件的序号
+    int archiveHorizonDays_;
+    int archiveMinBatch_;
+
+    QVector<BorrowRecord> records_;            // 按借出事件的写入顺序
+    QHash<QString, QVector<int>> byUser_;      // 用户名 -> records_下标
+    QHash<QString, QVector<int>> byBook_;      // 索引号 -> records_下标
+    QHash<QString, QVector<int>> openByPair_;  // 用户名+索引号 -> 未归还记录下标
+    QSet<QString> migratedUsers_;              // 旧borrows数组已迁移完的用户
+
+    // 归档缓存，第一次需要完整历史时才加载
+    mutable bool archiveLoaded_;
+    mutable QVector<BorrowRecord> archived_;
+    mutable QHash<QString, QVector<int>> archivedByUser_;
+    mutable QHash<QString, QVector<int>> archivedByBook_;
+};
+
+#endif // CIRCULATIONLOG_H
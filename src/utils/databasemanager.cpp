@@ -2,10 +2,18 @@
 #include "databasemanager.h"
 #include <QDebug>
 #include <QDate>
+#include <QDateTime>
 #include <QDir>
+#include <QSaveFile>
 #include <QStandardPaths>
 #include <QApplication>
+#include <algorithm>
 #include "bookcopymanager.h"
+#include "catalogsnapshot.h"
+#include "stringpool.h"
+#include "textmatcher.h"
+#include "parallelscan.h"
+#include "jsonarrayreader.h"
 
 // 单例实例
 DatabaseManager& DatabaseManager::instance()
@@ -16,14 +24,31 @@ DatabaseManager& DatabaseManager::instance()
 
 DatabaseManager::DatabaseManager(QObject *parent)
     : QObject(parent)
+    , tombstoneCount_(0)
+    , binarySnapshot_(false)
+    , checkpointMaxRecords_(2000)
+    , checkpointMaxBytes_(4 * 1024 * 1024)
     , isInitialized_(false)
 {
+    // 退出事件循环时收尾；单例析构发生在静态对象销毁阶段，那时不再做文件I/O
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                this, &DatabaseManager::shutdown);
+    }
+
     initializeDatabase();
 }
 
 DatabaseManager::~DatabaseManager()
 {
-    saveToFile();
+}
+
+void DatabaseManager::shutdown()
+{
+    // 每条变更都已逐条刷盘；日志为空说明快照已是最新，不必在退出时重写整个目录
+    if (journal_.recordCount() > 0) {
+        checkpoint();
+    }
 }
 
 bool DatabaseManager::initializeDatabase()
@@ -49,27 +74,53 @@ bool DatabaseManager::initializeDatabase()
     }
 
     dbFilePath_ = absoluteTargetPath + "/library_data.json";
+    snapshotFilePath_ = absoluteTargetPath + "/library_data.bin";
+    journal_.setFilePath(absoluteTargetPath + "/library_data.journal");
     qDebug() << "Database file path:" << dbFilePath_;
     
-    // 尝试加载现有数据
-    if (QFile::exists(dbFilePath_)) {
+    // 尝试加载现有数据（快照 + 变更日志）
+    const QStringList dataFiles = {snapshotFilePath_, dbFilePath_, journal_.rotatedFilePath(), journal_.filePath()};
+    bool hasData = false;
+    for (const QString &path : dataFiles) {
+        hasData = hasData || QFile::exists(path);
+    }
+    if (hasData) {
         if (loadFromFile()) {
-            qDebug() << "Database loaded successfully with" << books_.size() << "books";
+            qDebug() << "Database loaded successfully with" << slotById_.size() << "books";
+            journal_.open();
             isInitialized_ = true;
             return true;
-        } else {
-            qDebug() << "Failed to load existing database, creating new one";
         }
+
+        // 加载失败时绝不能用空库覆盖原文件：先把所有数据文件改名保存，再新建空库；
+        // 有文件改名失败时保持未初始化状态，不写任何文件
+        const QString suffix = ".corrupt-" + QDateTime::currentDateTime().toString("yyyyMMddHHmmss");
+        QStringList moved;
+        for (const QString &path : dataFiles) {
+            if (!QFile::exists(path)) {
+                continue;
+            }
+            if (!QFile::rename(path, path + suffix)) {
+                loadError_ = QString("无法读取图书数据文件，且无法将其移到一旁：%1").arg(path);
+                qWarning() << "Failed to load database and cannot move" << path << "aside; database is not writable";
+                clearBooks();
+                return false;
+            }
+            moved.append(path + suffix);
+        }
+        loadError_ = QString("无法读取图书数据，已从空库启动。原数据文件已改名保存：\n%1").arg(moved.join("\n"));
+        qWarning() << "Failed to load existing database, moved files aside:" << moved;
     }
 
     // 创建新的空数据库
-    books_.clear();
-    if (saveToFile()) {
+    clearBooks();
+    isInitialized_ = true;
+    if (checkpoint()) {
         qDebug() << "New database created successfully";
-        isInitialized_ = true;
         return true;
     }
 
+    isInitialized_ = false;
     qDebug() << "Failed to create database";
     return false;
 }
@@ -84,7 +135,48 @@ QString DatabaseManager::getDatabasePath() const
     return dbFilePath_;
 }
 
+QString DatabaseManager::loadError() const
+{
+    return loadError_;
+}
+
 bool DatabaseManager::loadFromFile()
+{
+    // 重新加载时槽位是紧凑的，墓碑不会跨进程保留
+    clearBooks();
+
+    // 1. 加载最近一次检查点写出的快照。二进制快照存在时它就是最新的检查点
+    //    （写JSON快照时会删除它），此时JSON快照已经过时、日志也已在二进制检查点时清空，
+    //    二进制快照损坏只能报错，不能退回JSON快照
+    if (QFile::exists(snapshotFilePath_)) {
+        QVector<Book> books;
+        if (!CatalogSnapshot::read(snapshotFilePath_, books)) {
+            qWarning() << "Binary snapshot unreadable:" << snapshotFilePath_;
+            return false;
+        }
+        store_.reserve(books.size());
+        for (const Book &book : std::as_const(books)) {
+            if (!slotById_.contains(book.indexId)) {
+                insertBook(book);
+            }
+        }
+    } else if (QFile::exists(dbFilePath_) && !loadJsonSnapshot()) {
+        return false;
+    }
+
+    // 2. 重放快照之后追加的变更
+    int replayed = journal_.replay([this](const QJsonObject &record) {
+        applyJournalRecord(record);
+    });
+    if (replayed < 0) {
+        return false;
+    }
+
+    qDebug() << "Loaded" << slotById_.size() << "books from database," << replayed << "journal records replayed";
+    return true;
+}
+
+bool DatabaseManager::loadJsonSnapshot()
 {
     QFile file(dbFilePath_);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -101,48 +193,255 @@ bool DatabaseManager::loadFromFile()
         return false;
     }
 
-    books_.clear();
+    clearBooks();
     QJsonArray jsonArray = doc.array();
     for (const QJsonValue &value : jsonArray) {
         if (value.isObject()) {
-            books_.append(bookFromJson(value.toObject()));
+            Book book = bookFromJson(value.toObject());
+            if (!book.indexId.isEmpty() && !slotById_.contains(book.indexId)) {
+                insertBook(book);
+            }
         }
     }
-
-    qDebug() << "Loaded" << books_.size() << "books from database";
     return true;
 }
 
 bool DatabaseManager::saveToFile()
 {
-    QFile file(dbFilePath_);
+    if (!binarySnapshot_) {
+        // 改回JSON快照时删除旧的二进制快照，否则下次启动会优先加载它
+        if (!saveJsonSnapshot()) {
+            return false;
+        }
+        if (QFile::exists(snapshotFilePath_)) {
+            QFile::remove(snapshotFilePath_);
+        }
+        return true;
+    }
+
+    if (!CatalogSnapshot::write(snapshotFilePath_, store_.books())) {
+        return false;
+    }
+    qDebug() << "Saved" << slotById_.size() << "books to binary snapshot";
+    return true;
+}
+
+bool DatabaseManager::saveJsonSnapshot()
+{
+    // 使用QSaveFile保证快照原子替换，写入中途失败不会破坏旧快照
+    QSaveFile file(dbFilePath_);
     if (!file.open(QIODevice::WriteOnly)) {
         qDebug() << "Cannot open database file for writing:" << file.errorString();
         return false;
     }
 
     QJsonArray jsonArray;
-    for (const Book &book : books_) {
-        jsonArray.append(bookToJson(book));
+    for (const Book &book : store_.books()) {
+        if (!book.indexId.isEmpty()) {
+            jsonArray.append(bookToJson(book));
+        }
     }
 
     QJsonDocument doc(jsonArray);
     file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
+    if (!file.commit()) {
+        qDebug() << "Failed to commit database file:" << file.errorString();
+        return false;
+    }
+
+    qDebug() << "Saved" << slotById_.size() << "books to database";
+    return true;
+}
+
+bool DatabaseManager::checkpoint()
+{
+    // 加载失败且原文件没能移开时不写任何文件
+    if (!isInitialized_) {
+        return false;
+    }
+    // 先写快照再清空日志：两步之间崩溃时，日志中的记录会被幂等地重放一遍
+    if (!saveToFile()) {
+        return false;
+    }
+    return journal_.reset();
+}
+
+void DatabaseManager::setCheckpointThresholds(int maxRecords, qint64 maxBytes)
+{
+    checkpointMaxRecords_ = maxRecords;
+    checkpointMaxBytes_ = maxBytes;
+}
+
+void DatabaseManager::setBinarySnapshotEnabled(bool enabled)
+{
+    binarySnapshot_ = enabled;
+}
+
+bool DatabaseManager::isBinarySnapshotEnabled() const
+{
+    return binarySnapshot_;
+}
+
+void DatabaseManager::applyJournalRecord(const QJsonObject& record)
+{
+    const QString op = record.value("op").toString();
+
+    if (op == "put") {
+        Book book = bookFromJson(record.value("book").toObject());
+        const int slot = slotOf(book.indexId);
+        if (slot >= 0) {
+            replaceBook(slot, book);
+        } else if (!book.indexId.isEmpty()) {
+            insertBook(book);
+        }
+    } else if (op == "del") {
+        const int slot = slotOf(record.value("indexId").toString());
+        if (slot >= 0) {
+            eraseSlot(slot);
+        }
+    } else {
+        qDebug() << "Unknown journal operation:" << op;
+    }
+}
+
+bool DatabaseManager::logMutation(const QJsonObject& record)
+{
+    if (!isInitialized_) {
+        return false;
+    }
+    if (!journal_.append(record)) {
+        // 日志不可写时退回到整库保存，保证数据不丢
+        return checkpoint();
+    }
 
-    qDebug() << "Saved" << books_.size() << "books to database";
+    if (journal_.recordCount() >= checkpointMaxRecords_ ||
+        journal_.sizeInBytes() >= checkpointMaxBytes_) {
+        return checkpoint();
+    }
     return true;
 }
 
+void DatabaseManager::clearBooks()
+{
+    store_.clear();
+    sortIndex_.clear();
+    slotById_.clear();
+    tombstoneCount_ = 0;
+}
+
+Book DatabaseManager::internedBook(const Book& book)
+{
+    // 低基数字段驻留后，同值的图书共享同一份字符串数据
+    StringPool &pool = StringPool::instance();
+    Book result = book;
+    result.author = pool.intern(book.author);
+    result.publisher = pool.intern(book.publisher);
+    result.location = pool.intern(book.location);
+    result.category = pool.intern(book.category);
+    return result;
+}
+
+int DatabaseManager::insertBook(const Book& book)
+{
+    StringPool &pool = StringPool::instance();
+    const int slot = store_.append(internedBook(book), pool.idOf(book.category), pool.idOf(book.location));
+    slotById_.insert(book.indexId, slot);
+    sortIndex_.markDirty(slot);
+    return slot;
+}
+
+void DatabaseManager::replaceBook(int slot, const Book& book)
+{
+    // 排序索引只处理真正变化的排序字段，借还只改借阅次数时其余排序表不受影响
+    StringPool &pool = StringPool::instance();
+    const Book oldBook = *store_.bookAt(slot);
+    store_.replace(slot, internedBook(book), pool.idOf(book.category), pool.idOf(book.location));
+    sortIndex_.updateSlot(slot, oldBook, store_);
+}
+
+void DatabaseManager::eraseSlot(int slot)
+{
+    // 留下墓碑而不是removeAt，避免移动后续元素，也让其他槽位号保持稳定
+    slotById_.remove(store_.bookAt(slot)->indexId);
+    sortIndex_.removeSlot(slot, store_);
+    store_.erase(slot);
+    ++tombstoneCount_;
+}
+
+int DatabaseManager::slotOf(const QString& indexId) const
+{
+    return slotById_.value(indexId, -1);
+}
+
+const Book* DatabaseManager::bookAt(int slot) const
+{
+    return store_.bookAt(slot);
+}
+
+int DatabaseManager::slotCount() const
+{
+    return store_.size();
+}
+
+int DatabaseManager::categoryIdAt(int slot) const
+{
+    return store_.isLive(slot) ? store_.categoryIdAt(slot) : 0;
+}
+
+int DatabaseManager::locationIdAt(int slot) const
+{
+    return store_.isLive(slot) ? store_.locationIdAt(slot) : 0;
+}
+
+int DatabaseManager::borrowCountAt(int slot) const
+{
+    return store_.borrowCountAt(slot);
+}
+
+double DatabaseManager::priceAt(int slot) const
+{
+    return store_.priceAt(slot);
+}
+
+QVector<int> DatabaseManager::slotsOrderedBy(SortIndex::Key key, int offset, int limit) const
+{
+    const QVector<int> &order = sortIndex_.order(key, store_);
+    if (offset <= 0 && limit < 0) {
+        return order;
+    }
+    return order.mid(offset, limit);
+}
+
+void DatabaseManager::sortSlotsBy(SortIndex::Key key, QVector<int> &slotList) const
+{
+    sortIndex_.sortSlots(key, slotList, store_);
+}
+
+QVector<int> DatabaseManager::bookCountByLocationId() const
+{
+    return store_.countByLocation();
+}
+
+QVector<int> DatabaseManager::bookCountByCategoryId() const
+{
+    return store_.countByCategory();
+}
+
+const Book* DatabaseManager::findBook(const QString& indexId) const
+{
+    return bookAt(slotOf(indexId));
+}
+
 Book DatabaseManager::bookFromJson(const QJsonObject& obj)
 {
     Book book;
     book.indexId = obj.value("indexId").toString();
     book.name = obj.value("name").toString();
-    book.author = obj.value("author").toString();
-    book.publisher = obj.value("publisher").toString();
-    book.location = obj.value("location").toString();
-    book.category = obj.value("category").toString();
+    StringPool &pool = StringPool::instance();
+    book.author = pool.intern(obj.value("author").toString());
+    book.publisher = pool.intern(obj.value("publisher").toString());
+    book.location = pool.intern(obj.value("location").toString());
+    book.category = pool.intern(obj.value("category").toString());
     book.price = obj.value("price").toDouble();
 
     // 修改 inDate 的读取逻辑
@@ -183,12 +482,15 @@ QJsonObject DatabaseManager::bookToJson(const Book& book)
 
 bool DatabaseManager::addBook(const Book& book)
 {
+    if (book.indexId.isEmpty()) {
+        qDebug() << "Cannot add book with empty indexId";
+        return false;
+    }
+
     // 检查索引号是否已存在
-    for (const Book& existingBook : books_) {
-        if (existingBook.indexId == book.indexId) {
-            qDebug() << "Book with indexId" << book.indexId << "already exists";
-            return false;
-        }
+    if (slotById_.contains(book.indexId)) {
+        qDebug() << "Book with indexId" << book.indexId << "already exists";
+        return false;
     }
 
     // 确保日期有效
@@ -198,144 +500,160 @@ bool DatabaseManager::addBook(const Book& book)
         qDebug() << "Invalid inDate for book" << book.indexId << ", using current date";
     }
 
-    books_.append(validBook);
-    return saveToFile();
+    insertBook(validBook);
+
+    QJsonObject record;
+    record["op"] = "put";
+    record["book"] = bookToJson(validBook);
+    return logMutation(record);
 }
 
 bool DatabaseManager::updateBook(const Book& book)
 {
-    for (int i = 0; i < books_.size(); ++i) {
-        if (books_[i].indexId == book.indexId) {
-            // 确保日期有效
-            Book validBook = book;
-            if (!validBook.inDate.isValid()) {
-                validBook.inDate = QDate::currentDate();
-                qDebug() << "Invalid inDate for book" << book.indexId << ", using current date";
-            }
+    const int slot = slotOf(book.indexId);
+    if (slot < 0) {
+        qDebug() << "Book with indexId" << book.indexId << "not found for update";
+        return false;
+    }
 
-            books_[i] = validBook;
-            return saveToFile();
-        }
+    // 确保日期有效
+    Book validBook = book;
+    if (!validBook.inDate.isValid()) {
+        validBook.inDate = QDate::currentDate();
+        qDebug() << "Invalid inDate for book" << book.indexId << ", using current date";
     }
 
-    qDebug() << "Book with indexId" << book.indexId << "not found for update";
-    return false;
+    replaceBook(slot, validBook);
+
+    QJsonObject record;
+    record["op"] = "put";
+    record["book"] = bookToJson(validBook);
+    return logMutation(record);
 }
 
 bool DatabaseManager::removeBook(const QString& indexId)
 {
-    for (int i = 0; i < books_.size(); ++i) {
-        if (books_[i].indexId == indexId) {
-            books_.removeAt(i);
-            return saveToFile();
-        }
+    const int slot = slotOf(indexId);
+    if (slot < 0) {
+        qDebug() << "Book with indexId" << indexId << "not found for removal";
+        return false;
     }
 
-    qDebug() << "Book with indexId" << indexId << "not found for removal";
-    return false;
-}
+    eraseSlot(slot);
 
-QVector<Book> DatabaseManager::getAllBooks()
-{
-    return books_;
+    QJsonObject record;
+    record["op"] = "del";
+    record["indexId"] = indexId;
+    return logMutation(record);
 }
 
-Book DatabaseManager::getBookByIndexId(const QString& indexId)
+QVector<Book> DatabaseManager::getAllBooks() const
 {
-    for (const Book& book : books_) {
-        if (book.indexId == indexId) {
-            return book;
-        }
+    if (tombstoneCount_ == 0) {
+        return store_.books();
     }
 
-    return Book(); // 返回空的Book对象
-}
-
-QVector<Book> DatabaseManager::searchBooks(const QString& keyword)
-{
     QVector<Book> result;
-    QString lowerKeyword = keyword.toLower();
-
-    for (const Book& book : books_) {
-        if (book.name.toLower().contains(lowerKeyword) ||
-            book.category.toLower().contains(lowerKeyword) ||
-            book.location.toLower().contains(lowerKeyword) ||
-            book.indexId.toLower().contains(lowerKeyword) ||
-            book.author.toLower().contains(lowerKeyword) ||
-            book.publisher.toLower().contains(lowerKeyword)) {
+    result.reserve(slotById_.size());
+    for (const Book& book : store_.books()) {
+        if (!book.indexId.isEmpty()) {
             result.append(book);
         }
     }
-
     return result;
 }
 
+Book DatabaseManager::getBookByIndexId(const QString& indexId)
+{
+    const Book *book = findBook(indexId);
+    return book ? *book : Book(); // 未找到时返回空的Book对象
+}
+
+QVector<Book> DatabaseManager::searchBooks(const QString& keyword)
+{
+    // 直接在原文上不区分大小写匹配，不再为每个字段生成小写副本；各块并行扫描
+    const TextMatcher matcher(keyword);
+    const Book *books = store_.books().constData();
+
+    const QVector<int> slotList = ParallelScan::instance().filter(store_.size(), [&](int slot) {
+        const Book &book = books[slot];
+        return !book.indexId.isEmpty() &&
+               (matcher.matches(book.name) ||
+                matcher.matches(book.category) ||
+                matcher.matches(book.location) ||
+                matcher.matches(book.indexId) ||
+                matcher.matches(book.author) ||
+                matcher.matches(book.publisher));
+    });
+
+    return booksAt(slotList);
+}
+
 QVector<Book> DatabaseManager::fuzzySearchByName(const QString& keyword)
 {
-    QVector<Book> result;
-    QString lowerKeyword = keyword.toLower();
+    const TextMatcher matcher(keyword);
+    const Book *books = store_.books().constData();
 
-    for (const Book& book : books_) {
-        if (book.name.toLower().contains(lowerKeyword)) {
-            result.append(book);
-        }
-    }
+    const QVector<int> slotList = ParallelScan::instance().filter(store_.size(), [&](int slot) {
+        return !books[slot].indexId.isEmpty() && matcher.matches(books[slot].name);
+    });
 
-    return result;
+    return booksAt(slotList);
 }
 
 QVector<Book> DatabaseManager::fuzzySearchByIndexId(const QString& keyword)
 {
-    QVector<Book> result;
-    QString lowerKeyword = keyword.toLower();
+    const TextMatcher matcher(keyword);
+    const Book *books = store_.books().constData();
 
-    for (const Book& book : books_) {
-        if (book.indexId.toLower().contains(lowerKeyword)) {
-            result.append(book);
-        }
-    }
+    const QVector<int> slotList = ParallelScan::instance().filter(store_.size(), [&](int slot) {
+        return !books[slot].indexId.isEmpty() && matcher.matches(books[slot].indexId);
+    });
 
-    return result;
+    return booksAt(slotList);
 }
 
 QVector<Book> DatabaseManager::getBooksByCategory(const QString& category)
 {
-    QVector<Book> result;
-
-    for (const Book& book : books_) {
-        if (book.category == category) {
-            result.append(book);
-        }
+    // 比较驻留编号而不是逐字比较；从未出现过的值不可能命中
+    const int id = StringPool::instance().findId(category);
+    if (id < 0) {
+        return QVector<Book>();
     }
 
-    return result;
+    return booksAt(store_.slotsWithCategory(id));
 }
 
 QVector<Book> DatabaseManager::getBooksByLocation(const QString& location)
 {
-    QVector<Book> result;
-
-    for (const Book& book : books_) {
-        if (book.location == location) {
-            result.append(book);
-        }
+    // 比较驻留编号而不是逐字比较；从未出现过的值不可能命中
+    const int id = StringPool::instance().findId(location);
+    if (id < 0) {
+        return QVector<Book>();
     }
 
+    return booksAt(store_.slotsWithLocation(id));
+}
+
+QVector<Book> DatabaseManager::booksAt(const QVector<int>& slotList) const
+{
+    QVector<Book> result;
+    result.reserve(slotList.size());
+    for (int slot : slotList) {
+        result.append(*store_.bookAt(slot));
+    }
     return result;
 }
 
 int DatabaseManager::getTotalBookCount()
 {
-    return books_.size();
+    return slotById_.size();
 }
 
 double DatabaseManager::getTotalInventoryValue()
 {
-    double total = 0.0;
-    for (const Book& book : books_) {
-        total += book.price;
-    }
-    return total;
+    // 只扫描连续的价格列，墓碑价格为0
+    return store_.totalPrice();
 }
 
 bool DatabaseManager::exportToJson(const QString& filePath)
@@ -349,7 +667,10 @@ bool DatabaseManager::exportToJson(const QString& filePath)
     BookCopyManager &copyManager = BookCopyManager::instance();
     QJsonArray jsonArray;
 
-    for (const Book &book : books_) {
+    for (const Book &book : store_.books()) {
+        if (book.indexId.isEmpty()) {
+            continue;
+        }
         QJsonObject bookObj = bookToJson(book);
 
         // 获取该图书的所有副本信息
@@ -370,11 +691,11 @@ bool DatabaseManager::exportToJson(const QString& filePath)
     file.write(doc.toJson(QJsonDocument::Indented));
     file.close();
 
-    qDebug() << "Exported" << books_.size() << "books with copies to" << filePath;
+    qDebug() << "Exported" << slotById_.size() << "books with copies to" << filePath;
     return true;
 }
 
-bool DatabaseManager::importFromJson(const QString& filePath)
+bool DatabaseManager::importFromJson(const QString& filePath, const ImportProgress &progress)
 {
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -382,70 +703,65 @@ bool DatabaseManager::importFromJson(const QString& filePath)
         return false;
     }
 
-    QByteArray data = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (!doc.isArray()) {
-        qDebug() << "Invalid import file format: expected JSON array";
-        return false;
+    const qint64 totalBytes = file.size();
+    const qint64 progressStep = std::max<qint64>(totalBytes / 200, 64 * 1024);
+    qint64 lastReported = 0;
+    if (progress) {
+        progress(0, totalBytes);
     }
 
+    // 逐条读取数组元素，不构建整个文件的DOM；索引号查重走slotById_哈希表。
+    // 副本攒满一批就插入副本存储，暂存的副本数与文件大小无关
+    const int copyBatchSize = 4096;
     BookCopyManager &copyManager = BookCopyManager::instance();
-    QVector<Book> importedBooks;
-    QJsonArray jsonArray = doc.array();
-
-    for (const QJsonValue &value : jsonArray) {
+    JsonArrayReader reader(&file);
+    QVector<BookCopy> importedCopies;
+    importedCopies.reserve(copyBatchSize);
+    int addedCount = 0;
+    int copyCount = 0;
+    QJsonValue value;
+    while (reader.readNext(value)) {
         if (value.isObject()) {
-            QJsonObject bookObj = value.toObject();
-
-            // 导入图书基本信息
-            Book book = bookFromJson(bookObj);
-            importedBooks.append(book);
-
-            // 检查是否有副本信息
-            if (bookObj.contains("copies") && bookObj["copies"].isArray()) {
-                QJsonArray copiesArray = bookObj["copies"].toArray();
-
-                // 导入副本信息
-                for (const QJsonValue &copyValue : copiesArray) {
-                    if (copyValue.isObject()) {
-                        BookCopy copy = BookCopy::fromJson(copyValue.toObject());
-
-                        // 检查副本是否已存在，如果不存在则添加
-                        BookCopy existingCopy = copyManager.getCopyById(copy.copyId);
-                        if (existingCopy.copyId.isEmpty()) {
-                            copyManager.addCopy(copy);
-                            qDebug() << "Imported copy:" << copy.copyId << "for book:" << book.indexId;
-                        }
-                    }
-                }
+            const QJsonObject bookObj = value.toObject();
+
+            // 导入图书基本信息（跳过重复的indexId）
+            const Book book = bookFromJson(bookObj);
+            if (!book.indexId.isEmpty() && !slotById_.contains(book.indexId)) {
+                insertBook(book);
+                addedCount++;
             }
-        }
-    }
 
-    // 添加到现有数据库（跳过重复的indexId）
-    int addedCount = 0;
-    for (const Book& book : importedBooks) {
-        bool exists = false;
-        for (const Book& existingBook : books_) {
-            if (existingBook.indexId == book.indexId) {
-                exists = true;
-                break;
+            const QJsonArray copiesArray = bookObj.value("copies").toArray();
+            for (const QJsonValue &copyValue : copiesArray) {
+                if (copyValue.isObject()) {
+                    importedCopies.append(BookCopy::fromJson(copyValue.toObject()));
+                }
+            }
+            if (importedCopies.size() >= copyBatchSize) {
+                copyCount += copyManager.addCopies(importedCopies, false);
+                importedCopies.clear();
             }
         }
 
-        if (!exists) {
-            books_.append(book);
-            addedCount++;
-            qDebug() << "Imported book:" << book.indexId << "with borrow count:" << book.borrowCount;
+        if (progress && reader.bytesConsumed() - lastReported >= progressStep) {
+            lastReported = reader.bytesConsumed();
+            progress(lastReported, totalBytes);
         }
     }
-
-    if (saveToFile()) {
-        qDebug() << "Imported" << addedCount << "new books from" << filePath;
-        return true;
+    file.close();
+    if (progress) {
+        progress(totalBytes, totalBytes);
     }
 
-    return false;
+    // 最后一批副本插入后副本和图书各写一次检查点，不逐条记日志。
+    // 解析中途出错时已读到的记录同样保存，保持内存与文件一致
+    copyCount += copyManager.addCopies(importedCopies, false);
+    const bool saved = (copyCount == 0 || copyManager.checkpoint()) && checkpoint();
+    qDebug() << "Imported" << addedCount << "new books and" << copyCount << "new copies from" << filePath;
+
+    if (reader.hasError()) {
+        qDebug() << "Import stopped early:" << reader.errorString();
+        return false;
+    }
+    return saved;
 }
@@ -4,12 +4,17 @@
 
 #include <QObject>
 #include <QVector>
+#include <QHash>
 #include <QString>
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
 #include "book.h"
+#include "journal.h"
+#include "bookstore.h"
+#include "sortindex.h"
+#include <functional>
 
 class DatabaseManager : public QObject
 {
@@ -22,13 +27,35 @@ public:
     bool initializeDatabase();
     bool isDatabaseReady() const;
     QString getDatabasePath() const;
+    // 启动时加载失败的说明（原文件已改名保存或无法移开），正常加载时为空
+    QString loadError() const;
 
     // 图书相关操作
     bool addBook(const Book& book);
     bool updateBook(const Book& book);
     bool removeBook(const QString& indexId);
-    QVector<Book> getAllBooks();
+    QVector<Book> getAllBooks() const;
     Book getBookByIndexId(const QString& indexId);
+    // O(1)按索引号查找，返回指向内部存储的指针，未找到返回nullptr
+    // 指针在下一次添加图书之前有效
+    const Book* findBook(const QString& indexId) const;
+    // 槽位访问：删除的图书只留下墓碑，其余图书的槽位号在本次运行期间保持不变
+    int slotOf(const QString& indexId) const;
+    const Book* bookAt(int slot) const;
+    int slotCount() const;
+    // 类别/馆藏地址的驻留编号（见StringPool），筛选时比较编号即可；墓碑槽位为0
+    int categoryIdAt(int slot) const;
+    int locationIdAt(int slot) const;
+    // 热数据列访问（见BookStore），slot须为有效槽位
+    int borrowCountAt(int slot) const;
+    double priceAt(int slot) const;
+    // 排序索引（见SortIndex）：全部有效槽位按key排好序，取前k本或某一页直接截取
+    QVector<int> slotsOrderedBy(SortIndex::Key key, int offset = 0, int limit = -1) const;
+    // 按key稳定排序给定的槽位，同值时保持原有顺序
+    void sortSlotsBy(SortIndex::Key key, QVector<int> &slotList) const;
+    // 馆藏地址/类别驻留编号 -> 图书种数
+    QVector<int> bookCountByLocationId() const;
+    QVector<int> bookCountByCategoryId() const;
     QVector<Book> searchBooks(const QString& keyword);
   QVector<Book> fuzzySearchByName(const QString& keyword);
   QVector<Book> fuzzySearchByIndexId(const QString& keyword);
@@ -40,8 +67,24 @@ public:
     double getTotalInventoryValue();
 
     // 数据导入导出
+    // 导入进度回调：已处理字节数 / 文件总字节数
+    using ImportProgress = std::function<void(qint64 bytesRead, qint64 totalBytes)>;
     bool exportToJson(const QString& filePath);
-    bool importFromJson(const QString& filePath);
+    // 流式导入：逐条解析数组元素，内存占用与文件大小无关；跳过已存在的索引号和副本号，
+    // 图书和副本各只在结束时写一次检查点
+    bool importFromJson(const QString& filePath, const ImportProgress &progress = ImportProgress());
+
+    // 检查点：把内存数据写成完整快照并清空变更日志
+    bool checkpoint();
+    // 日志累计记录数或字节数超过阈值时自动触发检查点
+    void setCheckpointThresholds(int maxRecords, qint64 maxBytes);
+    // 检查点快照格式：默认写JSON快照，开启后写二进制列式快照（见CatalogSnapshot）
+    void setBinarySnapshotEnabled(bool enabled);
+    bool isBinarySnapshotEnabled() const;
+
+public slots:
+    // 程序退出前（QCoreApplication::aboutToQuit）调用：日志非空时写检查点
+    void shutdown();
 
 private:
     explicit DatabaseManager(QObject *parent = nullptr);
@@ -51,13 +94,33 @@ private:
 
     bool loadFromFile();
     bool saveToFile();
+    bool loadJsonSnapshot();
+    bool saveJsonSnapshot();
+    void applyJournalRecord(const QJsonObject& record);
+    bool logMutation(const QJsonObject& record);
+    void clearBooks();
+    int insertBook(const Book& book);
+    void replaceBook(int slot, const Book& book);
+    static Book internedBook(const Book& book);
+    void eraseSlot(int slot);
+    // 按槽位顺序取出图书副本，slotList须全部为有效槽位
+    QVector<Book> booksAt(const QVector<int>& slotList) const;
     Book bookFromJson(const QJsonObject& obj);
     QJsonObject bookToJson(const Book& book);
 
 private:
-    QVector<Book> books_;
-    QString dbFilePath_;
+    BookStore store_;              // 图书槽位，已删除的槽位为墓碑（indexId为空）
+    mutable SortIndex sortIndex_;  // 各排序方式的有序槽位表，按需建立、读取时合并改动
+    QHash<QString, int> slotById_; // indexId -> 槽位
+    int tombstoneCount_;
+    QString dbFilePath_;           // JSON快照，没有二进制快照时用于迁移
+    QString snapshotFilePath_;     // 二进制列式快照
+    bool binarySnapshot_;
+    Journal journal_;              // 变更日志，快照之后的所有修改都追加在这里
+    int checkpointMaxRecords_;
+    qint64 checkpointMaxBytes_;
     bool isInitialized_;
+    QString loadError_;
 };
 
 #endif // DATABASEMANAGER_H
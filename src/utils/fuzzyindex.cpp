@@ -0,0 +1,294 @@
+// fuzzyindex.cpp
+#include "fuzzyindex.h"
+#include "searchindex.h"
+#include <QVarLengthArray>
+#include <algorithm>
+
+namespace {
+
+bool isAsciiWordChar(QChar ch)
+{
+    return ch.unicode() < 0x80 && ch.isLetterOrNumber();
+}
+
+} // namespace
+
+void FuzzyIndex::clear()
+{
+    words_.clear();
+    wordIds_.clear();
+    trigramWords_.clear();
+}
+
+bool FuzzyIndex::isEmpty() const
+{
+    return wordIds_.isEmpty();
+}
+
+int FuzzyIndex::maxEditsFor(int length)
+{
+    if (length <= 3) {
+        return 0;
+    }
+    return length <= 7 ? 1 : 2;
+}
+
+QStringList FuzzyIndex::words(const QString &text)
+{
+    QStringList result;
+    int start = -1;
+    for (int i = 0; i <= text.size(); ++i) {
+        const bool inWord = i < text.size() && isAsciiWordChar(text[i]);
+        if (inWord && start < 0) {
+            start = i;
+        } else if (!inWord && start >= 0) {
+            result.append(text.mid(start, i - start).toLower());
+            start = -1;
+        }
+    }
+    return result;
+}
+
+QVector<quint32> FuzzyIndex::trigramsOf(const QString &word)
+{
+    // 首尾各补一个'$'，每个三元组的三个ASCII字符压成一个整数；结果去重
+    const QString padded = QLatin1Char('$') + word + QLatin1Char('$');
+    QVector<quint32> grams;
+    grams.reserve(padded.size());
+    for (int i = 0; i + 2 < padded.size(); ++i) {
+        grams.append((quint32(padded[i].unicode()) << 16) |
+                     (quint32(padded[i + 1].unicode()) << 8) |
+                     quint32(padded[i + 2].unicode()));
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+int FuzzyIndex::boundedDistance(const QString &a, const QString &b, int maxDistance)
+{
+    const int la = a.size();
+    const int lb = b.size();
+    const int over = maxDistance + 1;
+    if (qAbs(la - lb) > maxDistance) {
+        return over;
+    }
+
+    // 只计算主对角线两侧maxDistance宽的带，带外视为超限
+    QVarLengthArray<int, 64> rowA(lb + 1);
+    QVarLengthArray<int, 64> rowB(lb + 1);
+    int *prev = rowA.data();
+    int *cur = rowB.data();
+    for (int j = 0; j <= lb; ++j) {
+        prev[j] = j <= maxDistance ? j : over;
+    }
+
+    for (int i = 1; i <= la; ++i) {
+        const int from = std::max(1, i - maxDistance);
+        const int to = std::min(lb, i + maxDistance);
+
+        cur[0] = i <= maxDistance ? i : over;
+        if (from > 1) {
+            cur[from - 1] = over;
+        }
+        int rowMin = from == 1 ? cur[0] : over;
+
+        for (int j = from; j <= to; ++j) {
+            const int cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            int v = std::min({ prev[j - 1] + cost, prev[j] + 1, cur[j - 1] + 1 });
+            v = std::min(v, over);
+            cur[j] = v;
+            rowMin = std::min(rowMin, v);
+        }
+        if (to < lb) {
+            cur[to + 1] = over;
+        }
+        if (rowMin > maxDistance) {
+            return over;
+        }
+        std::swap(prev, cur);
+    }
+    return std::min(prev[lb], over);
+}
+
+QHash<QString, int> FuzzyIndex::collectWords(const Book &book) const
+{
+    QHash<QString, int> wordFields;
+    const QStringList nameWords = words(book.name);
+    for (const QString &w : nameWords) {
+        wordFields[w] |= SearchIndex::NameField;
+    }
+    const QStringList authorWords = words(book.author);
+    for (const QString &w : authorWords) {
+        wordFields[w] |= SearchIndex::AuthorField;
+    }
+    return wordFields;
+}
+
+int FuzzyIndex::wordIdFor(const QString &text)
+{
+    auto it = wordIds_.constFind(text);
+    if (it != wordIds_.constEnd()) {
+        return it.value();
+    }
+
+    // 新词号总是最大的，直接追加即可保持三元组表有序
+    const int id = words_.size();
+    words_.append(Word{text, QVector<Posting>()});
+    wordIds_.insert(text, id);
+    const QVector<quint32> grams = trigramsOf(text);
+    for (quint32 g : grams) {
+        trigramWords_[g].append(id);
+    }
+    return id;
+}
+
+void FuzzyIndex::addBook(int slot, const Book &book)
+{
+    const QHash<QString, int> wordFields = collectWords(book);
+    for (auto it = wordFields.constBegin(); it != wordFields.constEnd(); ++it) {
+        QVector<Posting> &list = words_[wordIdFor(it.key())].postings;
+        auto pos = std::lower_bound(list.begin(), list.end(), slot,
+                                    [](const Posting &p, int s) { return p.slot < s; });
+        if (pos != list.end() && pos->slot == slot) {
+            pos->fields |= it.value();
+        } else {
+            list.insert(pos, Posting{slot, it.value()});
+        }
+    }
+}
+
+void FuzzyIndex::removeBook(int slot, const Book &book)
+{
+    // 词表项保留（倒排表可能为空），词号因此保持稳定
+    const QHash<QString, int> wordFields = collectWords(book);
+    for (auto it = wordFields.constBegin(); it != wordFields.constEnd(); ++it) {
+        const int id = wordIds_.value(it.key(), -1);
+        if (id < 0) {
+            continue;
+        }
+        QVector<Posting> &list = words_[id].postings;
+        auto pos = std::lower_bound(list.begin(), list.end(), slot,
+                                    [](const Posting &p, int s) { return p.slot < s; });
+        if (pos != list.end() && pos->slot == slot) {
+            list.erase(pos);
+        }
+    }
+}
+
+void FuzzyIndex::updateBook(int slot, const Book &oldBook, const Book &newBook)
+{
+    removeBook(slot, oldBook);
+    addBook(slot, newBook);
+}
+
+QVector<FuzzyIndex::Match> FuzzyIndex::search(const QString &query, int fieldMask) const
+{
+    QStringList terms = words(query);
+    terms.removeDuplicates();
+    if (terms.isEmpty() || words_.isEmpty()) {
+        return QVector<Match>();
+    }
+
+    QVector<quint8> shared(words_.size(), 0);
+    QVector<int> touched;
+    QHash<int, int> total;   // 槽位 -> 已匹配查询词的距离之和
+
+    for (int t = 0; t < terms.size(); ++t) {
+        const QString &term = terms[t];
+        const int maxEdits = maxEditsFor(term.size());
+
+        // 1. 候选词：完全匹配直接取；否则按共有三元组个数筛选
+        //    每处编辑最多破坏3个三元组，共有数少于 |Q| - 3k 的词不可能在k处编辑以内
+        QVector<int> candidates;
+        if (maxEdits == 0) {
+            const int id = wordIds_.value(term, -1);
+            if (id >= 0) {
+                candidates.append(id);
+            }
+        } else {
+            const QVector<quint32> grams = trigramsOf(term);
+            const int threshold = int(grams.size()) - 3 * maxEdits;
+            if (threshold <= 0) {
+                // 重复字母多的短词筛不动，退化为按长度过滤全部词表
+                for (int id = 0; id < words_.size(); ++id) {
+                    if (qAbs(words_[id].text.size() - term.size()) <= maxEdits) {
+                        candidates.append(id);
+                    }
+                }
+            } else {
+                touched.clear();
+                for (quint32 g : grams) {
+                    auto it = trigramWords_.constFind(g);
+                    if (it == trigramWords_.constEnd()) {
+                        continue;
+                    }
+                    for (int id : it.value()) {
+                        if (shared[id]++ == 0) {
+                            touched.append(id);
+                        }
+                    }
+                }
+                for (int id : std::as_const(touched)) {
+                    if (shared[id] >= threshold &&
+                        qAbs(words_[id].text.size() - term.size()) <= maxEdits) {
+                        candidates.append(id);
+                    }
+                    shared[id] = 0;
+                }
+            }
+        }
+
+        // 2. 编辑距离验证，每本书取该查询词的最小距离
+        QHash<int, int> termBest;
+        for (int id : std::as_const(candidates)) {
+            const Word &word = words_[id];
+            if (word.postings.isEmpty()) {
+                continue;
+            }
+            const int d = boundedDistance(term, word.text, maxEdits);
+            if (d > maxEdits) {
+                continue;
+            }
+            for (const Posting &p : word.postings) {
+                if (!(p.fields & fieldMask)) {
+                    continue;
+                }
+                auto it = termBest.find(p.slot);
+                if (it == termBest.end()) {
+                    termBest.insert(p.slot, d);
+                } else if (d < it.value()) {
+                    it.value() = d;
+                }
+            }
+        }
+
+        // 3. 与前面查询词的结果求交集
+        if (t == 0) {
+            total = termBest;
+        } else {
+            for (auto it = total.begin(); it != total.end();) {
+                auto hit = termBest.constFind(it.key());
+                if (hit == termBest.constEnd()) {
+                    it = total.erase(it);
+                } else {
+                    it.value() += hit.value();
+                    ++it;
+                }
+            }
+        }
+        if (total.isEmpty()) {
+            return QVector<Match>();
+        }
+    }
+
+    QVector<Match> result;
+    result.reserve(total.size());
+    for (auto it = total.constBegin(); it != total.constEnd(); ++it) {
+        result.append(Match{it.key(), it.value()});
+    }
+    std::sort(result.begin(), result.end(), [](const Match &a, const Match &b) {
+        return a.slot < b.slot;
+    });
+    return result;
+}
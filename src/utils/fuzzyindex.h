@@ -0,0 +1,62 @@
+// fuzzyindex.h
+#ifndef FUZZYINDEX_H
+#define FUZZYINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include "book.h"
+
+// 容错搜索索引：允许书名/作者中的拉丁单词有一两处拼写错误（如 Silberchatz、Alexnder）
+// - 书名和作者中的拉丁单词去重后组成词表，每个词带一张 (槽位, 字段) 倒排表
+// - 词表上再建三元组(trigram)索引，查询时先按共有三元组个数筛出候选词，
+//   再用限定带宽的编辑距离逐个验证
+// 允许的错误数随词长增加：3个字母以内必须完全一致，4~7个字母1处，8个字母以上2处。
+class FuzzyIndex
+{
+public:
+    struct Match {
+        int slot;
+        int distance;   // 各查询词编辑距离之和
+    };
+
+    void clear();
+    bool isEmpty() const;
+
+    // 增量维护：槽位号即DatabaseManager中的槽位
+    void addBook(int slot, const Book &book);
+    void removeBook(int slot, const Book &book);
+    void updateBook(int slot, const Book &oldBook, const Book &newBook);
+
+    // 查询中每个拉丁单词都要在同一本书中找到近似词；结果按槽位升序，排序交给调用方
+    QVector<Match> search(const QString &query, int fieldMask) const;
+
+    // 单词允许的最大编辑距离
+    static int maxEditsFor(int length);
+    // 限定上限的编辑距离：超过maxDistance时提前结束并返回maxDistance + 1
+    static int boundedDistance(const QString &a, const QString &b, int maxDistance);
+    // 切出小写的拉丁单词（字母数字连续段）
+    static QStringList words(const QString &text);
+
+private:
+    struct Posting {
+        int slot;
+        int fields;
+    };
+
+    struct Word {
+        QString text;
+        QVector<Posting> postings;   // 按槽位升序
+    };
+
+    static QVector<quint32> trigramsOf(const QString &word);
+    QHash<QString, int> collectWords(const Book &book) const;
+    int wordIdFor(const QString &text);
+
+    QVector<Word> words_;                         // 词表，词号一经分配不再变动
+    QHash<QString, int> wordIds_;                 // 词 -> 词号
+    QHash<quint32, QVector<int>> trigramWords_;   // 三元组 -> 含该三元组的词号（升序）
+};
+
+#endif // FUZZYINDEX_H
@@ -0,0 +1,234 @@
+// journal.cpp
+#include "journal.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonParseError>
+
+Journal::Journal(const QString &filePath)
+    : file_(filePath), pendingCount_(0), recordCount_(0)
+{
+}
+
+Journal::~Journal()
+{
+    commit();
+    close();
+}
+
+void Journal::setFilePath(const QString &filePath)
+{
+    close();
+    file_.setFileName(filePath);
+    pending_.clear();
+    pendingCount_ = 0;
+    recordCount_ = 0;
+}
+
+QString Journal::filePath() const
+{
+    return file_.fileName();
+}
+
+bool Journal::open()
+{
+    if (file_.isOpen()) {
+        return true;
+    }
+
+    if (!file_.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qDebug() << "Cannot open journal file for writing:" << file_.errorString();
+        return false;
+    }
+    return true;
+}
+
+void Journal::close()
+{
+    if (file_.isOpen()) {
+        file_.flush();
+        file_.close();
+    }
+}
+
+bool Journal::append(const QJsonObject &record)
+{
+    if (!open()) {
+        return false;
+    }
+
+    QByteArray line = QJsonDocument(record).toJson(QJsonDocument::Compact);
+    line.append('\n');
+
+    if (file_.write(line) != line.size() || !file_.flush()) {
+        qDebug() << "Failed to append journal record:" << file_.errorString();
+        return false;
+    }
+
+    ++recordCount_;
+    return true;
+}
+
+void Journal::enqueue(const QJsonObject &record)
+{
+    pending_.append(QJsonDocument(record).toJson(QJsonDocument::Compact));
+    pending_.append('\n');
+    ++pendingCount_;
+}
+
+bool Journal::commit()
+{
+    if (pendingCount_ == 0) {
+        return true;
+    }
+
+    if (!open()) {
+        return false;
+    }
+
+    if (file_.write(pending_) != pending_.size() || !file_.flush()) {
+        qDebug() << "Failed to commit journal records:" << file_.errorString();
+        return false;
+    }
+
+    recordCount_ += pendingCount_;
+    pending_.clear();
+    pendingCount_ = 0;
+    return true;
+}
+
+int Journal::pendingCount() const
+{
+    return pendingCount_;
+}
+
+bool Journal::rotate()
+{
+    if (!commit()) {
+        return false;
+    }
+    close();
+
+    const QString rotated = rotatedFilePath();
+    if (QFile::exists(rotated)) {
+        return false;
+    }
+
+    if (QFile::exists(file_.fileName()) && !QFile::rename(file_.fileName(), rotated)) {
+        qDebug() << "Cannot rotate journal file" << file_.fileName();
+        return false;
+    }
+
+    recordCount_ = 0;
+    return open();
+}
+
+void Journal::removeRotated()
+{
+    QFile::remove(rotatedFilePath());
+}
+
+QString Journal::rotatedFilePath() const
+{
+    return file_.fileName() + ".old";
+}
+
+bool Journal::hasRotated() const
+{
+    return QFile::exists(rotatedFilePath());
+}
+
+bool Journal::reset()
+{
+    close();
+    pending_.clear();
+    pendingCount_ = 0;
+
+    if (!file_.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "Cannot truncate journal file:" << file_.errorString();
+        return false;
+    }
+
+    removeRotated();
+    recordCount_ = 0;
+    return true;
+}
+
+int Journal::replay(const std::function<void(const QJsonObject &)> &apply)
+{
+    commit();
+    close();
+
+    // 先重放上次后台压缩未完成时留下的 .old 日志，再重放当前日志
+    const int rotatedCount = replayFile(rotatedFilePath(), apply);
+    if (rotatedCount < 0) {
+        return -1;
+    }
+
+    const int count = replayFile(file_.fileName(), apply);
+    if (count < 0) {
+        return -1;
+    }
+
+    recordCount_ = count;
+    return rotatedCount + count;
+}
+
+int Journal::replayFile(const QString &path, const std::function<void(const QJsonObject &)> &apply)
+{
+    QFile in(path);
+    if (!in.exists()) {
+        return 0;
+    }
+
+    if (!in.open(QIODevice::ReadOnly)) {
+        qDebug() << "Cannot open journal file for reading:" << in.errorString();
+        return -1;
+    }
+
+    int count = 0;
+    qint64 validSize = 0;
+    bool torn = false;
+
+    while (!in.atEnd()) {
+        const QByteArray line = in.readLine();
+        const QByteArray trimmed = line.trimmed();
+        if (trimmed.isEmpty()) {
+            validSize = in.pos();
+            continue;
+        }
+
+        QJsonParseError parseError;
+        const QJsonDocument doc = QJsonDocument::fromJson(trimmed, &parseError);
+        if (parseError.error != QJsonParseError::NoError || !doc.isObject() || !line.endsWith('\n')) {
+            torn = true;
+            break;
+        }
+
+        apply(doc.object());
+        ++count;
+        validSize = in.pos();
+    }
+    in.close();
+
+    // 丢弃末尾写了一半的记录，避免后续追加的记录与其拼接成一行
+    if (torn) {
+        qDebug() << "Journal" << path << "has a torn tail, truncating to" << validSize << "bytes";
+        QFile::resize(path, validSize);
+    }
+
+    return count;
+}
+
+int Journal::recordCount() const
+{
+    return recordCount_;
+}
+
+qint64 Journal::sizeInBytes() const
+{
+    if (file_.isOpen()) {
+        return file_.size();
+    }
+    return QFileInfo(file_.fileName()).size();
+}
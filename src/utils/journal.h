@@ -0,0 +1,66 @@
+// journal.h
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <QFile>
+#include <QString>
+#include <QJsonObject>
+#include <functional>
+
+// 追加式变更日志（WAL）
+// 每条变更以一行紧凑JSON追加到日志文件末尾，快照只在检查点时重写。
+// 启动时先加载快照，再按顺序重放日志，即可恢复到最后一次变更后的状态。
+// 记录应设计为幂等的（如 put/del），这样检查点中途崩溃后重复重放也不会出错。
+//
+// 支持两种写入方式：
+// - append(): 逐条写入并刷盘
+// - enqueue() + commit(): 组提交，多条记录合并成一次写入和一次刷盘
+// 后台压缩时先rotate()把当前日志改名为 .old，新记录写入新日志，
+// 快照写完后再removeRotated()；重放时先重放 .old 再重放当前日志。
+class Journal
+{
+public:
+    explicit Journal(const QString &filePath = QString());
+    ~Journal();
+
+    void setFilePath(const QString &filePath);
+    QString filePath() const;
+
+    // 以追加方式打开日志文件
+    bool open();
+    void close();
+
+    // 追加一条记录并立即刷盘
+    bool append(const QJsonObject &record);
+
+    // 组提交：先缓存记录，由commit()一次性写入并刷盘
+    void enqueue(const QJsonObject &record);
+    bool commit();
+    int pendingCount() const;
+
+    // 把当前日志轮转为 .old 文件并另起新日志；已存在 .old 时返回false
+    bool rotate();
+    void removeRotated();
+    QString rotatedFilePath() const;
+    bool hasRotated() const;
+
+    // 检查点完成后清空日志（包括轮转出的 .old 文件和未提交的缓存）
+    bool reset();
+
+    // 按写入顺序重放日志，返回成功重放的记录数，失败返回-1
+    // 末尾因崩溃而写了一半的记录会被丢弃并从文件中截掉
+    int replay(const std::function<void(const QJsonObject &)> &apply);
+
+    int recordCount() const;
+    qint64 sizeInBytes() const;
+
+private:
+    static int replayFile(const QString &path, const std::function<void(const QJsonObject &)> &apply);
+
+    QFile file_;
+    QByteArray pending_;       // 组提交缓存
+    int pendingCount_;
+    int recordCount_;
+};
+
+#endif // JOURNAL_H
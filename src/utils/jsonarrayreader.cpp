@@ -0,0 +1,197 @@
+// jsonarrayreader.cpp
+#include "jsonarrayreader.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonParseError>
+
+JsonArrayReader::JsonArrayReader(QIODevice *device, int chunkSize)
+    : device_(device)
+    , chunkSize_(chunkSize)
+    , pos_(0)
+    , bufferOffset_(0)
+    , started_(false)
+    , afterElement_(false)
+    , finished_(false)
+{
+}
+
+bool JsonArrayReader::readNext(QJsonValue &value)
+{
+    if (finished_ || hasError()) {
+        return false;
+    }
+
+    if (!started_) {
+        // 跳过UTF-8 BOM和前导空白，第一个有效字符必须是 '['
+        if (!skipWhitespace()) {
+            setError("Unexpected end of file: expected '['");
+            return false;
+        }
+        if (buffer_.mid(pos_, 3) == "\xEF\xBB\xBF") {
+            pos_ += 3;
+            if (!skipWhitespace()) {
+                setError("Unexpected end of file: expected '['");
+                return false;
+            }
+        }
+        if (buffer_.at(pos_) != '[') {
+            setError("Expected a JSON array");
+            return false;
+        }
+        ++pos_;
+        started_ = true;
+    }
+
+    // 第一个元素之前不能有逗号；之后每个元素前恰好一个逗号，逗号后面不能紧跟 ',' 或 ']'
+    if (!skipWhitespace()) {
+        setError("Unexpected end of file: unterminated array");
+        return false;
+    }
+    if (buffer_.at(pos_) == ']') {
+        ++pos_;
+        return finishArray();
+    }
+    if (afterElement_) {
+        if (buffer_.at(pos_) != ',') {
+            setError(QString("Expected ',' or ']' at offset %1").arg(bytesConsumed()));
+            return false;
+        }
+        ++pos_;
+        if (!skipWhitespace()) {
+            setError("Unexpected end of file: unterminated array");
+            return false;
+        }
+        if (buffer_.at(pos_) == ',' || buffer_.at(pos_) == ']') {
+            setError(QString("Expected an array element at offset %1").arg(bytesConsumed()));
+            return false;
+        }
+    } else if (buffer_.at(pos_) == ',') {
+        setError(QString("Expected an array element at offset %1").arg(bytesConsumed()));
+        return false;
+    }
+
+    // 扫描到深度为0处的 ',' 或 ']' 为止，即一个完整元素；块用完时读入下一块继续扫描
+    int scan = pos_;
+    int depth = 0;
+    bool inString = false;
+    bool escaped = false;
+    for (;;) {
+        if (scan >= buffer_.size()) {
+            // fill()会丢弃pos_之前已处理的部分，扫描位置随之平移
+            const int scanned = scan - pos_;
+            if (!fill()) {
+                setError("Unexpected end of file inside an array element");
+                return false;
+            }
+            scan = pos_ + scanned;
+            continue;
+        }
+
+        const char c = buffer_.at(scan);
+        if (inString) {
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == '"') {
+                inString = false;
+            }
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == '{' || c == '[') {
+            ++depth;
+        } else if (c == '}' || c == ']') {
+            if (depth == 0) {
+                break;
+            }
+            --depth;
+        } else if (c == ',' && depth == 0) {
+            break;
+        }
+        ++scan;
+    }
+
+    const int elementStart = pos_;
+    const QByteArray element = buffer_.mid(elementStart, scan - elementStart);
+    pos_ = scan;
+
+    // QJsonDocument只接受对象或数组作为顶层，包一层数组即可解析任意元素
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson("[" + element + "]", &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        setError(QString("Invalid array element at offset %1: %2")
+                     .arg(bufferOffset_ + elementStart)
+                     .arg(parseError.errorString()));
+        return false;
+    }
+    value = doc.array().at(0);
+    afterElement_ = true;
+    return true;
+}
+
+bool JsonArrayReader::hasError() const
+{
+    return !error_.isEmpty();
+}
+
+QString JsonArrayReader::errorString() const
+{
+    return error_;
+}
+
+qint64 JsonArrayReader::bytesConsumed() const
+{
+    return bufferOffset_ + pos_;
+}
+
+bool JsonArrayReader::finishArray()
+{
+    // 结尾的 ']' 之后只允许空白
+    finished_ = true;
+    if (skipWhitespace()) {
+        setError(QString("Trailing data after JSON array at offset %1").arg(bytesConsumed()));
+    }
+    return false;
+}
+
+bool JsonArrayReader::fill()
+{
+    if (device_->atEnd()) {
+        return false;
+    }
+
+    // 丢弃已处理的前缀，缓冲区只保留当前元素未处理完的部分
+    if (pos_ > 0) {
+        buffer_.remove(0, pos_);
+        bufferOffset_ += pos_;
+        pos_ = 0;
+    }
+
+    const QByteArray chunk = device_->read(chunkSize_);
+    if (chunk.isEmpty()) {
+        return false;
+    }
+    buffer_.append(chunk);
+    return true;
+}
+
+bool JsonArrayReader::skipWhitespace()
+{
+    for (;;) {
+        while (pos_ < buffer_.size()) {
+            const char c = buffer_.at(pos_);
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+                return true;
+            }
+            ++pos_;
+        }
+        if (!fill()) {
+            return false;
+        }
+    }
+}
+
+void JsonArrayReader::setError(const QString &message)
+{
+    error_ = message;
+}
@@ -0,0 +1,46 @@
+// jsonarrayreader.h
+#ifndef JSONARRAYREADER_H
+#define JSONARRAYREADER_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QJsonValue>
+#include <QString>
+
+// 流式读取顶层为JSON数组的文件，每次返回一个数组元素
+// - 按块读取设备，只按括号深度和字符串状态切出一个完整元素，再单独解析这个元素，
+//   内存占用只与块大小和单个元素的大小有关，与文件大小无关
+// - 元素内部的格式错误由QJsonDocument报告；数组外层结构不完整（如文件被截断）、
+//   逗号缺失或多余、']' 之后还有非空白内容时hasError()为真
+class JsonArrayReader
+{
+public:
+    explicit JsonArrayReader(QIODevice *device, int chunkSize = 1024 * 1024);
+
+    // 读取下一个元素，数组结束或出错时返回false
+    bool readNext(QJsonValue &value);
+
+    bool hasError() const;
+    QString errorString() const;
+    // 已经解析完的字节数，可用于显示进度
+    qint64 bytesConsumed() const;
+
+private:
+    // 读到结尾的 ']' 之后调用，检查其后只剩空白；总是返回false
+    bool finishArray();
+    bool fill();
+    bool skipWhitespace();
+    void setError(const QString &message);
+
+    QIODevice *device_;
+    int chunkSize_;
+    QByteArray buffer_;
+    int pos_;                  // buffer_中下一个未处理的字节
+    qint64 bufferOffset_;      // buffer_[0]在文件中的偏移
+    bool started_;             // 已读到开头的 '['
+    bool afterElement_;        // 已读出至少一个元素，下一个元素前须有逗号
+    bool finished_;            // 已读到结尾的 ']'
+    QString error_;
+};
+
+#endif // JSONARRAYREADER_H
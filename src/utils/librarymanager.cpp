@@ -10,6 +10,8 @@
 
 #include "./databasemanager.h"
 #include "./bookcopymanager.h"
+#include "./stringpool.h"
+#include "./parallelscan.h"
 LibraryManager& LibraryManager::instance()
 {
     static LibraryManager instance;
@@ -20,10 +22,14 @@ LibraryManager::LibraryManager(QObject *parent)
     , dbManager_(DatabaseManager::instance())
     , copyManager_(BookCopyManager::instance())
 {
+    // 副本增删、借还都会通知增量变化，统计计数器据此更新
+    connect(&copyManager_, &BookCopyManager::copyCountsChanged,
+            this, &LibraryManager::onCopyCountsChanged);
+
     loadFromDatabase();
 
-    // 如果数据库为空，自动导入示例数据
-    if (books_.isEmpty()) {
+    // 如果数据库为空，自动导入示例数据；加载失败后的空库不导入，以免与改名保存的原数据混在一起
+    if (dbManager_.getTotalBookCount() == 0 && dbManager_.loadError().isEmpty()) {
         importSampleData();
     }
 };
@@ -31,7 +37,28 @@ LibraryManager::LibraryManager(QObject *parent)
 
 void LibraryManager::clear()
 {
-    books_.clear();
+    stats_ = LibraryStats();
+    searchIndex_.clear();
+    pinyinIndex_.clear();
+    fuzzyIndex_.clear();
+}
+
+void LibraryManager::rebuildSearchIndex()
+{
+    searchIndex_.clear();
+    fuzzyIndex_.clear();
+
+    // 直接引用存储中的图书，不另存副本
+    QVector<QPair<int, const Book *>> indexed;
+    indexed.reserve(dbManager_.getTotalBookCount());
+    for (int slot = 0; slot < dbManager_.slotCount(); ++slot) {
+        if (const Book *book = dbManager_.bookAt(slot)) {
+            searchIndex_.addBook(slot, *book);
+            fuzzyIndex_.addBook(slot, *book);
+            indexed.append(qMakePair(slot, book));
+        }
+    }
+    pinyinIndex_.build(indexed);
 }
 
 // --- 数据操作 ---
@@ -41,7 +68,7 @@ void LibraryManager::clear()
  * 功能流程：
  * 1. 重复检查：检查索引号是否已存在，确保唯一性
  * 2. 数据库操作：将图书信息保存到数据库
- * 3. 内存更新：将图书信息添加到内存中的books_向量
+ * 3. 索引更新：图书只存放在DatabaseManager中，这里更新统计和搜索索引
  * 4. 副本创建：为新添加的图书创建一个默认副本
  * 5. 信号发送：发送dataChanged信号，通知UI更新
  *
@@ -69,8 +96,12 @@ bool LibraryManager::addBook(const Book &book, QString *error)
         return false;
     }
 
-    // 内存更新：更新运行时数据
-    books_.append(book);
+    // 索引更新：图书本身只存放在DatabaseManager中，这里只更新统计和搜索索引
+    adjustBookStats(book, 0, 1.0);
+    const int slot = dbManager_.slotOf(book.indexId);
+    searchIndex_.addBook(slot, book);
+    pinyinIndex_.addBook(slot, book);
+    fuzzyIndex_.addBook(slot, book);
 
     // 副本创建：为新图书创建默认副本（副本1）
     BookCopy copy;
@@ -86,26 +117,37 @@ bool LibraryManager::addBook(const Book &book, QString *error)
 
 bool LibraryManager::updateBook(const QString &indexId, const Book &updatedBook, QString *error)
 {
-    for (int i = 0; i < books_.size(); ++i) {
-        if (books_[i].indexId == indexId) {
-            if (books_[i].indexId != updatedBook.indexId && findByIndexId(updatedBook.indexId)) {
-                if (error) *error = QStringLiteral("新索引号 '%1' 已存在").arg(updatedBook.indexId);
-                return false;
-            }
+    const Book *existing = findByIndexId(indexId);
+    if (!existing) {
+        if (error) *error = QStringLiteral("未找到索引号为 '%1' 的图书").arg(indexId);
+        return false;
+    }
+    // 存储中的记录会被覆盖，先留一份旧值用于扣减统计和索引（字段隐式共享，不复制文本）
+    const Book oldBook = *existing;
 
-            if (!dbManager_.updateBook(updatedBook)) {
-                if (error) *error = QStringLiteral("数据库更新失败");
-                return false;
-            }
+    if (indexId != updatedBook.indexId && findByIndexId(updatedBook.indexId)) {
+        if (error) *error = QStringLiteral("新索引号 '%1' 已存在").arg(updatedBook.indexId);
+        return false;
+    }
 
-            books_[i] = updatedBook;
-            emit dataChanged();
-            return true;
-        }
+    if (!dbManager_.updateBook(updatedBook)) {
+        if (error) *error = QStringLiteral("数据库更新失败");
+        return false;
     }
 
-    if (error) *error = QStringLiteral("未找到索引号为 '%1' 的图书").arg(indexId);
-    return false;
+    // 分类/位置变化时把该书的副本数从旧分组移到新分组
+    const int copyCount = copyManager_.getTotalCopyCount(indexId);
+    adjustBookStats(oldBook, -copyCount, -1.0);
+    adjustBookStats(updatedBook, copyCount, 1.0);
+
+    // 只重新索引这一本书
+    const int slot = dbManager_.slotOf(updatedBook.indexId);
+    searchIndex_.updateBook(slot, oldBook, updatedBook);
+    pinyinIndex_.updateBook(slot, oldBook, updatedBook);
+    fuzzyIndex_.updateBook(slot, oldBook, updatedBook);
+
+    emit dataChanged();
+    return true;
 }
 
 bool LibraryManager::removeBookByIndexId(const QString &indexId)
@@ -123,55 +165,283 @@ bool LibraryManager::removeBookByIndexId(const QString &indexId)
         copyManager_.removeCopy(copy.copyId);
     }
 
+    // 槽位号和记录在删除后失效，需先记下以便从统计和索引中移除；
+    // 删除只留下墓碑，其余图书的槽位号不变，各索引无需逐项重编
+    const int slot = dbManager_.slotOf(indexId);
+    if (slot < 0) {
+        return false;
+    }
+    const Book removed = *dbManager_.bookAt(slot);
     if (!dbManager_.removeBook(indexId)) {
         return false;
     }
 
-    for (int i = 0; i < books_.size(); ++i) {
-        if (books_[i].indexId == indexId) {
-            books_.removeAt(i);
-            emit dataChanged();
-            return true;
-        }
-    }
-    return false;
+    // 副本已在上面删除，分组计数已随副本信号扣减，这里只扣减种类和价值
+    adjustBookStats(removed, 0, -1.0);
+    searchIndex_.removeBook(slot, removed);
+    pinyinIndex_.removeBook(slot, removed);
+    fuzzyIndex_.removeBook(slot, removed);
+
+    emit dataChanged();
+    return true;
 }
 
 const Book* LibraryManager::findByIndexId(const QString &indexId) const
 {
-    auto it = std::find_if(books_.begin(), books_.end(), [&](const Book& b) {
-        return b.indexId == indexId;
-    });
-    return (it != books_.end()) ? &(*it) : nullptr;
+    return dbManager_.findBook(indexId);
 }
 
 const Book* LibraryManager::findByName(const QString &name) const
 {
-    auto it = std::find_if(books_.begin(), books_.end(), [&](const Book& b) {
-        return b.name == name;
-    });
-    return (it != books_.end()) ? &(*it) : nullptr;
+    for (int slot = 0; slot < dbManager_.slotCount(); ++slot) {
+        const Book *book = dbManager_.bookAt(slot);
+        if (book && book->name == name) {
+            return book;
+        }
+    }
+    return nullptr;
 }
 
 // --- 数据获取 ---
-const QVector<Book>& LibraryManager::getAll() const
+QVector<Book> LibraryManager::getAll() const
 {
-    return books_;
+    return dbManager_.getAllBooks();
 }
 
-QVector<Book> LibraryManager::getByCategory(const QString &category) const
+QVector<Book> LibraryManager::getPage(int offset, int limit) const
 {
-    return dbManager_.getBooksByCategory(category);
+    LibraryQuery q;
+    q.offset = offset;
+    q.limit = limit;
+    return booksAt(query(q));
 }
 
-QVector<Book> LibraryManager::getByLocation(const QString &location) const
+QVector<Book> LibraryManager::booksAt(const QVector<int> &slotList) const
 {
-    return dbManager_.getBooksByLocation(location);
+    QVector<Book> result;
+    result.reserve(slotList.size());
+    for (int slot : slotList) {
+        if (const Book *book = dbManager_.bookAt(slot)) {
+            result.append(*book);
+        }
+    }
+    return result;
 }
 
-QVector<Book> LibraryManager::searchBooks(const QString &keyword) const
+int LibraryManager::count(const LibraryQuery &q) const
 {
-    return dbManager_.searchBooks(keyword);
+    LibraryQuery countQuery = q;
+    countQuery.sort = LibraryQuery::SourceOrder;
+    countQuery.offset = 0;
+    countQuery.limit = -1;
+    return query(countQuery).size();
+}
+
+QStringList LibraryManager::getCategories() const
+{
+    const QVector<int> counts = dbManager_.bookCountByCategoryId();
+    StringPool &pool = StringPool::instance();
+
+    QVector<int> ids;
+    for (int id = 1; id < counts.size(); ++id) {   // 编号0为空字符串
+        if (counts[id] > 0) {
+            ids.append(id);
+        }
+    }
+
+    // 按缓存的区域排序名次排序，只比较整数
+    const QVector<int> &ranks = pool.collationRanks();
+    std::sort(ids.begin(), ids.end(), [&ranks](int a, int b) { return ranks[a] < ranks[b]; });
+
+    QStringList result;
+    result.reserve(ids.size());
+    for (int id : std::as_const(ids)) {
+        result.append(pool.stringOf(id));
+    }
+    return result;
+}
+
+QVector<Book> LibraryManager::getByCategory(const QString &category, int offset, int limit) const
+{
+    LibraryQuery q;
+    q.category = category;
+    q.offset = offset;
+    q.limit = limit;
+    return booksAt(query(q));
+}
+
+QVector<Book> LibraryManager::getByLocation(const QString &location, int offset, int limit) const
+{
+    LibraryQuery q;
+    q.location = location;
+    q.offset = offset;
+    q.limit = limit;
+    return booksAt(query(q));
+}
+
+QVector<Book> LibraryManager::searchBooks(const QString &keyword, int offset, int limit) const
+{
+    // 相关度顺序来自索引，只为请求的那一页复制图书
+    LibraryQuery q;
+    q.setCandidates(searchSlots(keyword));
+    q.offset = offset;
+    q.limit = limit;
+    return booksAt(query(q));
+}
+
+QVector<int> LibraryManager::searchSlots(const QString &keyword, int fieldMask) const
+{
+    return searchIndex_.search(keyword, fieldMask);
+}
+
+QVector<int> LibraryManager::searchPinyinSlots(const QString &keyword, int fieldMask) const
+{
+    return pinyinIndex_.search(keyword, fieldMask);
+}
+
+QVector<int> LibraryManager::searchFuzzySlots(const QString &keyword, int fieldMask) const
+{
+    return rankFuzzyMatches(fuzzyIndex_.search(keyword, fieldMask));
+}
+
+QVector<int> LibraryManager::rankFuzzyMatches(QVector<FuzzyIndex::Match> matches) const
+{
+    // 编辑距离小的在前，距离相同时热门图书在前（借阅次数取自热数据列，墓碑为0）
+    std::stable_sort(matches.begin(), matches.end(),
+                     [this](const FuzzyIndex::Match &a, const FuzzyIndex::Match &b) {
+        if (a.distance != b.distance) {
+            return a.distance < b.distance;
+        }
+        return dbManager_.borrowCountAt(a.slot) > dbManager_.borrowCountAt(b.slot);
+    });
+
+    QVector<int> result;
+    result.reserve(matches.size());
+    for (const FuzzyIndex::Match &m : std::as_const(matches)) {
+        result.append(m.slot);
+    }
+    return result;
+}
+
+SortIndex::Key LibraryManager::sortKeyFor(LibraryQuery::Sort sort)
+{
+    switch (sort) {
+    case LibraryQuery::ByPrice:
+        return SortIndex::PriceKey;
+    case LibraryQuery::ByInDate:
+        return SortIndex::InDateKey;
+    case LibraryQuery::ByName:
+        return SortIndex::NameKey;
+    case LibraryQuery::ByCategory:
+        return SortIndex::CategoryKey;
+    case LibraryQuery::ByLocation:
+        return SortIndex::LocationKey;
+    default:
+        return SortIndex::BorrowCountKey;
+    }
+}
+
+QVector<int> LibraryManager::query(const LibraryQuery &q) const
+{
+    // 筛选值换成驻留编号；从未出现过的值不可能命中，直接返回空结果
+    const StringPool &pool = StringPool::instance();
+    const int categoryId = q.category.isEmpty() ? 0 : pool.findId(q.category);
+    const int locationId = q.location.isEmpty() ? 0 : pool.findId(q.location);
+    if (categoryId < 0 || locationId < 0) {
+        return QVector<int>();
+    }
+
+    // 执行计划：
+    // 1. 等值条件只读一个整数列，代价最低；两个都给出时按馆藏统计估计命中数，少的先判
+    // 2. 可借状态要按索引号查两次副本计数，只对通过等值条件的行求值
+    // 3. 自定义谓词代价未知，放在最后
+    const bool byCategory = !q.category.isEmpty();
+    const bool byLocation = !q.location.isEmpty();
+    const bool categoryFirst = !byLocation ||
+        (byCategory && stats_.copiesByCategory.value(q.category) <= stats_.copiesByLocation.value(q.location));
+
+    const DatabaseManager &db = dbManager_;
+    const BookCopyManager &copies = copyManager_;
+    auto accept = [&](int slot) {
+        const Book *book = db.bookAt(slot);
+        if (!book) {
+            return false;
+        }
+        if (categoryFirst) {
+            if (byCategory && db.categoryIdAt(slot) != categoryId) {
+                return false;
+            }
+            if (byLocation && db.locationIdAt(slot) != locationId) {
+                return false;
+            }
+        } else {
+            if (db.locationIdAt(slot) != locationId) {
+                return false;
+            }
+            if (byCategory && db.categoryIdAt(slot) != categoryId) {
+                return false;
+            }
+        }
+        if (q.status == LibraryQuery::Available && copies.getAvailableCopyCount(book->indexId) <= 0) {
+            return false;
+        }
+        if (q.status == LibraryQuery::Borrowed &&
+            copies.getAvailableCopyCount(book->indexId) >= copies.getTotalCopyCount(book->indexId)) {
+            return false;
+        }
+        return !q.predicate || q.predicate(slot);
+    };
+
+    // 扫描来源：候选集、排序索引（已排好序，无需再排）或全部槽位
+    const bool sorted = q.sort != LibraryQuery::SourceOrder;
+    const SortIndex::Key sortKey = sortKeyFor(q.sort);
+    QVector<int> source;
+    if (q.restrictToCandidates) {
+        source = q.candidates;
+    } else if (sorted) {
+        source = db.slotsOrderedBy(sortKey);
+    }
+    const bool identity = !q.restrictToCandidates && !sorted;
+    const bool needsSort = sorted && q.restrictToCandidates;
+
+    const int sourceCount = identity ? db.slotCount() : source.size();
+    const int *sourceSlots = source.constData();
+    auto slotAt = [&](int i) { return identity ? i : sourceSlots[i]; };
+
+    QVector<int> result;
+    if (!needsSort && q.limit >= 0) {
+        // 来源已是最终顺序的分页查询按顺序求值，凑够一页就停（前k本为O(k)）
+        int skipped = 0;
+        for (int i = 0; i < sourceCount && result.size() < q.limit; ++i) {
+            const int slot = slotAt(i);
+            if (accept(slot) && skipped++ >= q.offset) {
+                result.append(slot);
+            }
+        }
+        return result;
+    }
+
+    // 其余情况分块并行求值，结果保持来源顺序
+    const QVector<int> hits = ParallelScan::instance().filter(sourceCount, [&](int i) {
+        return accept(slotAt(i));
+    });
+    if (identity) {
+        result = hits;
+    } else {
+        result.reserve(hits.size());
+        for (int i : hits) {
+            result.append(sourceSlots[i]);
+        }
+    }
+
+    if (needsSort) {
+        db.sortSlotsBy(sortKey, result);   // 只排候选集，同值时保持相关度顺序
+    }
+
+    if (q.offset > 0 || q.limit >= 0) {
+        result = result.mid(q.offset, q.limit);
+    }
+    return result;
 }
 
 QVector<Book> LibraryManager::getWarn(int days) const
@@ -301,10 +571,11 @@ bool LibraryManager::borrowBook(const QString &indexId, const QString &username,
     // 借阅操作：调用副本管理器执行具体的借阅操作
     if (copyManager_.borrowCopy(copy.copyId, username, dueDate)) {
         // 统计更新：更新图书的借阅次数
-        Book *book = const_cast<Book*>(findByIndexId(indexId));
-        if (book) {
-            book->borrowCount++;
-            dbManager_.updateBook(*book);  // 数据持久化
+        // 通过DatabaseManager更新，热数据列和排序索引随之更新
+        if (const Book *stored = findByIndexId(indexId)) {
+            Book book = *stored;
+            book.borrowCount++;
+            dbManager_.updateBook(book);  // 数据持久化
         }
         emit dataChanged();  // 通知UI更新
         return true;
@@ -417,37 +688,96 @@ QVector<BookCopy> LibraryManager::getDueSoonCopies(int days) const
 }
 
 // --- 统计信息 ---
+LibraryStats LibraryManager::stats() const
+{
+    return stats_;
+}
+
 int LibraryManager::getTotalBooks() const
 {
-    return dbManager_.getTotalBookCount();
+    return stats_.totalBooks;
 }
 
 int LibraryManager::getTotalCopies() const
 {
-    int total = 0;
-    for (const Book &book : books_) {
-        total += getTotalCopyCount(book.indexId);
-    }
-    return total;
+    return stats_.totalCopies;
 }
 
 int LibraryManager::getAvailableCopies() const
 {
-    int total = 0;
-    for (const Book &book : books_) {
-        total += getAvailableCopyCount(book.indexId);
-    }
-    return total;
+    return stats_.availableCopies;
 }
 
 int LibraryManager::getBorrowedCopies() const
 {
-    return getTotalCopies() - getAvailableCopies();
+    return stats_.borrowedCopies;
 }
 
 double LibraryManager::getTotalValue() const
 {
-    return dbManager_.getTotalInventoryValue();
+    return stats_.totalValue;
+}
+
+void LibraryManager::rebuildStats()
+{
+    stats_ = LibraryStats();
+    for (int slot = 0; slot < dbManager_.slotCount(); ++slot) {
+        const Book *bookPtr = dbManager_.bookAt(slot);
+        if (!bookPtr) {
+            continue;
+        }
+        const Book &book = *bookPtr;
+        const int total = copyManager_.getTotalCopyCount(book.indexId);
+        const int available = copyManager_.getAvailableCopyCount(book.indexId);
+        stats_.totalCopies += total;
+        stats_.availableCopies += available;
+        adjustBookStats(book, total, 1.0);
+    }
+    stats_.borrowedCopies = stats_.totalCopies - stats_.availableCopies;
+}
+
+void LibraryManager::adjustBookStats(const Book &book, int copyDelta, double valueSign)
+{
+    // valueSign为+1/-1时表示图书加入/移出统计，为0时只调整分组副本数
+    if (valueSign > 0) {
+        ++stats_.totalBooks;
+    } else if (valueSign < 0) {
+        --stats_.totalBooks;
+    }
+    stats_.totalValue += valueSign * book.price;
+
+    if (copyDelta == 0) {
+        return;
+    }
+
+    int &categoryCount = stats_.copiesByCategory[book.category];
+    categoryCount += copyDelta;
+    if (categoryCount <= 0) {
+        stats_.copiesByCategory.remove(book.category);
+    }
+
+    int &locationCount = stats_.copiesByLocation[book.location];
+    locationCount += copyDelta;
+    if (locationCount <= 0) {
+        stats_.copiesByLocation.remove(book.location);
+    }
+}
+
+void LibraryManager::onCopyCountsChanged(const QString &indexId, int totalDelta, int availableDelta)
+{
+    // 与rebuildStats()相同，只统计有对应图书的副本；
+    // 图书尚未载入（如导入过程中）时整体跳过，加载完成后会重建
+    const Book *book = findByIndexId(indexId);
+    if (!book) {
+        return;
+    }
+
+    stats_.totalCopies += totalDelta;
+    stats_.availableCopies += availableDelta;
+    stats_.borrowedCopies = stats_.totalCopies - stats_.availableCopies;
+    if (totalDelta != 0) {
+        adjustBookStats(*book, totalDelta, 0.0);
+    }
 }
 
 // QString LibraryManager::getMostPopularCategory() const
@@ -470,59 +800,30 @@ double LibraryManager::getTotalValue() const
 
 QString LibraryManager::getMostPopularLocation() const
 {
-    QHash<QString, int> locationCount;
-    for(const auto& b : books_) {
-        locationCount[b.location]++;
-    }
+    // 按驻留编号计数，只扫描馆藏地址编号列
+    const QVector<int> counts = dbManager_.bookCountByLocationId();
 
-    QString popular;
+    int popularId = -1;
     int maxCount = 0;
-    for(auto it = locationCount.constBegin(); it != locationCount.constEnd(); ++it) {
-        if (it.value() > maxCount) {
-            maxCount = it.value();
-            popular = it.key();
+    for (int id = 0; id < counts.size(); ++id) {
+        if (counts[id] > maxCount) {
+            maxCount = counts[id];
+            popularId = id;
         }
     }
-    return popular;
-}
-
-// // --- 排序 ---
-// void LibraryManager::sortByName()
-// {
-//     std::sort(books_.begin(), books_.end(), [](const Book&a, const Book&b){ return a.name < b.name; });
-// }
-//
-// void LibraryManager::sortByCategory()
-// {
-//     std::sort(books_.begin(), books_.end(), [](const Book&a, const Book&b){ return a.category < b.category; });
-// }
-//
-// void LibraryManager::sortByLocation()
-// {
-//     std::sort(books_.begin(), books_.end(), [](const Book&a, const Book&b){ return a.location < b.location; });
-// }
-//
-// void LibraryManager::sortByPrice()
-// {
-//     std::sort(books_.begin(), books_.end(), [](const Book&a, const Book&b){ return a.price > b.price; });
-// }
-//
-// void LibraryManager::sortByDate()
-// {
-//     std::sort(books_.begin(), books_.end(), [](const Book&a, const Book&b){ return a.inDate > b.inDate; });
-// }
-
-void LibraryManager::sortByBorrowCount()
-{
-    std::sort(books_.begin(), books_.end(), [](const Book&a, const Book&b){ return a.borrowCount > b.borrowCount; });
+    return popularId >= 0 ? StringPool::instance().stringOf(popularId) : QString();
 }
 
 bool LibraryManager::loadFromDatabase()
 {
-    books_ = dbManager_.getAllBooks();
-
     // 确保每本书都有副本，如果没有则创建默认副本
-    for (const Book& book : books_) {
+    // 补建副本不会增删图书，槽位号和指针在循环中保持有效
+    for (int slot = 0; slot < dbManager_.slotCount(); ++slot) {
+        const Book *bookPtr = dbManager_.bookAt(slot);
+        if (!bookPtr) {
+            continue;
+        }
+        const Book &book = *bookPtr;
         QVector<BookCopy> existingCopies = copyManager_.getCopiesByIndexId(book.indexId);
         if (existingCopies.isEmpty()) {
             // 没有副本，创建默认副本
@@ -540,6 +841,10 @@ bool LibraryManager::loadFromDatabase()
         }
     }
 
+    // 与存储保持一致：重启或重新导入后按当前数据重建计数器和搜索索引
+    rebuildStats();
+    rebuildSearchIndex();
+
     emit dataChanged();
     return true;
 }
@@ -621,12 +926,12 @@ bool LibraryManager::exportToJson(const QString& filePath)
     return dbManager_.exportToJson(filePath);
 }
 
-bool LibraryManager::importFromJson(const QString& filePath)
+bool LibraryManager::importFromJson(const QString& filePath, const DatabaseManager::ImportProgress &progress)
 {
-    if (dbManager_.importFromJson(filePath)) {
-        return loadFromDatabase();
-    }
-    return false;
+    const bool imported = dbManager_.importFromJson(filePath, progress);
+    // 解析中途出错时前面的记录已经导入，同样需要重建统计和索引
+    const bool reloaded = loadFromDatabase();
+    return imported && reloaded;
 }
 
 
@@ -18,9 +18,31 @@
 #include <QVector>
 #include <QHash>
 #include <QString>
+#include <QStringList>
 #include "book.h"
 #include "./databasemanager.h"
 #include "./bookcopymanager.h"
+#include "./searchindex.h"
+#include "./pinyinindex.h"
+#include "./fuzzyindex.h"
+#include "./libraryquery.h"
+
+/**
+ * @struct LibraryStats
+ * @brief 馆藏统计快照
+ *
+ * 由LibraryManager增量维护的计数器拷贝而来，获取代价为O(1)
+ * （分类/位置计数使用隐式共享的QHash）。
+ */
+struct LibraryStats {
+    int totalBooks = 0;                   ///< 图书种类数
+    int totalCopies = 0;                  ///< 副本总数（不含找不到对应图书的副本）
+    int availableCopies = 0;              ///< 可借副本数
+    int borrowedCopies = 0;               ///< 已借出副本数
+    double totalValue = 0.0;              ///< 馆藏总价值（各图书价格之和）
+    QHash<QString, int> copiesByCategory; ///< 分类 -> 副本数
+    QHash<QString, int> copiesByLocation; ///< 馆藏位置 -> 副本数
+};
 
 /**
  * @class LibraryManager
@@ -67,17 +89,6 @@ public:
      */
     static LibraryManager& instance();
 
-    /**
-     * @brief 构造函数
-     *
-     * 初始化图书馆管理器，建立与数据库管理器的连接，
-     * 加载现有的图书数据到内存缓存中。
-     *
-     * @param parent 父QObject指针，用于Qt对象树管理
-     * @note 构造函数通常由instance()方法自动调用
-     */
-    explicit LibraryManager(QObject *parent = nullptr);
-
     /**
      * @brief 清空所有图书数据
      *
@@ -134,6 +145,8 @@ public:
      *
      * @note 删除操作不可撤销，请谨慎使用
      * @note 如果该图书有借出中的副本，删除操作会失败
+     * @note 图书在DatabaseManager中留下墓碑，不移动其他图书、不重编槽位号；
+     *       耗时只与该书的副本数和检索词数有关，与馆藏总量无关
      */
     bool removeBookByIndexId(const QString &indexId);
 
@@ -175,12 +188,53 @@ public:
      * 返回系统中所有图书的信息列表。
      * 返回的数据按照添加时间排序。
      *
-     * @return const QVector<Book>& 所有图书的常量引用
+     * @return QVector<Book> 所有图书
      *
-     * @note 返回的引用指向内部数据，不应修改
+     * @note 没有删除过图书时与DatabaseManager的存储隐式共享，不复制数据
      * @note 数据量较大时建议使用分页或过滤功能
      */
-    const QVector<Book>& getAll() const;
+    QVector<Book> getAll() const;
+
+    /**
+     * @brief 分页获取图书
+     *
+     * 按入库顺序跳过offset本、取出至多limit本，只复制这一页的图书。
+     *
+     * @param offset 跳过的图书数
+     * @param limit 本页最多返回的图书数，负数表示取到末尾
+     * @return QVector<Book> 本页的图书
+     */
+    QVector<Book> getPage(int offset, int limit) const;
+
+    /**
+     * @brief 按槽位号取出图书
+     *
+     * 与query()配合使用：先只拿槽位号，再只为界面实际显示的那一段复制图书。
+     * 已删除的槽位会被跳过。
+     *
+     * @param slotList DatabaseManager槽位号
+     * @return QVector<Book> 按slotList顺序排列的图书
+     */
+    QVector<Book> booksAt(const QVector<int> &slotList) const;
+
+    /**
+     * @brief 统计满足查询条件的图书数
+     *
+     * 忽略查询的排序与分页设置，供分页界面计算总页数。
+     *
+     * @param q 筛选条件
+     * @return int 命中的图书数
+     */
+    int count(const LibraryQuery &q) const;
+
+    /**
+     * @brief 获取当前出现过的全部分类
+     *
+     * 只扫描类别驻留编号列，不读取图书记录；排序使用StringPool缓存的区域排序名次。
+     *
+     * @return QStringList 至少有一本图书的分类名称，按区域排序规则排列
+     */
+    QStringList getCategories() const;
 
     /**
      * @brief 根据分类获取图书列表
@@ -189,12 +243,14 @@ public:
      * 分类匹配支持大小写不敏感的比较。
      *
      * @param category 图书分类名称
+     * @param offset 分页：跳过的图书数
+     * @param limit 分页：最多返回的图书数，负数表示不限
      * @return QVector<Book> 指定分类的图书列表
      *
      * @note 如果分类不存在，返回空列表
-     * @note 分类名称支持部分匹配
+     * @note 只复制请求的那一页
      */
-    QVector<Book> getByCategory(const QString &category) const;
+    QVector<Book> getByCategory(const QString &category, int offset = 0, int limit = -1) const;
 
     /**
      * @brief 根据馆藏位置获取图书列表
@@ -203,12 +259,14 @@ public:
      * 支持多校区的位置管理。
      *
      * @param location 馆藏位置名称
+     * @param offset 分页：跳过的图书数
+     * @param limit 分页：最多返回的图书数，负数表示不限
      * @return QVector<Book> 指定位置的图书列表
      *
      * @note 常见位置：三牌楼、仙林等
-     * @note 位置匹配支持大小写不敏感
+     * @note 只复制请求的那一页
      */
-    QVector<Book> getByLocation(const QString &location) const;
+    QVector<Book> getByLocation(const QString &location, int offset = 0, int limit = -1) const;
 
     /**
      * @brief 搜索图书
@@ -217,13 +275,87 @@ public:
      * 支持中文分词和多关键词搜索。
      *
      * @param keyword 搜索关键词
+     * @param offset 分页：跳过的图书数
+     * @param limit 分页：最多返回的图书数，负数表示不限
      * @return QVector<Book> 匹配的图书列表
      *
      * @note 搜索是大小写不敏感的
      * @note 支持空格分隔的多关键词搜索
-     * @note 搜索结果按相关性排序
+     * @note 搜索结果按相关性排序，只复制请求的那一页
+     */
+    QVector<Book> searchBooks(const QString &keyword, int offset = 0, int limit = -1) const;
+
+    /**
+     * @brief 基于倒排索引的搜索
+     *
+     * 中文按单字/双字、英文按单词前缀在倒排索引中查找，多个关键词求交集，
+     * 结果按命中字段的权重排序。索引在加载时建立，随增删改增量更新。
+     *
+     * @param keyword 搜索关键词，空格分隔的多个词需同时命中
+     * @param fieldMask 限定检索的字段（SearchIndex::Field的组合）
+     * @return QVector<int> 按相关度排序的DatabaseManager槽位号
      */
-    QVector<Book> searchBooks(const QString &keyword) const;
+    QVector<int> searchSlots(const QString &keyword, int fieldMask = SearchIndex::AllFields) const;
+
+    /**
+     * @brief 按拼音前缀搜索书名和作者
+     *
+     * 支持全拼和首字母，例如输入 hlm、honglou 均可找到"红楼梦"。
+     * 拼音索引与倒排索引同时建立和更新。
+     *
+     * @param keyword 拼音（可含空格），也可以直接输入汉字
+     * @param fieldMask 限定检索的字段，只有NameField和AuthorField有效
+     * @return QVector<int> 书名命中在前、完整匹配在前的DatabaseManager槽位号
+     */
+    QVector<int> searchPinyinSlots(const QString &keyword,
+                                   int fieldMask = SearchIndex::NameField | SearchIndex::AuthorField) const;
+
+    /**
+     * @brief 容错搜索书名和作者中的拉丁单词
+     *
+     * 每个查询词允许一两处拼写错误（4~7个字母1处，8个字母以上2处），
+     * 例如 Silberchatz 可以找到 Silberschatz。先用三元组索引筛选候选词，
+     * 再用限定带宽的编辑距离验证。
+     *
+     * @param keyword 查询词，空格分隔的多个词需在同一本书中都找到近似词
+     * @param fieldMask 限定检索的字段，只有NameField和AuthorField有效
+     * @return QVector<int> 按编辑距离升序、借阅次数降序排列的DatabaseManager槽位号
+     */
+    QVector<int> searchFuzzySlots(const QString &keyword,
+                                  int fieldMask = SearchIndex::NameField | SearchIndex::AuthorField) const;
+
+    /**
+     * @brief 对容错搜索的匹配结果排序
+     *
+     * 编辑距离小的在前，距离相同时借阅次数多的在前。
+     * 后台线程只能拿到编辑距离，借阅次数需回到主线程读取。
+     *
+     * @param matches 容错索引返回的匹配
+     * @return QVector<int> 排好序的DatabaseManager槽位号
+     */
+    QVector<int> rankFuzzyMatches(QVector<FuzzyIndex::Match> matches) const;
+
+    /**
+     * @brief 执行图书列表查询
+     *
+     * 主窗口的全部列表和搜索结果共用这一条执行路径：按执行计划先判代价最低、
+     * 命中最少的条件（驻留编号列），再查副本计数，最后求值自定义谓词；
+     * 不带排序的分页查询凑够一页即停止，其余情况分块并行求值。
+     *
+     * @param q 筛选、排序与分页条件，见LibraryQuery
+     * @return QVector<int> 满足条件的DatabaseManager槽位号
+     */
+    QVector<int> query(const LibraryQuery &q) const;
+
+    /**
+     * @brief 搜索索引的只读访问
+     *
+     * 索引只由Qt隐式共享容器组成，复制一份的代价是常数，
+     * 复制品可以交给后台线程查询（见AsyncSearch）。
+     */
+    const SearchIndex& searchIndex() const { return searchIndex_; }
+    const PinyinIndex& pinyinIndex() const { return pinyinIndex_; }
+    const FuzzyIndex& fuzzyIndex() const { return fuzzyIndex_; }
 
     /**
      * @brief 获取借阅预警图书列表
@@ -298,6 +430,15 @@ public:
     QVector<BookCopy> getDueSoonCopies(int days) const;
 
     // --- 统计信息 ---
+    /**
+     * @brief 获取统计快照
+     *
+     * 计数器在每次增删改、借还时以O(1)增量更新，加载数据时整体重建，
+     * 因此调用本方法不会扫描图书或副本。
+     *
+     * @return LibraryStats 当前统计数据的快照
+     */
+    LibraryStats stats() const;
     int getTotalBooks() const;
     int getTotalCopies() const;
     int getAvailableCopies() const;
@@ -307,26 +448,48 @@ public:
     QString getMostPopularLocation() const;
 
     // --- 排序 ---
-    // void sortByName();
-    // void sortByCategory();
-    // void sortByLocation();
-    // void sortByPrice(); // 高到低
-    // void sortByDate(); // 新到旧
-    void sortByBorrowCount(); // 高到低
+    // 通过LibraryQuery::sort指定，由DatabaseManager的排序索引提供（见SortIndex），不再重排图书数据
 
     // --- 数据库操作 ---
     bool loadFromDatabase();
     bool saveToDatabase();
     bool importSampleData();
     bool exportToJson(const QString& filePath);
-    bool importFromJson(const QString& filePath);
+    // 流式导入，progress可选，按已读字节数报告进度（见DatabaseManager::importFromJson）
+    bool importFromJson(const QString& filePath,
+                        const DatabaseManager::ImportProgress &progress = DatabaseManager::ImportProgress());
 
     signals:
         void dataChanged();  // 确保有这个信号声明
 
+private slots:
+    void onCopyCountsChanged(const QString &indexId, int totalDelta, int availableDelta);
+
 private:
+    /**
+     * @brief 构造函数
+     *
+     * 初始化图书馆管理器，建立与数据库管理器的连接，
+     * 图书只存放在DatabaseManager中，这里只建立统计和搜索索引。
+     *
+     * @param parent 父QObject指针，用于Qt对象树管理
+     * @note 只能通过instance()获取，避免出现多份统计和索引
+     */
+    explicit LibraryManager(QObject *parent = nullptr);
+
+    ~LibraryManager() override = default;
+    LibraryManager(const LibraryManager&) = delete;
+    LibraryManager& operator=(const LibraryManager&) = delete;
+
     void refreshFromDatabase();
-    QVector<Book> books_;
+    static SortIndex::Key sortKeyFor(LibraryQuery::Sort sort);
+    void rebuildStats();
+    void rebuildSearchIndex();
+    void adjustBookStats(const Book &book, int copyDelta, double valueSign);
+    LibraryStats stats_;             ///< 增量维护的统计计数器
+    SearchIndex searchIndex_;        ///< 全文倒排索引，按DatabaseManager槽位号组织
+    PinyinIndex pinyinIndex_;        ///< 书名/作者的拼音前缀索引，同样按槽位号组织
+    FuzzyIndex fuzzyIndex_;          ///< 书名/作者拉丁单词的三元组容错索引
     DatabaseManager& dbManager_;
     BookCopyManager& copyManager_;
 };
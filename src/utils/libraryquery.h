@@ -0,0 +1,88 @@
+// libraryquery.h
+#ifndef LIBRARYQUERY_H
+#define LIBRARYQUERY_H
+
+#include <QVector>
+#include <QString>
+#include <functional>
+
+// 图书列表查询：筛选条件 + 排序 + 分页，由 LibraryManager::query() 执行，只返回槽位号
+// - 不限定候选集时扫描全部槽位（按槽位顺序，即入库顺序）；指定排序时直接沿排序索引扫描，
+//   取前k本不需要排序；限定候选集时（如搜索结果）只在候选集中筛选，并保持候选集原有的顺序（相关度）
+// - 类别/馆藏地址只比较驻留编号列，可借状态需要查副本计数，自定义谓词最后求值；
+//   多个条件同时给出时由执行计划决定先后，调用方无需关心
+// - 自定义谓词可能在多个线程中同时调用，只能读取数据
+struct LibraryQuery {
+    enum Status {
+        AnyStatus,   // 不限
+        Available,   // 至少有一本可借副本
+        Borrowed     // 副本全部借出
+    };
+
+    enum Sort {
+        SourceOrder,     // 保持槽位顺序或候选集顺序
+        ByBorrowCount,   // 借阅次数从高到低
+        ByPrice,         // 价格从高到低
+        ByInDate,        // 入库日期从新到旧
+        ByName,          // 书名按区域排序规则升序
+        ByCategory,      // 类别按区域排序规则升序
+        ByLocation       // 馆藏地址按区域排序规则升序
+    };                   // 同值时保持原顺序
+
+    QString category;                        // 为空表示不限
+    QString location;                        // 为空表示不限
+    Status status = AnyStatus;
+    std::function<bool(int slot)> predicate; // 可选的自定义条件
+
+    bool restrictToCandidates = false;
+    QVector<int> candidates;                 // restrictToCandidates为true时有效
+
+    Sort sort = SourceOrder;
+    int offset = 0;
+    int limit = -1;                          // 负数表示不限
+
+    void setCandidates(const QVector<int> &slotList)
+    {
+        candidates = slotList;
+        restrictToCandidates = true;
+    }
+
+    // 主窗口筛选菜单的取值："available"、"borrowed"，其余视为不限
+    static Status statusFromString(const QString &value)
+    {
+        if (value == "available") {
+            return Available;
+        }
+        if (value == "borrowed") {
+            return Borrowed;
+        }
+        return AnyStatus;
+    }
+
+    // 主窗口排序菜单的取值："borrowCount"、"price"、"inDate"、"name"、"category"、"location"，
+    // 其余视为默认顺序
+    static Sort sortFromString(const QString &value)
+    {
+        if (value == "borrowCount") {
+            return ByBorrowCount;
+        }
+        if (value == "price") {
+            return ByPrice;
+        }
+        if (value == "inDate") {
+            return ByInDate;
+        }
+        if (value == "name") {
+            return ByName;
+        }
+        if (value == "category") {
+            return ByCategory;
+        }
+        if (value == "location") {
+            return ByLocation;
+        }
+        return SourceOrder;
+    }
+};
+
+#endif // LIBRARYQUERY_H
@@ -3,6 +3,8 @@
 #include <QApplication>
 #include <QStandardPaths>
 #include <QIcon>
+#include <QPointer>
+#include "passwordhasher.h"
 
 Log::Log(QWidget *parent)
     : QDialog(parent)
@@ -17,6 +19,9 @@ Log::Log(QWidget *parent)
     , isRegisterMode_(false)
     , isAdminMode_(false)
 {
+    // 口令哈希和验证都在这个线程池里进行，同一时间只有一个任务
+    verifyPool_.setMaxThreadCount(1);
+
     // 设置用户数据文件路径（存储在应用程序数据目录）
     // 1. 获取可执行文件所在的目录
     QString appDirPath = QCoreApplication::applicationDirPath();
@@ -41,43 +46,35 @@ Log::Log(QWidget *parent)
     // 4. 组合成最终的文件完整路径
     usersFilePath_ = absoluteTargetPath + "/users.json";
 
-    // 加载用户数据（如果不存在则自动创建并写入默认账号）
-    loadUsers();
+    // 加载用户数据（只解析一次，之后登录、注册都查内存中的索引）
+    UserStore &users = UserStore::instance();
+    if (!users.open(usersFilePath_)) {
+        QMessageBox::warning(nullptr, "警告", QString("用户数据文件读取失败或格式错误：%1").arg(usersFilePath_));
+    }
 
     // 确保预置管理员和学生账号存在
     // 管理员：B24010616 / B24010608，密码 123
-    auto ensureUser = [this](const QString &username,
-                             const QString &password,
-                             const QString &role) {
-        // 检查是否已经存在
-        for (const QJsonValue &value : std::as_const(usersArray_)) {
-            if (!value.isObject()) continue;
-            QJsonObject obj = value.toObject();
-            if (obj.value("username").toString() == username) {
-                // 已存在则只补充缺失字段
-                if (!obj.contains("role")) obj["role"] = role;
-                // 确保密码为指定值（方便调试）
-                obj["password"] = password;
-
-                // 写回数组
-                for (int i = 0; i < usersArray_.size(); ++i) {
-                    QJsonObject existing = usersArray_.at(i).toObject();
-                    if (existing.value("username").toString() == username) {
-                        usersArray_[i] = obj;
-                        break;
-                    }
-                }
-                return;
-            }
+    // 缺少密码的账号要先计算口令哈希，放到工作线程进行，算完后在界面线程写入
+    QVector<QPair<QJsonObject, QString>> unhashedPresets;
+    auto ensureUser = [&users, &unhashedPresets](const QString &username,
+                                                 const QString &password,
+                                                 const QString &role) {
+        QJsonObject obj = users.user(username);
+        if (obj.isEmpty()) {
+            // 不存在则追加新用户
+            obj["username"] = username;
+            obj["role"] = role;
+        } else if (!obj.contains("role")) {
+            // 已存在则只补充缺失字段
+            obj["role"] = role;
         }
-
-        // 不存在则追加新用户
-        QJsonObject newUser;
-        newUser["username"] = username;
-        newUser["password"] = password;
-        newUser["role"] = role;
-        newUser["borrows"] = QJsonArray(); // 预留借阅信息
-        usersArray_.append(newUser);
+        // 没有密码时设为指定值（方便调试）；已有的哈希不再每次启动都重新计算
+        if (obj.value("password").toString().isEmpty()) {
+            unhashedPresets.append(qMakePair(obj, password));
+            return;
+        }
+        // 内容没有变化时不会产生任何写入
+        users.putUser(obj);
     };
 
     // 两个管理员
@@ -87,12 +84,30 @@ Log::Log(QWidget *parent)
     ensureUser(QStringLiteral("S24010001"), QStringLiteral("123"), QStringLiteral("student"));
     ensureUser(QStringLiteral("S24010002"), QStringLiteral("123"), QStringLiteral("student"));
 
-    // 保存可能更新后的用户数据
-    saveUsers();
-
     // 设置UI
     setupUI();
 
+    if (!unhashedPresets.isEmpty()) {
+        // 预置账号写入之前不能登录，否则会读到还没有密码的账号
+        actionButton_->setEnabled(false);
+        actionButton_->setText("准备中...");
+
+        QPointer<Log> self(this);
+        verifyPool_.start([self, unhashedPresets]() {
+            QVector<QJsonObject> presets;
+            for (const auto &preset : unhashedPresets) {
+                QJsonObject obj = preset.first;
+                obj["password"] = PasswordHasher::instance().hash(preset.second);
+                presets.append(obj);
+            }
+            QMetaObject::invokeMethod(self.data(), [self, presets]() {
+                if (self) {
+                    self->finishPresetUsers(presets);
+                }
+            }, Qt::QueuedConnection);
+        });
+    }
+
     // 设置窗口属性
     setWindowTitle("登录");
     setModal(true);
@@ -104,6 +119,8 @@ Log::Log(QWidget *parent)
 
 Log::~Log()
 {
+    // 等待尚未结束的口令验证，它完成后投递给本对话框的事件会随对话框一起销毁
+    verifyPool_.waitForDone();
 }
 
 void Log::setupUI()
@@ -352,8 +369,37 @@ void Log::performLogin()
         return;
     }
 
+    if (verifyPool_.activeThreadCount() > 0) {
+        return;
+    }
+
+    // 口令哈希验证耗时较长，放到工作线程进行，期间对话框保持响应
+    const QString stored = UserStore::instance().user(username).value("password").toString();
+    actionButton_->setEnabled(false);
+    actionButton_->setText("验证中...");
+
+    QPointer<Log> self(this);
+    verifyPool_.start([self, username, password, stored]() {
+        const PasswordHasher &hasher = PasswordHasher::instance();
+        const bool valid = hasher.verify(password, stored, username);
+        // 旧的明文口令或迭代次数低于当前设置的哈希，趁知道明文时重新计算
+        const QString upgradedHash = valid && hasher.needsRehash(stored) ? hasher.hash(password) : QString();
+        // 对话框析构时会等待本任务结束，此时self仍然有效
+        QMetaObject::invokeMethod(self.data(), [self, username, valid, upgradedHash]() {
+            if (self) {
+                self->finishLogin(username, valid, upgradedHash);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void Log::finishLogin(const QString &username, bool valid, const QString &upgradedHash)
+{
+    actionButton_->setEnabled(true);
+    actionButton_->setText(isRegisterMode_ ? "注册" : "登录");
+
     // 验证用户名和密码
-    if (!validateUser(username, password)) {
+    if (!valid) {
         QMessageBox msgBox(this);
         msgBox.setIcon(QMessageBox::Warning);
         msgBox.setWindowTitle("登录失败");
@@ -365,17 +411,16 @@ void Log::performLogin()
         return;
     }
 
-    // 读取用户角色
-    QString role = QStringLiteral("student");
-    for (const QJsonValue &value : std::as_const(usersArray_)) {
-        if (!value.isObject()) continue;
-        QJsonObject obj = value.toObject();
-        if (obj.value("username").toString() == username) {
-            role = obj.value("role").toString(QStringLiteral("student"));
-            break;
-        }
+    UserStore &users = UserStore::instance();
+    if (!upgradedHash.isEmpty()) {
+        QJsonObject obj = users.user(username);
+        obj["password"] = upgradedHash;
+        users.putUser(obj);
     }
 
+    // 读取用户角色
+    const QString role = users.roleOf(username);
+
     // 根据勾选情况决定是否以管理员模式登录
     if (adminCheckBox_ && adminCheckBox_->isChecked()) {
         if (role != QStringLiteral("admin")) {
@@ -460,16 +505,38 @@ void Log::performRegister()
         return;
     }
 
+    if (verifyPool_.activeThreadCount() > 0) {
+        return;
+    }
+
+    // 计算口令哈希耗时较长，放到工作线程进行，算完后在界面线程保存
+    actionButton_->setEnabled(false);
+    actionButton_->setText("注册中...");
+
+    QPointer<Log> self(this);
+    verifyPool_.start([self, username, password]() {
+        const QString passwordHash = PasswordHasher::instance().hash(password);
+        QMetaObject::invokeMethod(self.data(), [self, username, passwordHash]() {
+            if (self) {
+                self->finishRegister(username, passwordHash);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void Log::finishRegister(const QString &username, const QString &passwordHash)
+{
+    actionButton_->setEnabled(true);
+    actionButton_->setText(isRegisterMode_ ? "注册" : "登录");
+
     // 添加新用户，默认学生角色
     QJsonObject newUser;
     newUser["username"] = username;
-    newUser["password"] = password; // 注意：实际应用中应该对密码进行加密
+    newUser["password"] = passwordHash; // 只保存加盐哈希
     newUser["role"] = QStringLiteral("student");
-    newUser["borrows"] = QJsonArray();
-    usersArray_.append(newUser);
 
-    // 保存用户数据
-    if (saveUsers()) {
+    // 保存用户数据（只追加这一个用户的变更记录）
+    if (UserStore::instance().addUser(newUser)) {
         QMessageBox msgBox(this);
         msgBox.setIcon(QMessageBox::Information);
         msgBox.setWindowTitle("注册成功");
@@ -488,79 +555,21 @@ void Log::performRegister()
         msgBox.setText("保存用户数据失败！");
         msgBox.setStyleSheet(getMessageBoxStyle());
         msgBox.exec();
-        // 移除刚才添加的用户
-        usersArray_.removeAt(usersArray_.size() - 1);
     }
 }
-//先判断路径是否存在
-//不存在则创建路径
-//然后获取读者的数组
-bool Log::loadUsers()
-{
-    QFile file(usersFilePath_);
-    if (!file.exists()) {
-        // 文件不存在，创建空的用户数组
-        usersArray_ = QJsonArray();
-        return true;
-    }
-
-    if (!file.open(QIODevice::ReadOnly)) {
-        QMessageBox::warning(nullptr, "警告", QString("无法读取用户数据文件：%1").arg(file.errorString()));
-        usersArray_ = QJsonArray();
-        return false;
-    }
-
-    QByteArray data = file.readAll();
-    file.close();
 
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (doc.isNull() || !doc.isArray()) {
-        QMessageBox::warning(nullptr, "警告", "用户数据文件格式错误，将创建新的数据文件。");
-        usersArray_ = QJsonArray();
-        return false;
-    }
-    //获取并更新用户数组
-    usersArray_ = doc.array();
-    return true;
-}
-
-bool Log::saveUsers()
+void Log::finishPresetUsers(const QVector<QJsonObject> &presets)
 {
-    QFile file(usersFilePath_);
-    if (!file.open(QIODevice::WriteOnly)) {
-        QMessageBox::critical(nullptr, "错误", QString("无法保存用户数据文件：%1").arg(file.errorString()));
-        return false;
+    UserStore &users = UserStore::instance();
+    for (const QJsonObject &obj : presets) {
+        users.putUser(obj);
     }
 
-    QJsonDocument doc(usersArray_);
-    file.write(doc.toJson());
-    file.close();
-    return true;
-}
-
-bool Log::userExists(const QString &username)
-{
-    for (const QJsonValue &value : usersArray_) {
-        if (value.isObject()) {
-            QJsonObject user = value.toObject();
-            if (user.value("username").toString() == username) {
-                return true;
-            }
-        }
-    }
-    return false;
+    actionButton_->setEnabled(true);
+    actionButton_->setText(isRegisterMode_ ? "注册" : "登录");
 }
 
-bool Log::validateUser(const QString &username, const QString &password)
+bool Log::userExists(const QString &username) const
 {
-    for (const QJsonValue &value : usersArray_) {
-        if (value.isObject()) {
-            QJsonObject user = value.toObject();
-            if (user.value("username").toString() == username &&
-                user.value("password").toString() == password) {
-                return true;
-            }
-        }
-    }
-    return false;
+    return UserStore::instance().contains(username);
 }
@@ -14,7 +14,9 @@
 #include <QJsonArray>
 #include <QFile>
 #include <QDir>
+#include <QThreadPool>
 #include "userrole.h"
+#include "userstore.h"
 
 /**
  * @brief 登录/注册对话框类
@@ -53,14 +55,14 @@ private slots:
 private:
     // 初始化UI
     void setupUI();
-    // 加载用户数据
-    bool loadUsers();
-    // 保存用户数据
-    bool saveUsers();
     // 检查用户名是否存在
-    bool userExists(const QString &username);
-    // 验证用户名和密码
-    bool validateUser(const QString &username, const QString &password);
+    bool userExists(const QString &username) const;
+    // 工作线程验证完口令后在界面线程继续登录；upgradedHash非空时替换保存的口令哈希
+    void finishLogin(const QString &username, bool valid, const QString &upgradedHash);
+    // 工作线程算完新账号的口令哈希后在界面线程保存
+    void finishRegister(const QString &username, const QString &passwordHash);
+    // 写入算好口令哈希的预置账号，之后才允许登录
+    void finishPresetUsers(const QVector<QJsonObject> &presets);
 
     // UI组件
     QVBoxLayout *mainLayout_;
@@ -73,9 +75,9 @@ private:
     QCheckBox *adminCheckBox_ = nullptr; // 管理员模式选择
 
     // 数据
-    QJsonArray usersArray_;          // 存储所有用户信息
     QString currentUsername_;        // 当前登录的用户名
     QString usersFilePath_;          // 用户数据文件路径
+    QThreadPool verifyPool_;         // 口令哈希和验证线程
 
     QString getMessageBoxStyle() const;
 
@@ -0,0 +1,131 @@
+// parallelscan.cpp
+#include "parallelscan.h"
+#include <QSemaphore>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+// 每块至少这么多条，块太小时领块的原子操作和缓冲区拼接反而成为开销
+const int kMinChunkSize = 4096;
+// 每个线程分到的块数，块多一些可以让快慢不一的线程自动均衡
+const int kChunksPerThread = 4;
+
+} // namespace
+
+ParallelScan& ParallelScan::instance()
+{
+    static ParallelScan instance;
+    return instance;
+}
+
+ParallelScan::ParallelScan()
+    : minParallelCount_(16384)
+{
+    // 调用线程也参与扫描，工作线程数比核心数少一个
+    pool_.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+    pool_.setExpiryTimeout(30000);
+}
+
+ParallelScan::~ParallelScan()
+{
+    pool_.waitForDone();
+}
+
+int ParallelScan::threadCount() const
+{
+    return pool_.maxThreadCount() + 1;
+}
+
+void ParallelScan::setThreadCount(int count)
+{
+    pool_.setMaxThreadCount(std::max(0, count - 1));
+}
+
+int ParallelScan::minParallelCount() const
+{
+    return minParallelCount_;
+}
+
+void ParallelScan::setMinParallelCount(int count)
+{
+    minParallelCount_ = std::max(1, count);
+}
+
+QVector<int> ParallelScan::run(int count, const ChunkFunction &chunk)
+{
+    QVector<int> result;
+    if (count <= 0) {
+        return result;
+    }
+
+    const int chunkCount = std::min(threadCount() * kChunksPerThread,
+                                    std::max(1, count / kMinChunkSize));
+    if (count < minParallelCount_ || chunkCount <= 1) {
+        chunk(0, count, result);
+        return result;
+    }
+
+    QVector<QVector<int>> parts(chunkCount);
+    dispatch(count, chunkCount, chunk, parts);
+
+    // 按块号顺序拼接，保持原始顺序
+    int total = 0;
+    for (const QVector<int> &part : std::as_const(parts)) {
+        total += part.size();
+    }
+    result.reserve(total);
+    for (const QVector<int> &part : std::as_const(parts)) {
+        result.append(part);
+    }
+    return result;
+}
+
+void ParallelScan::forEach(int count, const std::function<void(int index)> &fn, int grain)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    grain = std::max(1, grain);
+    const int chunkCount = (count + grain - 1) / grain;
+    QVector<QVector<int>> parts(chunkCount);
+    dispatch(count, chunkCount, [&fn](int begin, int end, QVector<int> &) {
+        for (int i = begin; i < end; ++i) {
+            fn(i);
+        }
+    }, parts);
+}
+
+void ParallelScan::dispatch(int count, int chunkCount, const ChunkFunction &chunk, QVector<QVector<int>> &parts)
+{
+    const int chunkSize = (count + chunkCount - 1) / chunkCount;
+    std::atomic<int> nextChunk(0);
+
+    // 领块循环：各线程不断领取下一个块号直到领完，块内结果写进对应的缓冲区
+    auto drain = [&]() {
+        for (int c = nextChunk.fetch_add(1); c < chunkCount; c = nextChunk.fetch_add(1)) {
+            const int begin = c * chunkSize;
+            const int end = std::min(count, begin + chunkSize);
+            chunk(begin, end, parts[c]);
+        }
+    };
+
+    QSemaphore done;
+    int helpers = 0;
+    const int wanted = std::min(pool_.maxThreadCount(), chunkCount - 1);
+    for (int i = 0; i < wanted; ++i) {
+        // 只借用空闲线程；线程池忙时由调用线程多做一些
+        if (!pool_.tryStart([&]() {
+                drain();
+                done.release();
+            })) {
+            break;
+        }
+        ++helpers;
+    }
+
+    drain();
+    done.acquire(helpers);
+}
@@ -0,0 +1,63 @@
+// parallelscan.h
+#ifndef PARALLELSCAN_H
+#define PARALLELSCAN_H
+
+#include <QVector>
+#include <QThreadPool>
+#include <functional>
+
+// 分块并行扫描
+// 把下标区间 [0, count) 切成若干连续的块，在专用线程池里并发求值谓词，
+// 每块把命中的下标写进自己的缓冲区，最后按块号顺序拼接，结果与顺序扫描完全一致（升序）。
+// - 调用线程自己也领块执行，工作线程只用 tryStart 借用空闲线程，从不排队等待，
+//   因此在工作线程里（例如后台搜索）调用也不会死锁
+// - 数量太少时直接在调用线程顺序扫描，省去调度开销
+// - 谓词会被多个线程同时调用，只能读共享数据；扫描期间调用方须保证数据不被修改
+class ParallelScan
+{
+public:
+    static ParallelScan& instance();
+
+    // 每块的执行体：扫描 [begin, end)，把命中的下标按升序追加到 out
+    using ChunkFunction = std::function<void(int begin, int end, QVector<int> &out)>;
+
+    QVector<int> run(int count, const ChunkFunction &chunk);
+
+    // 返回所有使 pred(i) 为真的下标，升序
+    template <typename Predicate>
+    QVector<int> filter(int count, Predicate pred)
+    {
+        return run(count, [&pred](int begin, int end, QVector<int> &out) {
+            for (int i = begin; i < end; ++i) {
+                if (pred(i)) {
+                    out.append(i);
+                }
+            }
+        });
+    }
+
+    // 对 [0, count) 中每个下标调用 fn(i)，适合每项开销很大的任务（如口令哈希）：
+    // 每块只含grain项，不受最小并行数量的限制；fn 会被多个线程同时调用，各下标只处理一次
+    void forEach(int count, const std::function<void(int index)> &fn, int grain = 1);
+
+    // 参与扫描的线程数（含调用线程），默认等于核心数；设为1时所有扫描都在调用线程上顺序执行
+    int threadCount() const;
+    void setThreadCount(int count);
+    // 少于该数量的扫描不并行
+    int minParallelCount() const;
+    void setMinParallelCount(int count);
+
+private:
+    ParallelScan();
+    ~ParallelScan();
+    ParallelScan(const ParallelScan&) = delete;
+    ParallelScan& operator=(const ParallelScan&) = delete;
+
+    // 把 [0, count) 分成chunkCount块，由调用线程和借来的空闲线程领块执行，第c块的输出写入parts[c]
+    void dispatch(int count, int chunkCount, const ChunkFunction &chunk, QVector<QVector<int>> &parts);
+
+    QThreadPool pool_;
+    int minParallelCount_;
+};
+
+#endif // PARALLELSCAN_H
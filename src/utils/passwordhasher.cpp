@@ -0,0 +1,223 @@
+// passwordhasher.cpp
+#include "passwordhasher.h"
+#include <QCryptographicHash>
+#include <QMessageAuthenticationCode>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QtEndian>
+#include <algorithm>
+
+namespace {
+
+const QString kScheme = QStringLiteral("pbkdf2-sha256");
+const int kSaltBytes = 16;
+const int kKeyBytes = 32;
+const int kBlockSize = 64;          // SHA-256 的分组长度
+const int kMaxCachedLogins = 256;
+const qint64 kCachedLoginLifetimeMs = 10 * 60 * 1000;   // 缓存的验证结果十分钟后失效
+
+QByteArray randomBytes(int count)
+{
+    QByteArray bytes(count, '\0');
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32 *>(bytes.data()), count / 4);
+    return bytes;
+}
+
+} // namespace
+
+PasswordHasher& PasswordHasher::instance()
+{
+    static PasswordHasher instance;
+    return instance;
+}
+
+PasswordHasher::PasswordHasher()
+    : iterations_(50000)
+    , cacheSecret_(randomBytes(32))
+{
+    clock_.start();
+}
+
+QString PasswordHasher::hash(const QString &password) const
+{
+    const int iterations = iterations_.load();
+
+    const QByteArray salt = randomBytes(kSaltBytes);
+
+    const QByteArray derived = pbkdf2(password.toUtf8(), salt, iterations, kKeyBytes);
+    return QStringList{kScheme,
+                       QString::number(iterations),
+                       QString::fromLatin1(salt.toBase64()),
+                       QString::fromLatin1(derived.toBase64())}.join('$');
+}
+
+bool PasswordHasher::verify(const QString &password, const QString &stored, const QString &username) const
+{
+    if (stored.isEmpty()) {
+        return false;
+    }
+    if (!isHashed(stored)) {
+        return password == stored;
+    }
+
+    const QByteArray tag = username.isEmpty() ? QByteArray() : cacheTag(username, password, stored);
+    if (!tag.isEmpty()) {
+        QMutexLocker locker(&cacheMutex_);
+        auto it = verified_.find(username);
+        if (it != verified_.end()) {
+            if (clock_.elapsed() - it->verifiedAt >= kCachedLoginLifetimeMs) {
+                verified_.erase(it);
+            } else if (constantTimeEquals(it->tag, tag)) {
+                return true;
+            }
+        }
+    }
+
+    const QStringList parts = stored.split('$');
+    bool ok = false;
+    const int iterations = parts.at(1).toInt(&ok);
+    if (!ok || iterations <= 0) {
+        return false;
+    }
+    const QByteArray salt = QByteArray::fromBase64(parts.at(2).toLatin1());
+    const QByteArray expected = QByteArray::fromBase64(parts.at(3).toLatin1());
+    if (expected.isEmpty()) {
+        return false;
+    }
+
+    const QByteArray derived = pbkdf2(password.toUtf8(), salt, iterations, expected.size());
+    if (!constantTimeEquals(derived, expected)) {
+        return false;
+    }
+
+    if (tag.isEmpty()) {
+        return true;
+    }
+
+    QMutexLocker locker(&cacheMutex_);
+    const qint64 now = clock_.elapsed();
+    if (verified_.size() >= kMaxCachedLogins && !verified_.contains(username)) {
+        // 先丢掉过期的记录，仍然满时淘汰最早的一条（QHash删除会移动元素，只记用户名）
+        verified_.removeIf([now](QHash<QString, CachedLogin>::iterator it) {
+            return now - it->verifiedAt >= kCachedLoginLifetimeMs;
+        });
+        if (verified_.size() >= kMaxCachedLogins) {
+            QString oldest;
+            qint64 oldestAt = now;
+            for (auto it = verified_.cbegin(); it != verified_.cend(); ++it) {
+                if (it->verifiedAt <= oldestAt) {
+                    oldest = it.key();
+                    oldestAt = it->verifiedAt;
+                }
+            }
+            verified_.remove(oldest);
+        }
+    }
+    verified_.insert(username, CachedLogin{tag, now});
+    return true;
+}
+
+bool PasswordHasher::needsRehash(const QString &stored) const
+{
+    if (!isHashed(stored)) {
+        return true;
+    }
+    return stored.section('$', 1, 1).toInt() < iterations_.load();
+}
+
+bool PasswordHasher::isHashed(const QString &stored)
+{
+    return stored.startsWith(kScheme + '$') && stored.count('$') == 3;
+}
+
+int PasswordHasher::iterations() const
+{
+    return iterations_.load();
+}
+
+void PasswordHasher::setIterations(int iterations)
+{
+    iterations_.store(std::max(1, iterations));
+}
+
+void PasswordHasher::forgetUser(const QString &username)
+{
+    QMutexLocker locker(&cacheMutex_);
+    verified_.remove(username);
+}
+
+void PasswordHasher::clearCache()
+{
+    QMutexLocker locker(&cacheMutex_);
+    verified_.clear();
+}
+
+QByteArray PasswordHasher::pbkdf2(const QByteArray &password, const QByteArray &salt, int iterations, int keyLength)
+{
+    // HMAC的内外填充只与口令有关，每次迭代复用
+    QByteArray key = password.size() > kBlockSize
+                     ? QCryptographicHash::hash(password, QCryptographicHash::Sha256)
+                     : password;
+    key.append(QByteArray(kBlockSize - key.size(), '\0'));
+
+    QByteArray innerPad(kBlockSize, '\x36');
+    QByteArray outerPad(kBlockSize, '\x5c');
+    for (int i = 0; i < kBlockSize; ++i) {
+        innerPad[i] = char(innerPad.at(i) ^ key.at(i));
+        outerPad[i] = char(outerPad.at(i) ^ key.at(i));
+    }
+
+    QCryptographicHash inner(QCryptographicHash::Sha256);
+    QCryptographicHash outer(QCryptographicHash::Sha256);
+    auto hmac = [&](const QByteArray &message) {
+        inner.reset();
+        inner.addData(innerPad);
+        inner.addData(message);
+        outer.reset();
+        outer.addData(outerPad);
+        outer.addData(inner.resultView());
+        return outer.result();
+    };
+
+    QByteArray derived;
+    for (quint32 block = 1; derived.size() < keyLength; ++block) {
+        QByteArray message = salt;
+        const quint32 index = qToBigEndian(block);
+        message.append(reinterpret_cast<const char *>(&index), sizeof(index));
+
+        QByteArray u = hmac(message);
+        QByteArray t = u;
+        for (int i = 1; i < iterations; ++i) {
+            u = hmac(u);
+            for (int j = 0; j < t.size(); ++j) {
+                t[j] = char(t.at(j) ^ u.at(j));
+            }
+        }
+        derived.append(t);
+    }
+    derived.truncate(keyLength);
+    return derived;
+}
+
+bool PasswordHasher::constantTimeEquals(const QByteArray &a, const QByteArray &b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    char diff = 0;
+    for (int i = 0; i < a.size(); ++i) {
+        diff |= char(a.at(i) ^ b.at(i));
+    }
+    return diff == 0;
+}
+
+QByteArray PasswordHasher::cacheTag(const QString &username, const QString &password, const QString &stored) const
+{
+    QMessageAuthenticationCode mac(QCryptographicHash::Sha256, cacheSecret_);
+    mac.addData(username.toUtf8());
+    mac.addData(QByteArrayView("\0", 1));
+    mac.addData(stored.toUtf8());
+    mac.addData(QByteArrayView("\0", 1));
+    mac.addData(password.toUtf8());
+    return mac.result();
+}
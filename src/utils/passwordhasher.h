@@ -0,0 +1,63 @@
+// passwordhasher.h
+#ifndef PASSWORDHASHER_H
+#define PASSWORDHASHER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <atomic>
+
+// 口令哈希：加盐的 PBKDF2-HMAC-SHA256，由 QCryptographicHash 实现
+// - 保存格式为 "pbkdf2-sha256$迭代次数$盐(Base64)$哈希(Base64)"，迭代次数随哈希一起保存，
+//   调高工作因子后旧哈希仍能验证，needsRehash() 为真时由调用方在登录成功后重新计算
+// - 不带前缀的旧数据按明文比较，同样视为需要重新计算
+// - 带用户名验证通过后，按用户缓存一个消息认证码（HMAC-SHA256，密钥为进程启动时生成的随机数），
+//   有效期内同一用户用同一口令再次验证不再付出哈希开销；缓存中不保存明文，
+//   没有本进程的密钥也无法用缓存内容离线猜测口令
+// - 缓存有条数上限和有效期，用户注销或修改口令时由调用方调用forgetUser()清除
+// - 线程安全，可在工作线程中调用
+class PasswordHasher
+{
+public:
+    static PasswordHasher& instance();
+
+    // 用当前的迭代次数和新的随机盐计算哈希
+    QString hash(const QString &password) const;
+    // username非空时使用并更新该用户的登录缓存
+    bool verify(const QString &password, const QString &stored, const QString &username = QString()) const;
+    // 明文或迭代次数低于当前设置时返回true
+    bool needsRehash(const QString &stored) const;
+    static bool isHashed(const QString &stored);
+
+    // 工作因子：PBKDF2 的迭代次数，每翻一倍验证耗时约翻一倍
+    int iterations() const;
+    void setIterations(int iterations);
+
+    void forgetUser(const QString &username);
+    void clearCache();
+
+private:
+    struct CachedLogin {
+        QByteArray tag;       // HMAC(密钥, 用户名 + 哈希 + 口令)
+        qint64 verifiedAt;    // clock_的毫秒数
+    };
+
+    PasswordHasher();
+    ~PasswordHasher() = default;
+    PasswordHasher(const PasswordHasher&) = delete;
+    PasswordHasher& operator=(const PasswordHasher&) = delete;
+
+    static QByteArray pbkdf2(const QByteArray &password, const QByteArray &salt, int iterations, int keyLength);
+    static bool constantTimeEquals(const QByteArray &a, const QByteArray &b);
+    QByteArray cacheTag(const QString &username, const QString &password, const QString &stored) const;
+
+    std::atomic<int> iterations_;
+    const QByteArray cacheSecret_;        // 每个进程随机生成，不落盘
+    QElapsedTimer clock_;
+    mutable QMutex cacheMutex_;
+    mutable QHash<QString, CachedLogin> verified_;   // 用户名 -> 最近一次验证通过的记录
+};
+
+#endif // PASSWORDHASHER_H
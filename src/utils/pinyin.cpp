@@ -0,0 +1,492 @@
+// pinyin.cpp
+#include "pinyin.h"
+#include <QHash>
+
+namespace {
+
+struct SyllableGroup {
+    const char *syllable;
+    const char16_t *chars;   // 读该音的GB2312一级汉字，按国标码顺序
+};
+
+// GB2312一级汉字按拼音排序，按音节分组列出
+const SyllableGroup kGroups[] = {
+    { "a",      u"啊阿" },
+    { "ai",     u"埃挨哎唉哀皑癌蔼矮艾碍爱隘" },
+    { "an",     u"鞍氨安俺按暗岸胺案" },
+    { "ang",    u"肮昂盎" },
+    { "ao",     u"凹敖熬翱袄傲奥懊澳" },
+    { "ba",     u"芭捌扒叭吧笆八疤巴拔跋靶把耙坝霸罢爸" },
+    { "bai",    u"白柏百摆佰败拜稗" },
+    { "ban",    u"斑班搬扳般颁板版扮拌伴瓣半办绊" },
+    { "bang",   u"邦帮梆榜膀绑棒磅蚌镑傍谤" },
+    { "bao",    u"苞胞包褒剥薄雹保堡饱宝抱报暴豹鲍爆" },
+    { "bei",    u"杯碑悲卑北辈背贝钡倍狈备惫焙被" },
+    { "ben",    u"奔苯本笨" },
+    { "beng",   u"崩绷甭泵蹦迸" },
+    { "bi",     u"逼鼻比鄙笔彼碧蓖蔽毕毙毖币庇痹闭敝弊必辟壁臂避陛" },
+    { "bian",   u"鞭边编贬扁便变卞辨辩辫遍" },
+    { "biao",   u"标彪膘表" },
+    { "bie",    u"鳖憋别瘪" },
+    { "bin",    u"彬斌濒滨宾摈" },
+    { "bing",   u"兵冰柄丙秉饼炳病并" },
+    { "bo",     u"玻菠播拨钵波博勃搏铂箔伯帛舶脖膊渤泊驳捕卜" },
+    { "bu",     u"哺补埠不布步簿部怖" },
+    { "ca",     u"擦" },
+    { "cai",    u"猜裁材才财睬踩采彩菜蔡" },
+    { "can",    u"餐参蚕残惭惨灿" },
+    { "cang",   u"苍舱仓沧藏" },
+    { "cao",    u"操糙槽曹草" },
+    { "ce",     u"厕策侧册测" },
+    { "ceng",   u"层蹭" },
+    { "cha",    u"插叉茬茶查碴搽察岔差诧" },
+    { "chai",   u"拆柴豺" },
+    { "chan",   u"搀掺蝉馋谗缠铲产阐颤" },
+    { "chang",  u"昌猖场尝常长偿肠厂敞畅唱倡" },
+    { "chao",   u"超抄钞朝嘲潮巢吵炒" },
+    { "che",    u"车扯撤掣彻澈" },
+    { "chen",   u"郴臣辰尘晨忱沉陈趁衬" },
+    { "cheng",  u"撑称城橙成呈乘程惩澄诚承逞骋秤" },
+    { "chi",    u"吃痴持匙池迟弛驰耻齿侈尺赤翅斥炽" },
+    { "chong",  u"充冲虫崇宠" },
+    { "chou",   u"抽酬畴踌稠愁筹仇绸瞅丑臭" },
+    { "chu",    u"初出橱厨躇锄雏滁除楚础储矗搐触处" },
+    { "chuai",  u"揣" },
+    { "chuan",  u"川穿椽传船喘串" },
+    { "chuang", u"疮窗幢床闯创" },
+    { "chui",   u"吹炊捶锤垂" },
+    { "chun",   u"春椿醇唇淳纯蠢" },
+    { "chuo",   u"戳绰" },
+    { "ci",     u"疵茨磁雌辞慈瓷词此刺赐次" },
+    { "cong",   u"聪葱囱匆从丛" },
+    { "cou",    u"凑" },
+    { "cu",     u"粗醋簇促" },
+    { "cuan",   u"蹿篡窜" },
+    { "cui",    u"摧崔催脆瘁粹淬翠" },
+    { "cun",    u"村存寸" },
+    { "cuo",    u"磋撮搓措挫错" },
+    { "da",     u"搭达答瘩打大" },
+    { "dai",    u"呆歹傣戴带殆代贷袋待逮怠" },
+    { "dan",    u"耽担丹单郸掸胆旦氮但惮淡诞弹蛋" },
+    { "dang",   u"当挡党荡档" },
+    { "dao",    u"刀捣蹈倒岛祷导到稻悼道盗" },
+    { "de",     u"德得的" },
+    { "deng",   u"蹬灯登等瞪凳邓" },
+    { "di",     u"堤低滴迪敌笛狄涤翟嫡抵底地蒂第帝弟递缔" },
+    { "dian",   u"颠掂滇碘点典靛垫电佃甸店惦奠淀殿" },
+    { "diao",   u"碉叼雕凋刁掉吊钓调" },
+    { "die",    u"跌爹碟蝶迭谍叠" },
+    { "ding",   u"丁盯叮钉顶鼎锭定订" },
+    { "diu",    u"丢" },
+    { "dong",   u"东冬董懂动栋侗恫冻洞" },
+    { "dou",    u"兜抖斗陡豆逗痘" },
+    { "du",     u"都督毒犊独读堵睹赌杜镀肚度渡妒" },
+    { "duan",   u"端短锻段断缎" },
+    { "dui",    u"堆兑队对" },
+    { "dun",    u"墩吨蹲敦顿囤钝盾遁" },
+    { "duo",    u"掇哆多夺垛躲朵跺舵剁惰堕" },
+    { "e",      u"蛾峨鹅俄额讹娥恶厄扼遏鄂饿" },
+    { "en",     u"恩" },
+    { "er",     u"而儿耳尔饵洱二贰" },
+    { "fa",     u"发罚筏伐乏阀法珐" },
+    { "fan",    u"藩帆番翻樊矾钒繁凡烦反返范贩犯饭泛" },
+    { "fang",   u"坊芳方肪房防妨仿访纺放" },
+    { "fei",    u"菲非啡飞肥匪诽吠肺废沸费" },
+    { "fen",    u"芬酚吩氛分纷坟焚汾粉奋份忿愤粪" },
+    { "feng",   u"丰封枫蜂峰锋风疯烽逢冯缝讽奉凤" },
+    { "fo",     u"佛" },
+    { "fou",    u"否" },
+    { "fu",     u"夫敷肤孵扶拂辐幅氟符伏俘服浮涪福袱弗甫抚辅俯釜斧脯腑府腐赴副覆赋复傅付阜父腹负富"
+                u"讣附妇缚咐" },
+    { "ga",     u"噶嘎" },
+    { "gai",    u"该改概钙盖溉" },
+    { "gan",    u"干甘杆柑竿肝赶感秆敢赣" },
+    { "gang",   u"冈刚钢缸肛纲岗港杠" },
+    { "gao",    u"篙皋高膏羔糕搞镐稿告" },
+    { "ge",     u"哥歌搁戈鸽胳疙割革葛格蛤阁隔铬个各" },
+    { "gei",    u"给" },
+    { "gen",    u"根跟" },
+    { "geng",   u"耕更庚羹埂耿梗" },
+    { "gong",   u"工攻功恭龚供躬公宫弓巩汞拱贡共" },
+    { "gou",    u"钩勾沟苟狗垢构购够" },
+    { "gu",     u"辜菇咕箍估沽孤姑鼓古蛊骨谷股故顾固雇" },
+    { "gua",    u"刮瓜剐寡挂褂" },
+    { "guai",   u"乖拐怪" },
+    { "guan",   u"棺关官冠观管馆罐惯灌贯" },
+    { "guang",  u"光广逛" },
+    { "gui",    u"瑰规圭硅归龟闺轨鬼诡癸桂柜跪贵刽" },
+    { "gun",    u"辊滚棍" },
+    { "guo",    u"锅郭国果裹过" },
+    { "ha",     u"哈" },
+    { "hai",    u"骸孩海氦亥害骇" },
+    { "han",    u"酣憨邯韩含涵寒函喊罕翰撼捍旱憾悍焊汗汉" },
+    { "hang",   u"夯杭航" },
+    { "hao",    u"壕嚎豪毫郝好耗号浩" },
+    { "he",     u"呵喝荷菏核禾和何合盒貉阂河涸赫褐鹤贺" },
+    { "hei",    u"嘿黑" },
+    { "hen",    u"痕很狠恨" },
+    { "heng",   u"哼亨横衡恒" },
+    { "hong",   u"轰哄烘虹鸿洪宏弘红" },
+    { "hou",    u"喉侯猴吼厚候后" },
+    { "hu",     u"呼乎忽瑚壶葫胡蝴狐糊湖弧虎唬护互沪户" },
+    { "hua",    u"花哗华猾滑画划化话" },
+    { "huai",   u"槐徊怀淮坏" },
+    { "huan",   u"欢环桓还缓换患唤痪豢焕涣宦幻" },
+    { "huang",  u"荒慌黄磺蝗簧皇凰惶煌晃幌恍谎" },
+    { "hui",    u"灰挥辉徽恢蛔回毁悔慧卉惠晦贿秽会烩汇讳诲绘" },
+    { "hun",    u"荤昏婚魂浑混" },
+    { "huo",    u"豁活伙火获或惑霍货祸" },
+    { "ji",     u"击圾基机畸稽积箕肌饥迹激讥鸡姬绩缉吉极棘辑籍集及急疾汲即嫉级挤几脊己蓟技冀季伎祭"
+                u"剂悸济寄寂计记既忌际妓继纪" },
+    { "jia",    u"嘉枷夹佳家加荚颊贾甲钾假稼价架驾嫁" },
+    { "jian",   u"歼监坚尖笺间煎兼肩艰奸缄茧检柬碱硷拣捡简俭剪减荐槛鉴践贱见键箭件健舰剑饯渐溅涧建" },
+    { "jiang",  u"僵姜将浆江疆蒋桨奖讲匠酱降" },
+    { "jiao",   u"蕉椒礁焦胶交郊浇骄娇嚼搅铰矫侥脚狡角饺缴绞剿教酵轿较叫窖" },
+    { "jie",    u"揭接皆秸街阶截劫节桔杰捷睫竭洁结解姐戒藉芥界借介疥诫届" },
+    { "jin",    u"巾筋斤金今津襟紧锦仅谨进靳晋禁近烬浸尽劲" },
+    { "jing",   u"荆兢茎睛晶鲸京惊精粳经井警景颈静境敬镜径痉靖竟竞净" },
+    { "jiong",  u"炯窘" },
+    { "jiu",    u"揪究纠玖韭久灸九酒厩救旧臼舅咎就疚" },
+    { "ju",     u"鞠拘狙疽居驹菊局咀矩举沮聚拒据巨具距踞锯俱句惧炬剧" },
+    { "juan",   u"捐鹃娟倦眷卷绢" },
+    { "jue",    u"撅攫抉掘倔爵觉决诀绝" },
+    { "jun",    u"均菌钧军君峻俊竣浚郡骏" },
+    { "ka",     u"喀咖卡咯" },
+    { "kai",    u"开揩楷凯慨" },
+    { "kan",    u"刊堪勘坎砍看" },
+    { "kang",   u"康慷糠扛抗亢炕" },
+    { "kao",    u"考拷烤靠" },
+    { "ke",     u"坷苛柯棵磕颗科壳咳可渴克刻客课" },
+    { "ken",    u"肯啃垦恳" },
+    { "keng",   u"坑吭" },
+    { "kong",   u"空恐孔控" },
+    { "kou",    u"抠口扣寇" },
+    { "ku",     u"枯哭窟苦酷库裤" },
+    { "kua",    u"夸垮挎跨胯" },
+    { "kuai",   u"块筷侩快" },
+    { "kuan",   u"宽款" },
+    { "kuang",  u"匡筐狂框矿眶旷况" },
+    { "kui",    u"亏盔岿窥葵奎魁傀馈愧溃" },
+    { "kun",    u"坤昆捆困" },
+    { "kuo",    u"括扩廓阔" },
+    { "la",     u"垃拉喇蜡腊辣啦" },
+    { "lai",    u"莱来赖" },
+    { "lan",    u"蓝婪栏拦篮阑兰澜谰揽览懒缆烂滥" },
+    { "lang",   u"琅榔狼廊郎朗浪" },
+    { "lao",    u"捞劳牢老佬姥酪烙涝" },
+    { "le",     u"勒乐" },
+    { "lei",    u"雷镭蕾磊累儡垒擂肋类泪" },
+    { "leng",   u"棱楞冷" },
+    { "li",     u"厘梨犁黎篱狸离漓理李里鲤礼莉荔吏栗丽厉励砾历利傈例俐痢立粒沥隶力璃哩" },
+    { "lia",    u"俩" },
+    { "lian",   u"联莲连镰廉怜涟帘敛脸链恋炼练" },
+    { "liang",  u"粮凉梁粱良两辆量晾亮谅" },
+    { "liao",   u"撩聊僚疗燎寥辽潦了撂镣廖料" },
+    { "lie",    u"列裂烈劣猎" },
+    { "lin",    u"琳林磷霖临邻鳞淋凛赁吝拎" },
+    { "ling",   u"玲菱零龄铃伶羚凌灵陵岭领另令" },
+    { "liu",    u"溜琉榴硫馏留刘瘤流柳六" },
+    { "long",   u"龙聋咙笼窿隆垄拢陇" },
+    { "lou",    u"楼娄搂篓漏陋" },
+    { "lu",     u"芦卢颅庐炉掳卤虏鲁麓碌露路赂鹿潞禄录陆戮" },
+    { "lv",     u"驴吕铝侣旅履屡缕虑氯律率滤绿" },
+    { "luan",   u"峦挛孪滦卵乱" },
+    { "lue",    u"掠略" },
+    { "lun",    u"抡轮伦仑沦纶论" },
+    { "luo",    u"萝螺罗逻锣箩骡裸落洛骆络" },
+    { "ma",     u"妈麻玛码蚂马骂嘛吗" },
+    { "mai",    u"埋买麦卖迈脉" },
+    { "man",    u"瞒馒蛮满蔓曼慢漫谩" },
+    { "mang",   u"芒茫盲氓忙莽" },
+    { "mao",    u"猫茅锚毛矛铆卯茂冒帽貌贸" },
+    { "me",     u"么" },
+    { "mei",    u"玫枚梅酶霉煤没眉媒镁每美昧寐妹媚" },
+    { "men",    u"门闷们" },
+    { "meng",   u"萌蒙檬盟锰猛梦孟" },
+    { "mi",     u"眯醚靡糜迷谜弥米秘觅泌蜜密幂" },
+    { "mian",   u"棉眠绵冕免勉娩缅面" },
+    { "miao",   u"苗描瞄藐秒渺庙妙" },
+    { "mie",    u"蔑灭" },
+    { "min",    u"民抿皿敏悯闽" },
+    { "ming",   u"明螟鸣铭名命" },
+    { "miu",    u"谬" },
+    { "mo",     u"摸摹蘑模膜磨摩魔抹末莫墨默沫漠寞陌" },
+    { "mou",    u"谋牟某" },
+    { "mu",     u"拇牡亩姆母墓暮幕募慕木目睦牧穆" },
+    { "na",     u"拿哪呐钠那娜纳" },
+    { "nai",    u"氖乃奶耐奈" },
+    { "nan",    u"南男难" },
+    { "nang",   u"囊" },
+    { "nao",    u"挠脑恼闹淖" },
+    { "ne",     u"呢" },
+    { "nei",    u"馁内" },
+    { "nen",    u"嫩" },
+    { "neng",   u"能" },
+    { "ni",     u"妮霓倪泥尼拟你匿腻逆溺" },
+    { "nian",   u"蔫拈年碾撵捻念" },
+    { "niang",  u"娘酿" },
+    { "niao",   u"鸟尿" },
+    { "nie",    u"捏聂孽啮镊镍涅" },
+    { "nin",    u"您" },
+    { "ning",   u"柠狞凝宁拧泞" },
+    { "niu",    u"牛扭钮纽" },
+    { "nong",   u"脓浓农弄" },
+    { "nu",     u"奴努怒" },
+    { "nv",     u"女" },
+    { "nuan",   u"暖" },
+    { "nue",    u"虐疟" },
+    { "nuo",    u"挪懦糯诺" },
+    { "o",      u"哦" },
+    { "ou",     u"欧鸥殴藕呕偶沤" },
+    { "pa",     u"啪趴爬帕怕琶" },
+    { "pai",    u"拍排牌徘湃派" },
+    { "pan",    u"攀潘盘磐盼畔判叛" },
+    { "pang",   u"乓庞旁耪胖" },
+    { "pao",    u"抛咆刨炮袍跑泡" },
+    { "pei",    u"呸胚培裴赔陪配佩沛" },
+    { "pen",    u"喷盆" },
+    { "peng",   u"砰抨烹澎彭蓬棚硼篷膨朋鹏捧碰" },
+    { "pi",     u"坯砒霹批披劈琵毗啤脾疲皮匹痞僻屁譬" },
+    { "pian",   u"篇偏片骗" },
+    { "piao",   u"飘漂瓢票" },
+    { "pie",    u"撇瞥" },
+    { "pin",    u"拼频贫品聘" },
+    { "ping",   u"乒坪苹萍平凭瓶评屏" },
+    { "po",     u"坡泼颇婆破魄迫粕剖" },
+    { "pu",     u"扑铺仆莆葡菩蒲埔朴圃普浦谱曝瀑" },
+    { "qi",     u"期欺栖戚妻七凄漆柒沏其棋奇歧畦崎脐齐旗祈祁骑起岂乞企启契砌器气迄弃汽泣讫" },
+    { "qia",    u"掐恰洽" },
+    { "qian",   u"牵扦钎铅千迁签仟谦乾黔钱钳前潜遣浅谴堑嵌欠歉" },
+    { "qiang",  u"枪呛腔羌墙蔷强抢" },
+    { "qiao",   u"橇锹敲悄桥瞧乔侨巧鞘撬翘峭俏窍" },
+    { "qie",    u"切茄且怯窃" },
+    { "qin",    u"钦侵亲秦琴勤芹擒禽寝沁" },
+    { "qing",   u"青轻氢倾卿清擎晴氰情顷请庆" },
+    { "qiong",  u"琼穷" },
+    { "qiu",    u"秋丘邱球求囚酋泅" },
+    { "qu",     u"趋区蛆曲躯屈驱渠取娶龋趣去" },
+    { "quan",   u"圈颧权醛泉全痊拳犬券劝" },
+    { "que",    u"缺炔瘸却鹊榷确雀" },
+    { "qun",    u"裙群" },
+    { "ran",    u"然燃冉染" },
+    { "rang",   u"瓤壤攘嚷让" },
+    { "rao",    u"饶扰绕" },
+    { "re",     u"惹热" },
+    { "ren",    u"壬仁人忍韧任认刃妊纫" },
+    { "reng",   u"扔仍" },
+    { "ri",     u"日" },
+    { "rong",   u"戎茸蓉荣融熔溶容绒冗" },
+    { "rou",    u"揉柔肉" },
+    { "ru",     u"茹蠕儒孺如辱乳汝入褥" },
+    { "ruan",   u"软阮" },
+    { "rui",    u"蕊瑞锐" },
+    { "run",    u"闰润" },
+    { "ruo",    u"若弱" },
+    { "sa",     u"撒洒萨" },
+    { "sai",    u"腮鳃塞赛" },
+    { "san",    u"三叁伞散" },
+    { "sang",   u"桑嗓丧" },
+    { "sao",    u"搔骚扫嫂" },
+    { "se",     u"瑟色涩" },
+    { "sen",    u"森" },
+    { "seng",   u"僧" },
+    { "sha",    u"莎砂杀刹沙纱傻啥煞" },
+    { "shai",   u"筛晒" },
+    { "shan",   u"珊苫杉山删煽衫闪陕擅赡膳善汕扇缮" },
+    { "shang",  u"墒伤商赏晌上尚裳" },
+    { "shao",   u"梢捎稍烧芍勺韶少哨邵绍" },
+    { "she",    u"奢赊蛇舌舍赦摄射慑涉社设" },
+    { "shen",   u"砷申呻伸身深娠绅神沈审婶甚肾慎渗" },
+    { "sheng",  u"声生甥牲升绳省盛剩胜圣" },
+    { "shi",    u"师失狮施湿诗尸虱十石拾时什食蚀实识史矢使屎驶始式示士世柿事拭誓逝势是嗜噬适仕侍释"
+                u"饰氏市恃室视试" },
+    { "shou",   u"收手首守寿授售受瘦兽" },
+    { "shu",    u"蔬枢梳殊抒输叔舒淑疏书赎孰熟薯暑曙署蜀黍鼠属术述树束戍竖墅庶数漱恕" },
+    { "shua",   u"刷耍" },
+    { "shuai",  u"摔衰甩帅" },
+    { "shuan",  u"栓拴" },
+    { "shuang", u"霜双爽" },
+    { "shui",   u"谁水睡税" },
+    { "shun",   u"吮瞬顺舜" },
+    { "shuo",   u"说硕朔烁" },
+    { "si",     u"斯撕嘶思私司丝死肆寺嗣四伺似饲巳" },
+    { "song",   u"松耸怂颂送宋讼诵" },
+    { "sou",    u"搜艘擞" },
+    { "su",     u"嗽苏酥俗素速粟僳塑溯宿诉肃" },
+    { "suan",   u"酸蒜算" },
+    { "sui",    u"虽隋随绥髓碎岁穗遂隧祟" },
+    { "sun",    u"孙损笋" },
+    { "suo",    u"蓑梭唆缩琐索锁所" },
+    { "ta",     u"塌他它她塔獭挞蹋踏" },
+    { "tai",    u"胎苔抬台泰酞太态汰" },
+    { "tan",    u"坍摊贪瘫滩坛檀痰潭谭谈坦毯袒碳探叹炭" },
+    { "tang",   u"汤塘搪堂棠膛唐糖倘躺淌趟烫" },
+    { "tao",    u"掏涛滔绦萄桃逃淘陶讨套" },
+    { "te",     u"特" },
+    { "teng",   u"藤腾疼誊" },
+    { "ti",     u"梯剔踢锑提题蹄啼体替嚏惕涕剃屉" },
+    { "tian",   u"天添填田甜恬舔腆" },
+    { "tiao",   u"挑条迢眺跳" },
+    { "tie",    u"贴铁帖" },
+    { "ting",   u"厅听烃汀廷停亭庭挺艇" },
+    { "tong",   u"通桐酮瞳同铜彤童桶捅筒统痛" },
+    { "tou",    u"偷投头透" },
+    { "tu",     u"凸秃突图徒途涂屠土吐兔" },
+    { "tuan",   u"湍团" },
+    { "tui",    u"推颓腿蜕褪退" },
+    { "tun",    u"吞屯臀" },
+    { "tuo",    u"拖托脱鸵陀驮驼椭妥拓唾" },
+    { "wa",     u"挖哇蛙洼娃瓦袜" },
+    { "wai",    u"歪外" },
+    { "wan",    u"豌弯湾玩顽丸烷完碗挽晚皖惋宛婉万腕" },
+    { "wang",   u"汪王亡枉网往旺望忘妄" },
+    { "wei",    u"威巍微危韦违桅围唯惟为潍维苇萎委伟伪尾纬未蔚味畏胃喂魏位渭谓尉慰卫" },
+    { "wen",    u"瘟温蚊文闻纹吻稳紊问" },
+    { "weng",   u"嗡翁瓮" },
+    { "wo",     u"挝蜗涡窝我斡卧握沃" },
+    { "wu",     u"巫呜钨乌污诬屋无芜梧吾吴毋武五捂午舞伍侮坞戊雾晤物勿务悟误" },
+    { "xi",     u"昔熙析西硒矽晰嘻吸锡牺稀息希悉膝夕惜熄烯溪汐犀檄袭席习媳喜铣洗系隙戏细" },
+    { "xia",    u"瞎虾匣霞辖暇峡侠狭下厦夏吓" },
+    { "xian",   u"掀锨先仙鲜纤咸贤衔舷闲涎弦嫌显险现献县腺馅羡宪陷限线" },
+    { "xiang",  u"相厢镶香箱襄湘乡翔祥详想响享项巷橡像向象" },
+    { "xiao",   u"萧硝霄削哮嚣销消宵淆晓小孝校肖啸笑效" },
+    { "xie",    u"楔些歇蝎鞋协挟携邪斜胁谐写械卸蟹懈泄泻谢屑" },
+    { "xin",    u"薪芯锌欣辛新忻心信衅" },
+    { "xing",   u"星腥猩惺兴刑型形邢行醒幸杏性姓" },
+    { "xiong",  u"兄凶胸匈汹雄熊" },
+    { "xiu",    u"休修羞朽嗅锈秀袖绣" },
+    { "xu",     u"墟戌需虚嘘须徐许蓄酗叙旭序畜恤絮婿绪续" },
+    { "xuan",   u"轩喧宣悬旋玄选癣眩绚" },
+    { "xue",    u"靴薛学穴雪血" },
+    { "xun",    u"勋熏循旬询寻驯巡殉汛训讯逊迅" },
+    { "ya",     u"压押鸦鸭呀丫芽牙蚜崖衙涯雅哑亚讶" },
+    { "yan",    u"焉咽阉烟淹盐严研蜒岩延言颜阎炎沿奄掩眼衍演艳堰燕厌砚雁唁彦焰宴谚验" },
+    { "yang",   u"殃央鸯秧杨扬佯疡羊洋阳氧仰痒养样漾" },
+    { "yao",    u"邀腰妖瑶摇尧遥窑谣姚咬舀药要耀" },
+    { "ye",     u"椰噎耶爷野冶也页掖业叶曳腋夜液" },
+    { "yi",     u"一壹医揖铱依伊衣颐夷遗移仪胰疑沂宜姨彝椅蚁倚已乙矣以艺抑易邑屹亿役臆逸肄疫亦裔意"
+                u"毅忆义益溢诣议谊译异翼翌绎" },
+    { "yin",    u"茵荫因殷音阴姻吟银淫寅饮尹引隐印" },
+    { "ying",   u"英樱婴鹰应缨莹萤营荧蝇迎赢盈影颖硬映" },
+    { "yo",     u"哟" },
+    { "yong",   u"拥佣臃痈庸雍踊蛹咏泳涌永恿勇用" },
+    { "you",    u"幽优悠忧尤由邮铀犹油游酉有友右佑釉诱又幼迂" },
+    { "yu",     u"淤于盂榆虞愚舆余俞逾鱼愉渝渔隅予娱雨与屿禹宇语羽玉域芋郁吁遇喻峪御愈欲狱育誉浴寓"
+                u"裕预豫驭" },
+    { "yuan",   u"鸳渊冤元垣袁原援辕园员圆猿源缘远苑愿怨院" },
+    { "yue",    u"曰约越跃钥岳粤月悦阅" },
+    { "yun",    u"耘云郧匀陨允运蕴酝晕韵孕" },
+    { "za",     u"匝砸杂" },
+    { "zai",    u"栽哉灾宰载再在" },
+    { "zan",    u"咱攒暂赞" },
+    { "zang",   u"赃脏葬" },
+    { "zao",    u"遭糟凿藻枣早澡蚤躁噪造皂灶燥" },
+    { "ze",     u"责择则泽" },
+    { "zei",    u"贼" },
+    { "zen",    u"怎" },
+    { "zeng",   u"增憎曾赠" },
+    { "zha",    u"扎喳渣札轧铡闸眨栅榨咋乍炸诈" },
+    { "zhai",   u"摘斋宅窄债寨" },
+    { "zhan",   u"瞻毡詹粘沾盏斩辗崭展蘸栈占战站湛绽" },
+    { "zhang",  u"樟章彰漳张掌涨杖丈帐账仗胀瘴障" },
+    { "zhao",   u"招昭找沼赵照罩兆肇召" },
+    { "zhe",    u"遮折哲蛰辙者锗蔗这浙" },
+    { "zhen",   u"珍斟真甄砧臻贞针侦枕疹诊震振镇阵" },
+    { "zheng",  u"蒸挣睁征狰争怔整拯正政帧症郑证" },
+    { "zhi",    u"芝枝支吱蜘知肢脂汁之织职直植殖执值侄址指止趾只旨纸志挚掷至致置帜峙制智秩稚质炙痔"
+                u"滞治窒" },
+    { "zhong",  u"中盅忠钟衷终种肿重仲众" },
+    { "zhou",   u"舟周州洲诌粥轴肘帚咒皱宙昼骤" },
+    { "zhu",    u"珠株蛛朱猪诸诛逐竹烛煮拄瞩嘱主著柱助蛀贮铸筑住注祝驻" },
+    { "zhua",   u"抓爪" },
+    { "zhuai",  u"拽" },
+    { "zhuan",  u"专砖转撰赚篆" },
+    { "zhuang", u"桩庄装妆撞壮状" },
+    { "zhui",   u"椎锥追赘坠缀" },
+    { "zhun",   u"谆准" },
+    { "zhuo",   u"捉拙卓桌琢茁酌啄着灼浊" },
+    { "zi",     u"兹咨资姿滋淄孜紫仔籽滓子自渍字" },
+    { "zong",   u"鬃棕踪宗综总纵" },
+    { "zou",    u"邹走奏揍" },
+    { "zu",     u"租足卒族祖诅阻组" },
+    { "zuan",   u"钻纂" },
+    { "zui",    u"嘴醉最罪" },
+    { "zun",    u"尊遵" },
+    { "zuo",    u"昨左佐柞做作坐座" },
+};
+
+// 汉字 -> kGroups下标，首次使用时建立
+const QHash<char16_t, quint16> &syllableTable()
+{
+    static const QHash<char16_t, quint16> table = [] {
+        QHash<char16_t, quint16> t;
+        t.reserve(3800);
+        const int groupCount = int(sizeof(kGroups) / sizeof(kGroups[0]));
+        for (int i = 0; i < groupCount; ++i) {
+            for (const char16_t *p = kGroups[i].chars; *p; ++p) {
+                t.insert(*p, quint16(i));
+            }
+        }
+        return t;
+    }();
+    return table;
+}
+
+bool isLatinOrDigit(QChar ch)
+{
+    return ch.unicode() < 0x80 && ch.isLetterOrNumber();
+}
+
+} // namespace
+
+QString Pinyin::syllableOf(QChar ch)
+{
+    const QHash<char16_t, quint16> &table = syllableTable();
+    auto it = table.constFind(ch.unicode());
+    return it == table.constEnd() ? QString() : QString::fromLatin1(kGroups[it.value()].syllable);
+}
+
+QString Pinyin::fullSpelling(const QString &text)
+{
+    const QHash<char16_t, quint16> &table = syllableTable();
+
+    QString result;
+    result.reserve(text.size() * 4);
+    for (const QChar ch : text) {
+        if (isLatinOrDigit(ch)) {
+            result.append(ch.toLower());
+            continue;
+        }
+        auto it = table.constFind(ch.unicode());
+        if (it != table.constEnd()) {
+            result.append(QLatin1String(kGroups[it.value()].syllable));
+        }
+    }
+    return result;
+}
+
+QString Pinyin::initials(const QString &text)
+{
+    const QHash<char16_t, quint16> &table = syllableTable();
+
+    QString result;
+    result.reserve(text.size());
+    bool inWord = false;   // 是否处于拉丁单词中间
+    for (const QChar ch : text) {
+        if (isLatinOrDigit(ch)) {
+            if (ch.isDigit()) {
+                result.append(ch);
+            } else if (!inWord) {
+                result.append(ch.toLower());
+            }
+            inWord = ch.isLetter();
+            continue;
+        }
+        inWord = false;
+        auto it = table.constFind(ch.unicode());
+        if (it != table.constEnd()) {
+            result.append(QLatin1Char(kGroups[it.value()].syllable[0]));
+        }
+    }
+    return result;
+}
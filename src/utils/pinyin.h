@@ -0,0 +1,25 @@
+// pinyin.h
+#ifndef PINYIN_H
+#define PINYIN_H
+
+#include <QString>
+
+// 汉字转拼音
+// 内置GB2312一级汉字（3755个常用字）的拼音表，不含声调，ü写作v（如"绿" -> lv）。
+// 多音字只取GB2312排序所依据的读音；表外的字（二级汉字、生僻字）在转换结果中略去。
+namespace Pinyin {
+
+// 单个汉字的拼音，不在表中时返回空字符串
+QString syllableOf(QChar ch);
+
+// 全拼：汉字转成拼音连写，拉丁字母和数字转小写保留，其它字符丢弃
+// 例如 "红楼梦" -> "hongloumeng"，"C++程序设计" -> "cchengxusheji"
+QString fullSpelling(const QString &text);
+
+// 首字母：每个汉字取拼音首字母，拉丁单词取首字母，数字保留
+// 例如 "红楼梦" -> "hlm"，"C++程序设计" -> "ccxsj"
+QString initials(const QString &text);
+
+} // namespace Pinyin
+
+#endif // PINYIN_H
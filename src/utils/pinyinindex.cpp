@@ -0,0 +1,262 @@
+// pinyinindex.cpp
+#include "pinyinindex.h"
+#include "pinyin.h"
+#include "searchindex.h"
+#include <QHash>
+#include <QStringList>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace {
+
+// 按空格和标点切段，中英文标点都算分隔符
+QStringList segmentsOf(const QString &text)
+{
+    QStringList segments;
+    int start = -1;
+    for (int i = 0; i <= text.size(); ++i) {
+        const bool sep = (i == text.size()) || !text[i].isLetterOrNumber();
+        if (sep) {
+            if (start >= 0) {
+                segments.append(text.mid(start, i - start));
+                start = -1;
+            }
+        } else if (start < 0) {
+            start = i;
+        }
+    }
+    return segments;
+}
+
+// 删除标记超过有序数组长度的这个比例时归并一次
+const int kMergeDivisor = 8;
+
+// 待归并区的上限取有序数组长度的平方根：插入待归并区和均摊的归并代价都是O(√n)
+int pendingLimit(int entryCount)
+{
+    return std::max(256, int(std::sqrt(double(entryCount))));
+}
+
+} // namespace
+
+bool PinyinIndex::Entry::operator<(const Entry &other) const
+{
+    if (key != other.key) {
+        return key < other.key;
+    }
+    if (slot != other.slot) {
+        return slot < other.slot;
+    }
+    return field < other.field;
+}
+
+bool PinyinIndex::Entry::operator==(const Entry &other) const
+{
+    return slot == other.slot && field == other.field && key == other.key;
+}
+
+void PinyinIndex::clear()
+{
+    entries_.clear();
+    pending_.clear();
+    removedCount_ = 0;
+}
+
+bool PinyinIndex::isEmpty() const
+{
+    return entries_.size() == removedCount_ && pending_.isEmpty();
+}
+
+QString PinyinIndex::normalizeQuery(const QString &query)
+{
+    // 全拼转换会丢掉空格、隔音符号和标点，汉字也一并转成拼音
+    return Pinyin::fullSpelling(query);
+}
+
+QVector<PinyinIndex::Entry> PinyinIndex::entriesFor(int slot, const Book &book)
+{
+    const struct {
+        const QString *text;
+        int field;
+    } fields[] = {
+        { &book.name,   SearchIndex::NameField },
+        { &book.author, SearchIndex::AuthorField },
+    };
+
+    QVector<Entry> result;
+    for (const auto &f : fields) {
+        QStringList parts = segmentsOf(*f.text);
+        if (parts.size() > 1) {
+            parts.prepend(*f.text);   // 整个字段连写，另加每一段
+        }
+
+        QStringList keys;
+        for (const QString &part : std::as_const(parts)) {
+            keys.append(Pinyin::fullSpelling(part));
+            keys.append(Pinyin::initials(part));
+        }
+        keys.removeDuplicates();
+
+        for (const QString &key : std::as_const(keys)) {
+            if (!key.isEmpty()) {
+                result.append(Entry{key, slot, f.field});
+            }
+        }
+    }
+    return result;
+}
+
+void PinyinIndex::build(const QVector<QPair<int, const Book *>> &books)
+{
+    clear();
+    entries_.reserve(books.size() * 4);
+    for (const auto &item : books) {
+        entries_.append(entriesFor(item.first, *item.second));
+    }
+    std::sort(entries_.begin(), entries_.end());
+}
+
+void PinyinIndex::addBook(int slot, const Book &book)
+{
+    const QVector<Entry> added = entriesFor(slot, book);
+    for (const Entry &entry : added) {
+        auto pos = std::lower_bound(entries_.begin(), entries_.end(), entry);
+        if (pos != entries_.end() && *pos == entry) {
+            // 修改时书名/作者没变的键：撤销刚打上的删除标记即可
+            if (pos->removed) {
+                pos->removed = false;
+                --removedCount_;
+            }
+            continue;
+        }
+        auto pendingPos = std::lower_bound(pending_.begin(), pending_.end(), entry);
+        if (pendingPos == pending_.end() || !(*pendingPos == entry)) {
+            pending_.insert(pendingPos, entry);
+        }
+    }
+    mergePendingIfNeeded();
+}
+
+void PinyinIndex::removeBook(int slot, const Book &book)
+{
+    const QVector<Entry> removed = entriesFor(slot, book);
+    for (const Entry &entry : removed) {
+        auto pendingPos = std::lower_bound(pending_.begin(), pending_.end(), entry);
+        if (pendingPos != pending_.end() && *pendingPos == entry) {
+            pending_.erase(pendingPos);
+            continue;
+        }
+        auto pos = std::lower_bound(entries_.begin(), entries_.end(), entry);
+        if (pos != entries_.end() && *pos == entry && !pos->removed) {
+            pos->removed = true;
+            ++removedCount_;
+        }
+    }
+    mergePendingIfNeeded();
+}
+
+void PinyinIndex::mergePendingIfNeeded()
+{
+    if (pending_.size() <= pendingLimit(entries_.size())
+        && removedCount_ <= entries_.size() / kMergeDivisor + 64) {
+        return;
+    }
+
+    // 一次遍历丢掉删除标记并把待归并区归并进来，代价为O(n)
+    QVector<Entry> merged;
+    merged.reserve(entries_.size() - removedCount_ + pending_.size());
+    auto added = pending_.cbegin();
+    for (const Entry &entry : std::as_const(entries_)) {
+        if (entry.removed) {
+            continue;
+        }
+        while (added != pending_.cend() && *added < entry) {
+            merged.append(*added++);
+        }
+        merged.append(entry);
+    }
+    while (added != pending_.cend()) {
+        merged.append(*added++);
+    }
+
+    entries_ = merged;
+    pending_.clear();
+    removedCount_ = 0;
+}
+
+void PinyinIndex::updateBook(int slot, const Book &oldBook, const Book &newBook)
+{
+    removeBook(slot, oldBook);
+    addBook(slot, newBook);
+}
+
+int PinyinIndex::scoreEntry(const Entry &entry, const QString &prefix)
+{
+    // 书名命中优先于作者，完整匹配优先于前缀匹配
+    return (entry.field == SearchIndex::NameField ? 4 : 2)
+         + (entry.key.size() == prefix.size() ? 1 : 0);
+}
+
+int PinyinIndex::scoreBook(const Book &book, const QString &query, int fieldMask)
+{
+    const QString prefix = normalizeQuery(query);
+    if (prefix.isEmpty()) {
+        return -1;
+    }
+
+    int best = -1;
+    const QVector<Entry> entries = entriesFor(0, book);
+    for (const Entry &entry : entries) {
+        if ((entry.field & fieldMask) && entry.key.startsWith(prefix)) {
+            best = std::max(best, scoreEntry(entry, prefix));
+        }
+    }
+    return best;
+}
+
+QVector<int> PinyinIndex::search(const QString &query, int fieldMask) const
+{
+    const QString prefix = normalizeQuery(query);
+    if (prefix.isEmpty()) {
+        return QVector<int>();
+    }
+
+    QHash<int, int> bestScore;
+    const Entry probe{prefix, INT_MIN, 0};
+    const auto collect = [&](const Entry &entry) {
+        if (entry.removed || !(entry.field & fieldMask)) {
+            return;
+        }
+        int &best = bestScore[entry.slot];
+        best = std::max(best, scoreEntry(entry, prefix));
+    };
+    for (auto it = std::lower_bound(entries_.begin(), entries_.end(), probe);
+         it != entries_.end() && it->key.startsWith(prefix); ++it) {
+        collect(*it);
+    }
+    for (auto it = std::lower_bound(pending_.begin(), pending_.end(), probe);
+         it != pending_.end() && it->key.startsWith(prefix); ++it) {
+        collect(*it);
+    }
+
+    struct Candidate {
+        int slot;
+        int score;
+    };
+    QVector<Candidate> candidates;
+    candidates.reserve(bestScore.size());
+    for (auto it = bestScore.constBegin(); it != bestScore.constEnd(); ++it) {
+        candidates.append(Candidate{it.key(), it.value()});
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        return a.score != b.score ? a.score > b.score : a.slot < b.slot;
+    });
+
+    QVector<int> result;
+    result.reserve(candidates.size());
+    for (const Candidate &c : std::as_const(candidates)) {
+        result.append(c.slot);
+    }
+    return result;
+}
@@ -0,0 +1,59 @@
+// pinyinindex.h
+#ifndef PINYININDEX_H
+#define PINYININDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QPair>
+#include "book.h"
+
+// 书名/作者的拼音前缀索引
+// 每个字段生成全拼和首字母两类键（如"红楼梦" -> hongloumeng / hlm），文本中按空格、
+// 标点分开的每一段也各自生成键，以便从副标题或外文名开始输入。
+// 所有键放在一个按字典序排列的数组中，前缀查询用二分定位起点后顺序扫描，
+// 输入 hlm、honglou、hong 都能找到"红楼梦"。
+// 增删不在大数组中间插入或移除：新键先放进一段有序的小待归并区（上限约为√n），
+// 删除只打标记，积压满了再一次归并，每次增删的均摊代价为O(√n)而不是O(n)。
+class PinyinIndex
+{
+public:
+    void clear();
+    bool isEmpty() const;
+
+    // 加载时批量建立：先追加再统一排序
+    void build(const QVector<QPair<int, const Book *>> &books);
+
+    // 增量维护：槽位号即DatabaseManager中的槽位
+    void addBook(int slot, const Book &book);
+    void removeBook(int slot, const Book &book);
+    void updateBook(int slot, const Book &oldBook, const Book &newBook);
+
+    // 按前缀查找，fieldMask取SearchIndex::NameField/AuthorField的组合；
+    // 结果按书名优先、完整匹配优先排序，同级保持槽位顺序
+    QVector<int> search(const QString &query, int fieldMask) const;
+    // 单独判断一本书是否命中，返回与search()一致的得分，未命中返回-1
+    static int scoreBook(const Book &book, const QString &query, int fieldMask);
+
+    // 把用户输入规范成索引键的形式：小写，去掉空格和隔音符号，汉字转全拼
+    static QString normalizeQuery(const QString &query);
+
+private:
+    struct Entry {
+        QString key;
+        int slot;
+        int field;      // SearchIndex::NameField 或 AuthorField
+        bool removed = false;   // 已删除，下次归并时丢弃；不参与比较
+        bool operator<(const Entry &other) const;
+        bool operator==(const Entry &other) const;
+    };
+
+    static QVector<Entry> entriesFor(int slot, const Book &book);
+    static int scoreEntry(const Entry &entry, const QString &prefix);
+    void mergePendingIfNeeded();
+
+    QVector<Entry> entries_;   // 按 key, slot, field 排序
+    QVector<Entry> pending_;   // 新增且尚未归并的键，同样有序
+    int removedCount_ = 0;     // entries_中打了删除标记的项数
+};
+
+#endif // PINYININDEX_H
@@ -0,0 +1,351 @@
+// searchindex.cpp
+#include "searchindex.h"
+#include <QSet>
+#include <algorithm>
+
+namespace {
+
+bool isWordChar(QChar ch)
+{
+    return ch.isLetterOrNumber() && !SearchIndex::isCjk(ch);
+}
+
+// 字母数字混合的词额外拆成字母段和数字段，例如 cs001 -> cs, 001
+void appendWordTokens(const QString &word, QStringList &tokens)
+{
+    tokens.append(word);
+
+    int start = 0;
+    for (int i = 1; i <= word.size(); ++i) {
+        if (i == word.size() || word[i].isDigit() != word[start].isDigit()) {
+            if (start > 0 || i < word.size()) {
+                tokens.append(word.mid(start, i - start));
+            }
+            start = i;
+        }
+    }
+}
+
+} // namespace
+
+bool SearchIndex::isCjk(QChar ch)
+{
+    const ushort u = ch.unicode();
+    return (u >= 0x3400 && u <= 0x9FFF)    // CJK统一汉字及扩展A
+        || (u >= 0xF900 && u <= 0xFAFF)    // CJK兼容汉字
+        || (u >= 0x3040 && u <= 0x30FF)    // 日文假名
+        || (u >= 0xAC00 && u <= 0xD7AF);   // 韩文音节
+}
+
+QStringList SearchIndex::tokenize(const QString &lowerText)
+{
+    QStringList tokens;
+    const int n = lowerText.size();
+    int i = 0;
+
+    while (i < n) {
+        const QChar ch = lowerText[i];
+        if (isCjk(ch)) {
+            // 中文：每个字一个单字词，相邻两字一个双字词
+            int j = i;
+            while (j < n && isCjk(lowerText[j])) {
+                tokens.append(lowerText.mid(j, 1));
+                if (j + 1 < n && isCjk(lowerText[j + 1])) {
+                    tokens.append(lowerText.mid(j, 2));
+                }
+                ++j;
+            }
+            i = j;
+        } else if (isWordChar(ch)) {
+            int j = i;
+            while (j < n && isWordChar(lowerText[j])) {
+                ++j;
+            }
+            appendWordTokens(lowerText.mid(i, j - i), tokens);
+            i = j;
+        } else {
+            ++i;  // 空白和标点作为分隔符
+        }
+    }
+    return tokens;
+}
+
+QStringList SearchIndex::queryTerms(const QString &lowerQuery)
+{
+    QStringList terms;
+    const int n = lowerQuery.size();
+    int i = 0;
+
+    while (i < n) {
+        const QChar ch = lowerQuery[i];
+        if (isCjk(ch)) {
+            int j = i;
+            while (j < n && isCjk(lowerQuery[j])) {
+                ++j;
+            }
+            if (j - i == 1) {
+                terms.append(lowerQuery.mid(i, 1));
+            } else {
+                for (int k = i; k + 1 < j; ++k) {
+                    terms.append(lowerQuery.mid(k, 2));
+                }
+            }
+            i = j;
+        } else if (isWordChar(ch)) {
+            int j = i;
+            while (j < n && isWordChar(lowerQuery[j])) {
+                ++j;
+            }
+            terms.append(lowerQuery.mid(i, j - i));
+            i = j;
+        } else {
+            ++i;
+        }
+    }
+
+    terms.removeDuplicates();
+    return terms;
+}
+
+void SearchIndex::clear()
+{
+    cjkTerms_.clear();
+    wordTerms_.clear();
+}
+
+bool SearchIndex::isEmpty() const
+{
+    return cjkTerms_.isEmpty() && wordTerms_.isEmpty();
+}
+
+QHash<QString, int> SearchIndex::collectTerms(const Book &book)
+{
+    const struct {
+        const QString *text;
+        int field;
+    } fields[] = {
+        { &book.indexId,     IndexIdField },
+        { &book.name,        NameField },
+        { &book.author,      AuthorField },
+        { &book.publisher,   PublisherField },
+        { &book.category,    CategoryField },
+        { &book.location,    LocationField },
+        { &book.description, DescriptionField },
+    };
+
+    QHash<QString, int> termFields;
+    for (const auto &f : fields) {
+        const QStringList tokens = tokenize(f.text->toLower());
+        for (const QString &token : tokens) {
+            termFields[token] |= f.field;
+        }
+    }
+    return termFields;
+}
+
+void SearchIndex::addBook(int slot, const Book &book)
+{
+    const QHash<QString, int> termFields = collectTerms(book);
+    for (auto it = termFields.constBegin(); it != termFields.constEnd(); ++it) {
+        insertPosting(it.key(), slot, it.value());
+    }
+}
+
+void SearchIndex::removeBook(int slot, const Book &book)
+{
+    const QHash<QString, int> termFields = collectTerms(book);
+    for (auto it = termFields.constBegin(); it != termFields.constEnd(); ++it) {
+        removePosting(it.key(), slot);
+    }
+}
+
+void SearchIndex::updateBook(int slot, const Book &oldBook, const Book &newBook)
+{
+    removeBook(slot, oldBook);
+    addBook(slot, newBook);
+}
+
+void SearchIndex::insertPosting(const QString &term, int slot, int fields)
+{
+    PostingList &list = isCjk(term[0]) ? cjkTerms_[term] : wordTerms_[term];
+
+    // 新书的槽位总是最大的，通常直接追加；更新时才需要二分插入
+    if (list.isEmpty() || list.last().slot < slot) {
+        list.append(Posting{slot, fields});
+        return;
+    }
+
+    auto pos = std::lower_bound(list.begin(), list.end(), slot,
+                                [](const Posting &p, int s) { return p.slot < s; });
+    if (pos != list.end() && pos->slot == slot) {
+        pos->fields |= fields;
+    } else {
+        list.insert(pos, Posting{slot, fields});
+    }
+}
+
+void SearchIndex::removePosting(const QString &term, int slot)
+{
+    auto removeFrom = [slot](PostingList &list) {
+        auto pos = std::lower_bound(list.begin(), list.end(), slot,
+                                    [](const Posting &p, int s) { return p.slot < s; });
+        if (pos != list.end() && pos->slot == slot) {
+            list.erase(pos);
+        }
+        return list.isEmpty();
+    };
+
+    if (isCjk(term[0])) {
+        auto it = cjkTerms_.find(term);
+        if (it != cjkTerms_.end() && removeFrom(it.value())) {
+            cjkTerms_.erase(it);
+        }
+    } else {
+        auto it = wordTerms_.find(term);
+        if (it != wordTerms_.end() && removeFrom(it.value())) {
+            wordTerms_.erase(it);
+        }
+    }
+}
+
+SearchIndex::PostingList SearchIndex::lookup(const QString &term) const
+{
+    if (isCjk(term[0])) {
+        return cjkTerms_.value(term);
+    }
+
+    // 拉丁词按前缀匹配：合并所有以该词开头的索引词的倒排表
+    PostingList merged;
+    auto it = wordTerms_.lowerBound(term);
+    for (; it != wordTerms_.constEnd() && it.key().startsWith(term); ++it) {
+        if (merged.isEmpty()) {
+            merged = it.value();
+        } else {
+            merged.append(it.value());
+        }
+    }
+
+    if (merged.isEmpty()) {
+        return merged;
+    }
+
+    std::sort(merged.begin(), merged.end(), [](const Posting &a, const Posting &b) {
+        return a.slot < b.slot;
+    });
+
+    // 合并同一槽位的字段
+    int out = 0;
+    for (int i = 1; i < merged.size(); ++i) {
+        if (merged[i].slot == merged[out].slot) {
+            merged[out].fields |= merged[i].fields;
+        } else {
+            merged[++out] = merged[i];
+        }
+    }
+    merged.resize(out + 1);
+    return merged;
+}
+
+int SearchIndex::fieldScore(int fields)
+{
+    int score = 0;
+    if (fields & NameField)        score += 10;
+    if (fields & IndexIdField)     score += 8;
+    if (fields & AuthorField)      score += 6;
+    if (fields & PublisherField)   score += 3;
+    if (fields & CategoryField)    score += 3;
+    if (fields & LocationField)    score += 2;
+    if (fields & DescriptionField) score += 1;
+    return score;
+}
+
+int SearchIndex::scoreBook(const Book &book, const QString &query, int fieldMask)
+{
+    const QStringList terms = queryTerms(query.toLower());
+    if (terms.isEmpty()) {
+        return -1;
+    }
+
+    const QHash<QString, int> termFields = collectTerms(book);
+    int score = 0;
+    for (const QString &term : terms) {
+        int fields = 0;
+        if (isCjk(term[0])) {
+            fields = termFields.value(term);
+        } else {
+            // 与lookup()一致：拉丁词按前缀匹配
+            for (auto it = termFields.constBegin(); it != termFields.constEnd(); ++it) {
+                if (it.key().startsWith(term)) {
+                    fields |= it.value();
+                }
+            }
+        }
+        if (!(fields & fieldMask)) {
+            return -1;
+        }
+        score += fieldScore(fields & fieldMask);
+    }
+    return score;
+}
+
+QVector<int> SearchIndex::search(const QString &query, int fieldMask) const
+{
+    const QStringList terms = queryTerms(query.toLower());
+    if (terms.isEmpty()) {
+        return QVector<int>();
+    }
+
+    // 取出每个检索词的倒排表，从最短的开始求交集
+    QVector<PostingList> lists;
+    lists.reserve(terms.size());
+    for (const QString &term : terms) {
+        PostingList list = lookup(term);
+        if (list.isEmpty()) {
+            return QVector<int>();
+        }
+        lists.append(list);
+    }
+    std::sort(lists.begin(), lists.end(), [](const PostingList &a, const PostingList &b) {
+        return a.size() < b.size();
+    });
+
+    struct Candidate {
+        int slot;
+        int score;
+    };
+    QVector<Candidate> candidates;
+    candidates.reserve(lists.first().size());
+    for (const Posting &p : lists.first()) {
+        if (p.fields & fieldMask) {
+            candidates.append(Candidate{p.slot, fieldScore(p.fields & fieldMask)});
+        }
+    }
+
+    for (int i = 1; i < lists.size() && !candidates.isEmpty(); ++i) {
+        const PostingList &list = lists[i];
+        int out = 0;
+        int j = 0;
+        for (int k = 0; k < candidates.size() && j < list.size(); ++k) {
+            const Candidate c = candidates[k];
+            while (j < list.size() && list[j].slot < c.slot) {
+                ++j;
+            }
+            if (j < list.size() && list[j].slot == c.slot && (list[j].fields & fieldMask)) {
+                candidates[out++] = Candidate{c.slot, c.score + fieldScore(list[j].fields & fieldMask)};
+            }
+        }
+        candidates.resize(out);
+    }
+
+    // 相关度高的在前，相同时保持入库（槽位）顺序
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        return a.score > b.score;
+    });
+
+    QVector<int> result;
+    result.reserve(candidates.size());
+    for (const Candidate &c : std::as_const(candidates)) {
+        result.append(c.slot);
+    }
+    return result;
+}
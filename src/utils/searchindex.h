@@ -0,0 +1,70 @@
+// searchindex.h
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include "book.h"
+
+// 图书全文倒排索引
+// - 中文（CJK）连续文字切成单字和相邻双字（bigram），查询时单字查单字、多字查全部双字
+// - 拉丁字母/数字按单词切分，字母数字混合的词（如 cs001）额外拆出纯字母段和纯数字段，
+//   查询词按前缀匹配，以兼容"输入一半"的搜索习惯
+// 倒排表按DatabaseManager槽位号升序保存，多词查询时对倒排表求交集，并按命中字段加权排序。
+// 索引只包含Qt隐式共享容器，可以廉价地复制一份交给后台线程查询。
+class SearchIndex
+{
+public:
+    // 可检索的字段，可按位组合
+    enum Field {
+        IndexIdField     = 0x01,
+        NameField        = 0x02,
+        AuthorField      = 0x04,
+        PublisherField   = 0x08,
+        CategoryField    = 0x10,
+        LocationField    = 0x20,
+        DescriptionField = 0x40,
+        AllFields        = 0x7F
+    };
+
+    void clear();
+    bool isEmpty() const;
+
+    // 增量维护：槽位号即DatabaseManager中的槽位
+    void addBook(int slot, const Book &book);
+    void removeBook(int slot, const Book &book);
+    void updateBook(int slot, const Book &oldBook, const Book &newBook);
+
+    // 按相关度从高到低返回匹配的槽位；fieldMask限定只在哪些字段中匹配
+    QVector<int> search(const QString &query, int fieldMask = AllFields) const;
+    // 单独判断一本书是否命中查询，返回与search()一致的相关度得分，未命中返回-1；
+    // 用于在上一次结果中细化查询，不访问索引本身
+    static int scoreBook(const Book &book, const QString &query, int fieldMask = AllFields);
+
+    // 把文本切分成索引词（文本应已转为小写）
+    static QStringList tokenize(const QString &lowerText);
+    // 把查询切分成检索词：单个汉字保留单字，多个汉字只取双字
+    static QStringList queryTerms(const QString &lowerQuery);
+    static bool isCjk(QChar ch);
+
+private:
+    struct Posting {
+        int slot;
+        int fields;   // 该词出现在哪些字段中
+    };
+    using PostingList = QVector<Posting>;
+
+    static QHash<QString, int> collectTerms(const Book &book);
+    void insertPosting(const QString &term, int slot, int fields);
+    void removePosting(const QString &term, int slot);
+    PostingList lookup(const QString &term) const;
+    static int fieldScore(int fields);
+
+    QHash<QString, PostingList> cjkTerms_;   // 中文单字/双字 -> 倒排表
+    QMap<QString, PostingList> wordTerms_;   // 拉丁单词 -> 倒排表，有序以支持前缀查找
+};
+
+#endif // SEARCHINDEX_H
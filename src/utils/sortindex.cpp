@@ -0,0 +1,276 @@
+// sortindex.cpp
+#include "sortindex.h"
+#include "book.h"
+#include "bookstore.h"
+#include "stringpool.h"
+#include <algorithm>
+
+namespace {
+
+// 积压的改动超过表长的这个比例时整体重建，比逐个归并更快
+const int kRebuildDivisor = 8;
+
+} // namespace
+
+SortIndex::SortIndex()
+{
+    std::fill(built_, built_ + KeyCount, false);
+}
+
+void SortIndex::clear()
+{
+    for (int key = 0; key < KeyCount; ++key) {
+        order_[key].clear();
+        pending_[key].clear();
+        built_[key] = false;
+    }
+    nameKeys_.clear();
+    keyedNames_.clear();
+}
+
+void SortIndex::markDirty(int slot)
+{
+    for (int key = 0; key < KeyCount; ++key) {
+        markKeyDirty(Key(key), slot);
+    }
+}
+
+void SortIndex::markKeyDirty(Key key, int slot)
+{
+    if (!built_[key]) {
+        return;
+    }
+    pending_[key].append(slot);
+    if (pending_[key].size() > order_[key].size() / kRebuildDivisor + 64) {
+        // 积压太多，放弃增量维护，下次使用时重建
+        built_[key] = false;
+        order_[key].clear();
+        pending_[key].clear();
+    }
+}
+
+void SortIndex::updateSlot(int slot, const Book &oldBook, const BookStore &store)
+{
+    const Book &newBook = *store.bookAt(slot);
+    if (newBook.borrowCount != oldBook.borrowCount) {
+        moveBorrowCount(slot, oldBook.borrowCount, store);
+    }
+    if (newBook.price != oldBook.price) {
+        markKeyDirty(PriceKey, slot);
+    }
+    if (newBook.inDate != oldBook.inDate) {
+        markKeyDirty(InDateKey, slot);
+    }
+    if (newBook.name != oldBook.name) {
+        markKeyDirty(NameKey, slot);
+    }
+    if (newBook.category != oldBook.category) {
+        markKeyDirty(CategoryKey, slot);
+    }
+    if (newBook.location != oldBook.location) {
+        markKeyDirty(LocationKey, slot);
+    }
+}
+
+void SortIndex::moveBorrowCount(int slot, int oldCount, const BookStore &store)
+{
+    // 表中还有未归并的槽位时顺序不完整，无法二分，照常记下
+    QVector<int> &slotList = order_[BorrowCountKey];
+    if (!built_[BorrowCountKey] || !pending_[BorrowCountKey].isEmpty()) {
+        markKeyDirty(BorrowCountKey, slot);
+        return;
+    }
+
+    // 按旧值找到该槽位：借阅次数降序，同值按槽位号升序
+    auto oldPos = std::partition_point(slotList.begin(), slotList.end(), [&](int other) {
+        const int count = store.borrowCountAt(other);
+        return count != oldCount ? count > oldCount : other < slot;
+    });
+    if (oldPos == slotList.end() || *oldPos != slot) {
+        markKeyDirty(BorrowCountKey, slot);
+        return;
+    }
+
+    // 只挪动新旧位置之间的元素，借还一次通常只越过同值的几本书
+    const auto slotLess = [&](int a, int b) { return less(BorrowCountKey, a, b, store); };
+    if (store.borrowCountAt(slot) > oldCount) {
+        auto newPos = std::lower_bound(slotList.begin(), oldPos, slot, slotLess);
+        std::rotate(newPos, oldPos, oldPos + 1);
+    } else {
+        auto newPos = std::lower_bound(oldPos + 1, slotList.end(), slot, slotLess);
+        std::rotate(oldPos, oldPos + 1, newPos);
+    }
+}
+
+void SortIndex::removeSlot(int slot, const BookStore &store)
+{
+    for (int key = 0; key < KeyCount; ++key) {
+        if (!built_[key]) {
+            continue;
+        }
+        QVector<int> &slotList = order_[key];
+        if (pending_[key].isEmpty()) {
+            if (key == CategoryKey || key == LocationKey) {
+                collationRanks_ = StringPool::instance().collationRanks();
+            }
+            auto pos = std::lower_bound(slotList.begin(), slotList.end(), slot, [&](int a, int b) {
+                return less(Key(key), a, b, store);
+            });
+            if (pos != slotList.end() && *pos == slot) {
+                slotList.erase(pos);
+                continue;
+            }
+        }
+        markKeyDirty(Key(key), slot);
+    }
+}
+
+void SortIndex::prepareKeys(Key key, const BookStore &store)
+{
+    if (key == CategoryKey || key == LocationKey) {
+        // 新驻留的值会改变名次的编号，但不会改变已有值之间的先后，已排好的表仍然有效
+        collationRanks_ = StringPool::instance().collationRanks();
+    } else if (key == NameKey) {
+        order(NameKey, store);   // 确保书名排序键是最新的
+    }
+}
+
+const QVector<int>& SortIndex::order(Key key, const BookStore &store)
+{
+    if (key == CategoryKey || key == LocationKey) {
+        prepareKeys(key, store);
+    }
+    if (!built_[key]) {
+        rebuild(key, store);
+    } else if (!pending_[key].isEmpty()) {
+        applyPending(key, store);
+    }
+    return order_[key];
+}
+
+void SortIndex::sortSlots(Key key, QVector<int> &slotList, const BookStore &store)
+{
+    prepareKeys(key, store);
+    std::stable_sort(slotList.begin(), slotList.end(), [&](int a, int b) {
+        return compare(key, a, b, store) < 0;
+    });
+}
+
+int SortIndex::compare(Key key, int a, int b, const BookStore &store) const
+{
+    switch (key) {
+    case BorrowCountKey:
+        return store.borrowCountAt(b) - store.borrowCountAt(a);
+    case PriceKey:
+        return store.priceAt(a) > store.priceAt(b) ? -1 : (store.priceAt(a) < store.priceAt(b) ? 1 : 0);
+    case InDateKey:
+        return store.inDayAt(a) > store.inDayAt(b) ? -1 : (store.inDayAt(a) < store.inDayAt(b) ? 1 : 0);
+    case NameKey:
+        return nameKeys_[a].compare(nameKeys_[b]);
+    case CategoryKey:
+        return collationRanks_[store.categoryIdAt(a)] - collationRanks_[store.categoryIdAt(b)];
+    case LocationKey:
+        return collationRanks_[store.locationIdAt(a)] - collationRanks_[store.locationIdAt(b)];
+    default:
+        return 0;
+    }
+}
+
+bool SortIndex::less(Key key, int a, int b, const BookStore &store) const
+{
+    const int c = compare(key, a, b, store);
+    return c != 0 ? c < 0 : a < b;
+}
+
+void SortIndex::rebuild(Key key, const BookStore &store)
+{
+    const int n = store.size();
+
+    if (key == NameKey) {
+        nameKeys_.clear();
+        keyedNames_.clear();
+        nameKeys_.reserve(n);
+        keyedNames_.reserve(n);
+        const QCollatorSortKey emptyKey = collator_.sortKey(QString());
+        for (int slot = 0; slot < n; ++slot) {
+            const QString name = store.isLive(slot) ? store.bookAt(slot)->name : QString();
+            nameKeys_.append(name.isEmpty() ? emptyKey : collator_.sortKey(name));
+            keyedNames_.append(name);
+        }
+    }
+
+    QVector<int> &slotList = order_[key];
+    slotList.clear();
+    slotList.reserve(n);
+    for (int slot = 0; slot < n; ++slot) {
+        if (store.isLive(slot)) {
+            slotList.append(slot);
+        }
+    }
+    std::sort(slotList.begin(), slotList.end(), [&](int a, int b) {
+        return less(key, a, b, store);
+    });
+
+    pending_[key].clear();
+    built_[key] = true;
+}
+
+void SortIndex::applyPending(Key key, const BookStore &store)
+{
+    QVector<int> &pending = pending_[key];
+    std::sort(pending.begin(), pending.end());
+    pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+
+    if (key == NameKey) {
+        for (int slot : std::as_const(pending)) {
+            updateNameKey(slot, store);
+        }
+    }
+
+    // 1. 把改动过的槽位从有序表中剔除，其余槽位的相对顺序不变
+    QVector<quint8> touched(store.size(), 0);
+    for (int slot : std::as_const(pending)) {
+        touched[slot] = 1;
+    }
+    QVector<int> kept;
+    kept.reserve(order_[key].size());
+    for (int slot : std::as_const(order_[key])) {
+        if (!touched[slot]) {
+            kept.append(slot);
+        }
+    }
+
+    // 2. 仍然有效的改动槽位单独排序后归并回去
+    QVector<int> added;
+    for (int slot : std::as_const(pending)) {
+        if (store.isLive(slot)) {
+            added.append(slot);
+        }
+    }
+    std::sort(added.begin(), added.end(), [&](int a, int b) {
+        return less(key, a, b, store);
+    });
+
+    QVector<int> merged(kept.size() + added.size());
+    std::merge(kept.cbegin(), kept.cend(), added.cbegin(), added.cend(), merged.begin(),
+               [&](int a, int b) { return less(key, a, b, store); });
+
+    order_[key] = merged;
+    pending.clear();
+}
+
+void SortIndex::updateNameKey(int slot, const BookStore &store)
+{
+    while (nameKeys_.size() <= slot) {
+        nameKeys_.append(collator_.sortKey(QString()));
+        keyedNames_.append(QString());
+    }
+
+    // 借还等只改数值列的修改不会改变书名，排序键继续有效
+    const QString name = store.isLive(slot) ? store.bookAt(slot)->name : QString();
+    if (name == keyedNames_[slot]) {
+        return;
+    }
+    nameKeys_[slot] = collator_.sortKey(name);
+    keyedNames_[slot] = name;
+}
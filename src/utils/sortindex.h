@@ -0,0 +1,71 @@
+// sortindex.h
+#ifndef SORTINDEX_H
+#define SORTINDEX_H
+
+#include <QVector>
+#include <QCollator>
+#include <QCollatorSortKey>
+#include <QString>
+
+class BookStore;
+struct Book;
+
+// 排序索引：按借阅次数、价格、入库日期、书名、类别、馆藏地址各维护一份排好序的有效槽位表
+// - 某种排序第一次被用到时才建立；建立后新增的图书只记下槽位号，
+//   下次读取时把这些槽位从表中剔除、排好序后再归并回去，代价为O(n + k log k)，
+//   批量导入时不会每本书移动一次整张表；积压太多时直接重建
+// - 修改图书时只有排序字段真的变了的表才受影响：借阅次数的变化直接在表中挪动该槽位，
+//   其余字段的变化照常记下槽位；删除时直接从各表中二分找到并移除该槽位
+// - 取前k本或某一页只需截取有序表，不必再对全部图书排序
+// - 书名按当前区域设置的排序规则比较，每本书的排序键（QCollator::sortKey）只计算一次，
+//   之后只有书名真的改变时才重新计算；类别/馆藏地址比较StringPool缓存的区域排序名次
+// - 同值的图书按槽位号（入库顺序）排列，排序结果稳定
+class SortIndex
+{
+public:
+    enum Key {
+        BorrowCountKey,   // 借阅次数，从高到低
+        PriceKey,         // 价格，从高到低
+        InDateKey,        // 入库日期，从新到旧
+        NameKey,          // 书名，按区域排序规则升序
+        CategoryKey,      // 类别，按区域排序规则升序
+        LocationKey,      // 馆藏地址，按区域排序规则升序
+        KeyCount
+    };
+
+    SortIndex();
+
+    // 丢弃所有排序表，下次使用时重建
+    void clear();
+    // 槽位被追加后调用（须在存储更新之后）
+    void markDirty(int slot);
+    // 槽位被修改后调用（须在存储更新之后），oldBook为修改前的记录
+    void updateSlot(int slot, const Book &oldBook, const BookStore &store);
+    // 槽位被删除前调用（须在存储更新之前，此时仍能读到该书的排序字段）
+    void removeSlot(int slot, const BookStore &store);
+
+    // 全部有效槽位，按key排好序；返回的表隐式共享，复制代价为常数
+    const QVector<int>& order(Key key, const BookStore &store);
+    // 按key对给定槽位做稳定排序（同值时保持原有顺序，如搜索相关度）
+    void sortSlots(Key key, QVector<int> &slotList, const BookStore &store);
+
+private:
+    int compare(Key key, int a, int b, const BookStore &store) const;
+    bool less(Key key, int a, int b, const BookStore &store) const;
+    void markKeyDirty(Key key, int slot);
+    void moveBorrowCount(int slot, int oldCount, const BookStore &store);
+    void rebuild(Key key, const BookStore &store);
+    void applyPending(Key key, const BookStore &store);
+    void updateNameKey(int slot, const BookStore &store);
+    void prepareKeys(Key key, const BookStore &store);
+
+    QVector<int> order_[KeyCount];
+    QVector<int> pending_[KeyCount];     // 建立之后改动过的槽位
+    bool built_[KeyCount];
+    QCollator collator_;
+    QVector<QCollatorSortKey> nameKeys_; // 槽位 -> 书名排序键，书名表建立后才维护
+    QVector<QString> keyedNames_;        // 槽位 -> 计算排序键时的书名（与图书隐式共享）
+    QVector<int> collationRanks_;        // 驻留编号 -> 区域排序名次（取自StringPool）
+};
+
+#endif // SORTINDEX_H
@@ -0,0 +1,92 @@
+// stringpool.cpp
+#include "stringpool.h"
+#include <algorithm>
+
+StringPool& StringPool::instance()
+{
+    static StringPool instance;
+    return instance;
+}
+
+StringPool::StringPool()
+{
+    strings_.append(QString());   // 编号0：空字符串
+}
+
+QString StringPool::intern(const QString &s)
+{
+    return stringOf(idOf(s));
+}
+
+int StringPool::idOf(const QString &s)
+{
+    if (s.isEmpty()) {
+        return 0;
+    }
+
+    auto it = ids_.constFind(s);
+    if (it != ids_.constEnd()) {
+        return it.value();
+    }
+
+    const int id = strings_.size();
+    strings_.append(s);
+    ids_.insert(s, id);
+    return id;
+}
+
+int StringPool::findId(const QString &s) const
+{
+    if (s.isEmpty()) {
+        return 0;
+    }
+    return ids_.value(s, -1);
+}
+
+const QString& StringPool::stringOf(int id) const
+{
+    return (id >= 0 && id < strings_.size()) ? strings_[id] : strings_[0];
+}
+
+int StringPool::size() const
+{
+    return strings_.size();
+}
+
+const QCollatorSortKey& StringPool::collationKey(int id)
+{
+    if (id < 0 || id >= strings_.size()) {
+        id = 0;
+    }
+    // 编号只增不减，按编号顺序补齐缺少的排序键
+    keys_.reserve(strings_.size());
+    while (keys_.size() <= id) {
+        keys_.append(collator_.sortKey(strings_[keys_.size()]));
+    }
+    return keys_[id];
+}
+
+const QVector<int>& StringPool::collationRanks()
+{
+    if (ranks_.size() == strings_.size()) {
+        return ranks_;
+    }
+
+    const int n = strings_.size();
+    collationKey(n - 1);   // 补齐全部排序键
+
+    QVector<int> ids(n);
+    for (int id = 0; id < n; ++id) {
+        ids[id] = id;
+    }
+    std::sort(ids.begin(), ids.end(), [this](int a, int b) {
+        const int c = keys_[a].compare(keys_[b]);
+        return c != 0 ? c < 0 : a < b;
+    });
+
+    ranks_.resize(n);
+    for (int rank = 0; rank < n; ++rank) {
+        ranks_[ids[rank]] = rank;
+    }
+    return ranks_;
+}
@@ -0,0 +1,51 @@
+// stringpool.h
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QCollator>
+#include <QCollatorSortKey>
+
+// 低基数文本的驻留池
+// 馆藏地址、类别、出版社、作者，以及副本的索引号和借阅者，不同取值很少却在每条记录里各存一份。
+// 驻留后相同的值共享同一份QString数据（隐式共享），每条记录只剩一个指针；
+// 每个值还分配一个小整数编号，类别/馆藏地址筛选时直接比较编号。
+// 编号从1开始，0固定表示空字符串。池只增不减，只在主线程使用，不加锁。
+// 每个驻留值的区域排序键（QCollator::sortKey）在第一次用到时计算并存放在值旁边，
+// 驻留值不会改变，排序键也就不会失效；按类别、馆藏地址排序时比较的是排序键或名次，
+// 不再每次比较都调用 localeAwareCompare。
+class StringPool
+{
+public:
+    static StringPool& instance();
+
+    // 返回与s相等的驻留副本，之后对它的复制都共享同一份数据
+    QString intern(const QString &s);
+    // 驻留并返回编号
+    int idOf(const QString &s);
+    // 只查不驻留，从未出现过的值返回-1
+    int findId(const QString &s) const;
+    const QString& stringOf(int id) const;
+    int size() const;
+
+    // 编号对应值的区域排序键，按需计算后缓存
+    const QCollatorSortKey& collationKey(int id);
+    // 编号 -> 该值在全部驻留值中按区域排序规则的名次，比较名次即可得到区域顺序；
+    // 驻留了新值后下次调用时重新计算
+    const QVector<int>& collationRanks();
+
+private:
+    StringPool();
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    QHash<QString, int> ids_;
+    QVector<QString> strings_;   // 编号 -> 驻留的字符串
+    QCollator collator_;
+    QVector<QCollatorSortKey> keys_;   // 编号 -> 排序键，只覆盖已经用到的前缀
+    QVector<int> ranks_;               // 编号 -> 区域排序名次，长度落后于strings_时需重算
+};
+
+#endif // STRINGPOOL_H
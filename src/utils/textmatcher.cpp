@@ -0,0 +1,211 @@
+// textmatcher.cpp
+#include "textmatcher.h"
+#include <QtAlgorithms>
+
+// x86-64上SSE2是基线指令集，AVX2需运行时检测后才能调用
+#if defined(__x86_64__) || defined(_M_X64)
+#  define TEXTMATCHER_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define TEXTMATCHER_TARGET_AVX2
+#  else
+#    define TEXTMATCHER_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+#endif
+
+namespace {
+
+inline char16_t foldUnit(char16_t c)
+{
+    if (c < 0x80) {
+        return (c >= u'A' && c <= u'Z') ? char16_t(c + 32) : c;
+    }
+    return QChar(c).toCaseFolded().unicode();
+}
+
+struct MatchContext {
+    const char16_t *needle;   // 已折叠
+    qsizetype length;
+    const char16_t *first;    // 首字符的4种形式
+};
+
+inline bool verifyAt(const MatchContext &ctx, const char16_t *h, qsizetype pos)
+{
+    // 首字符已由扫描确认，从第二个字符开始比较
+    for (qsizetype j = 1; j < ctx.length; ++j) {
+        if (foldUnit(h[pos + j]) != ctx.needle[j]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool isFirst(const MatchContext &ctx, char16_t c)
+{
+    return c == ctx.first[0] || c == ctx.first[1] || c == ctx.first[2] || c == ctx.first[3];
+}
+
+bool scanScalar(const MatchContext &ctx, const char16_t *h, qsizetype from, qsizetype last)
+{
+    for (qsizetype i = from; i <= last; ++i) {
+        if (isFirst(ctx, h[i]) && verifyAt(ctx, h, i)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef TEXTMATCHER_X86
+
+bool scanSse2(const MatchContext &ctx, const char16_t *h, qsizetype last)
+{
+    const __m128i v0 = _mm_set1_epi16(short(ctx.first[0]));
+    const __m128i v1 = _mm_set1_epi16(short(ctx.first[1]));
+    const __m128i v2 = _mm_set1_epi16(short(ctx.first[2]));
+    const __m128i v3 = _mm_set1_epi16(short(ctx.first[3]));
+
+    // 每次比较8个码元；只取候选起点不超过last的整块
+    qsizetype i = 0;
+    for (; i + 8 <= last + 1; i += 8) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i));
+        const __m128i eq = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(block, v0), _mm_cmpeq_epi16(block, v1)),
+                                        _mm_or_si128(_mm_cmpeq_epi16(block, v2), _mm_cmpeq_epi16(block, v3)));
+        // movemask按字节给位，每个码元取低位那一位
+        uint mask = uint(_mm_movemask_epi8(eq)) & 0x5555u;
+        while (mask) {
+            if (verifyAt(ctx, h, i + qCountTrailingZeroBits(mask) / 2)) {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return scanScalar(ctx, h, i, last);
+}
+
+TEXTMATCHER_TARGET_AVX2
+bool scanAvx2(const MatchContext &ctx, const char16_t *h, qsizetype last)
+{
+    const __m256i v0 = _mm256_set1_epi16(short(ctx.first[0]));
+    const __m256i v1 = _mm256_set1_epi16(short(ctx.first[1]));
+    const __m256i v2 = _mm256_set1_epi16(short(ctx.first[2]));
+    const __m256i v3 = _mm256_set1_epi16(short(ctx.first[3]));
+
+    qsizetype i = 0;
+    for (; i + 16 <= last + 1; i += 16) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(h + i));
+        const __m256i eq = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi16(block, v0), _mm256_cmpeq_epi16(block, v1)),
+                                           _mm256_or_si256(_mm256_cmpeq_epi16(block, v2), _mm256_cmpeq_epi16(block, v3)));
+        uint mask = uint(_mm256_movemask_epi8(eq)) & 0x55555555u;
+        while (mask) {
+            if (verifyAt(ctx, h, i + qCountTrailingZeroBits(mask) / 2)) {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return scanScalar(ctx, h, i, last);
+}
+
+bool cpuHasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;   // 操作系统未保存YMM寄存器
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // TEXTMATCHER_X86
+
+} // namespace
+
+TextMatcher::TextMatcher(const QString &needle)
+    : firstCount_(0)
+{
+    needle_.reserve(needle.size());
+    for (const QChar ch : needle) {
+        needle_.append(foldUnit(ch.unicode()));
+    }
+    if (needle_.isEmpty()) {
+        first_[0] = first_[1] = first_[2] = first_[3] = 0;
+        return;
+    }
+
+    // 首字符所有折叠后相同的形式：本身、大写、标题大写，以及几个特殊的兼容字母
+    const char16_t f = needle_[0];
+    auto addVariant = [this](char16_t c) {
+        for (int k = 0; k < firstCount_; ++k) {
+            if (first_[k] == c) {
+                return;
+            }
+        }
+        if (firstCount_ < 4) {
+            first_[firstCount_++] = c;
+        }
+    };
+    addVariant(f);
+    addVariant(QChar(f).toUpper().unicode());
+    addVariant(QChar(f).toTitleCase().unicode());
+    switch (f) {
+    case u'k':      addVariant(u'\u212A'); break;   // 开尔文符号
+    case u's':      addVariant(u'\u017F'); break;   // 长s
+    case u'\u03C3': addVariant(u'\u03C2'); break;   // 希腊字母词尾sigma
+    case u'\u03BC': addVariant(u'\u00B5'); break;   // 微符号
+    default: break;
+    }
+    for (int k = firstCount_; k < 4; ++k) {
+        first_[k] = first_[0];
+    }
+}
+
+TextMatcher::Implementation TextMatcher::implementation()
+{
+#ifdef TEXTMATCHER_X86
+    static const Implementation impl = cpuHasAvx2() ? Avx2 : Sse2;
+    return impl;
+#else
+    return Scalar;
+#endif
+}
+
+bool TextMatcher::matches(QStringView haystack) const
+{
+    return matchesWith(implementation(), haystack);
+}
+
+bool TextMatcher::matchesWith(Implementation impl, QStringView haystack) const
+{
+    const qsizetype n = needle_.size();
+    if (n == 0) {
+        return true;
+    }
+    if (haystack.size() < n) {
+        return false;
+    }
+
+    const MatchContext ctx{ needle_.constData(), n, first_ };
+    const char16_t *h = haystack.utf16();
+    const qsizetype last = haystack.size() - n;   // 最后一个可能的起点
+
+#ifdef TEXTMATCHER_X86
+    if (impl == Avx2 && implementation() == Avx2) {
+        return scanAvx2(ctx, h, last);
+    }
+    if (impl != Scalar) {
+        return scanSse2(ctx, h, last);
+    }
+#else
+    Q_UNUSED(impl);
+#endif
+    return scanScalar(ctx, h, 0, last);
+}
@@ -0,0 +1,41 @@
+// textmatcher.h
+#ifndef TEXTMATCHER_H
+#define TEXTMATCHER_H
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+// 不区分大小写的UTF-16子串匹配
+// 直接在QString的UTF-16数据上比较，逐字符做大小写折叠，不为每个字段分配小写副本。
+// 先找查询首字符可能出现的位置（首字符的各种大小写形式），再逐字符验证：
+// x86-64上运行时检测CPU，用AVX2一次比较16个码元或SSE2一次比较8个，其他平台走标量循环。
+// 折叠按单个UTF-16码元进行（QChar::toCaseFolded），与原先 toLower().contains() 的结果
+// 只在极少数多字符折叠的字母上不同。
+class TextMatcher
+{
+public:
+    enum Implementation {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    explicit TextMatcher(const QString &needle);
+
+    bool isEmpty() const { return needle_.isEmpty(); }
+    // haystack中是否包含needle（不区分大小写）；空needle总是匹配
+    bool matches(QStringView haystack) const;
+
+    // 当前CPU上选用的实现，进程内只检测一次
+    static Implementation implementation();
+    // 测试和对比用：强制使用指定实现（CPU不支持时退回标量）
+    bool matchesWith(Implementation impl, QStringView haystack) const;
+
+private:
+    QVector<char16_t> needle_;   // 已折叠的查询
+    char16_t first_[4];          // 首字符各种大小写形式，不足4个时用重复值补齐
+    int firstCount_;
+};
+
+#endif // TEXTMATCHER_H
@@ -0,0 +1,336 @@
+// userstore.cpp
+#include "userstore.h"
+#include "passwordhasher.h"
+#include "parallelscan.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QJsonDocument>
+
+UserStore& UserStore::instance()
+{
+    static UserStore instance;
+    return instance;
+}
+
+UserStore::UserStore()
+    : checkpointMaxRecords_(500)
+    , checkpointMaxBytes_(1024 * 1024)
+{
+}
+
+UserStore::~UserStore()
+{
+    // 退出时把日志合并回users.json；没有改动时不重写整个文件
+    if (isOpen() && journal_.recordCount() > 0) {
+        checkpoint();
+    }
+}
+
+bool UserStore::open(const QString &filePath)
+{
+    if (filePath.isEmpty()) {
+        return false;
+    }
+    if (filePath_ == filePath) {
+        return true;
+    }
+
+    if (isOpen() && journal_.recordCount() > 0) {
+        checkpoint();
+    }
+    clearUsers();
+    filePath_ = filePath;
+
+    // 日志与users.json放在同一目录：users.json -> users.journal
+    const QFileInfo info(filePath_);
+    journal_.setFilePath(info.absolutePath() + "/" + info.completeBaseName() + ".journal");
+
+    // 1. 加载快照；格式错误时以空表继续，下次检查点会重写文件
+    bool ok = true;
+    QFile file(filePath_);
+    if (file.exists()) {
+        if (!file.open(QIODevice::ReadOnly)) {
+            qDebug() << "Cannot open users file:" << file.errorString();
+            ok = false;
+        } else {
+            const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+            file.close();
+            if (doc.isArray()) {
+                const QJsonArray array = doc.array();
+                users_.reserve(array.size());
+                for (const QJsonValue &value : array) {
+                    if (!value.isObject()) {
+                        continue;
+                    }
+                    const QJsonObject obj = value.toObject();
+                    const QString username = obj.value("username").toString();
+                    // 重名用户只保留第一个，与原先按顺序查找的结果一致
+                    if (username.isEmpty() || rowByName_.contains(username)) {
+                        qDebug() << "Skipping duplicate or unnamed user entry:" << username;
+                        continue;
+                    }
+                    applyPut(obj);
+                }
+            } else {
+                qDebug() << "Users file is not a JSON array:" << filePath_;
+                ok = false;
+            }
+        }
+    }
+
+    // 2. 重放上次检查点之后的改动
+    const int replayed = journal_.replay([this](const QJsonObject &record) {
+        if (record.value("op").toString() == "put") {
+            applyPut(record.value("user").toObject());
+        } else {
+            qDebug() << "Unknown users journal operation:" << record.value("op").toString();
+        }
+    });
+    if (replayed < 0) {
+        ok = false;
+    }
+    journal_.open();
+
+    qDebug() << "Loaded" << users_.size() << "users," << replayed << "journal records replayed";
+    return ok;
+}
+
+bool UserStore::isOpen() const
+{
+    return !filePath_.isEmpty();
+}
+
+QString UserStore::filePath() const
+{
+    return filePath_;
+}
+
+bool UserStore::contains(const QString &username) const
+{
+    return rowByName_.contains(username);
+}
+
+bool UserStore::validate(const QString &username, const QString &password) const
+{
+    const int row = rowByName_.value(username, -1);
+    if (row < 0) {
+        return false;
+    }
+    return PasswordHasher::instance().verify(password, users_.at(row).value("password").toString(), username);
+}
+
+QString UserStore::roleOf(const QString &username) const
+{
+    const int row = rowByName_.value(username, -1);
+    if (row < 0) {
+        return QString();
+    }
+    return users_.at(row).value("role").toString(QStringLiteral("student"));
+}
+
+QJsonObject UserStore::user(const QString &username) const
+{
+    const int row = rowByName_.value(username, -1);
+    if (row < 0) {
+        return QJsonObject();
+    }
+    return users_.at(row);
+}
+
+int UserStore::userCount() const
+{
+    return users_.size();
+}
+
+QJsonArray UserStore::toJsonArray() const
+{
+    QJsonArray array;
+    for (const QJsonObject &obj : users_) {
+        array.append(obj);
+    }
+    return array;
+}
+
+bool UserStore::putUser(const QJsonObject &user)
+{
+    if (!isOpen()) {
+        return false;
+    }
+
+    const QString username = user.value("username").toString();
+    if (username.isEmpty()) {
+        return false;
+    }
+
+    const int row = rowByName_.value(username, -1);
+    if (row >= 0 && users_.at(row) == user) {
+        return true;
+    }
+    // 口令改了：旧口令的登录缓存不能再用
+    if (row >= 0 && users_.at(row).value("password") != user.value("password")) {
+        PasswordHasher::instance().forgetUser(username);
+    }
+
+    applyPut(user);
+    return logPut(user);
+}
+
+bool UserStore::addUser(const QJsonObject &user)
+{
+    if (contains(user.value("username").toString())) {
+        return false;
+    }
+    return putUser(user);
+}
+
+QVector<QJsonObject> UserStore::newUsersIn(const QJsonArray &users) const
+{
+    QVector<QJsonObject> added;
+    QSet<QString> addedNames;
+    for (const QJsonValue &value : users) {
+        if (!value.isObject()) {
+            continue;
+        }
+        const QJsonObject obj = value.toObject();
+        const QString username = obj.value("username").toString();
+        if (username.isEmpty() || rowByName_.contains(username) || addedNames.contains(username)) {
+            continue;
+        }
+        added.append(obj);
+        addedNames.insert(username);
+    }
+    return added;
+}
+
+QVector<QJsonObject> UserStore::hashPasswords(QVector<QJsonObject> users)
+{
+    // 明文口令在多个核心上并行计算哈希，已是哈希格式的保持不变；每个下标只由一个线程写入
+    const PasswordHasher &hasher = PasswordHasher::instance();
+    QJsonObject *objects = users.data();
+    ParallelScan::instance().forEach(users.size(), [objects, &hasher](int i) {
+        const QString password = objects[i].value("password").toString();
+        if (!password.isEmpty() && !PasswordHasher::isHashed(password)) {
+            objects[i]["password"] = hasher.hash(password);
+        }
+    });
+    return users;
+}
+
+int UserStore::addUsers(const QVector<QJsonObject> &users)
+{
+    if (!isOpen()) {
+        return -1;
+    }
+
+    int addedCount = 0;
+    for (const QJsonObject &obj : users) {
+        if (contains(obj.value("username").toString())) {
+            continue;
+        }
+        applyPut(obj);
+        ++addedCount;
+    }
+
+    // 批量导入直接写检查点，不必把每个用户都写进日志
+    if (addedCount > 0 && !checkpoint()) {
+        return -1;
+    }
+    return addedCount;
+}
+
+QVector<QPair<QString, QJsonArray>> UserStore::legacyBorrows() const
+{
+    QVector<QPair<QString, QJsonArray>> result;
+    for (const QJsonObject &obj : users_) {
+        const QJsonArray borrows = obj.value("borrows").toArray();
+        if (!borrows.isEmpty()) {
+            result.append(qMakePair(obj.value("username").toString(), borrows));
+        }
+    }
+    return result;
+}
+
+bool UserStore::dropLegacyBorrows()
+{
+    bool changed = false;
+    for (QJsonObject &obj : users_) {
+        if (obj.contains("borrows")) {
+            obj.remove("borrows");
+            changed = true;
+        }
+    }
+    // 涉及几乎所有用户，直接写检查点而不是逐个写日志
+    return !changed || checkpoint();
+}
+
+bool UserStore::checkpoint()
+{
+    if (!isOpen()) {
+        return false;
+    }
+    // 先写快照再清空日志：两步之间崩溃时，日志中的put记录会被幂等地重放一遍
+    if (!writeSnapshot()) {
+        return false;
+    }
+    return journal_.reset();
+}
+
+void UserStore::clearUsers()
+{
+    users_.clear();
+    rowByName_.clear();
+}
+
+void UserStore::applyPut(const QJsonObject &user)
+{
+    const QString username = user.value("username").toString();
+    if (username.isEmpty()) {
+        return;
+    }
+
+    const int row = rowByName_.value(username, -1);
+    if (row >= 0) {
+        users_[row] = user;
+    } else {
+        rowByName_.insert(username, users_.size());
+        users_.append(user);
+    }
+}
+
+bool UserStore::logPut(const QJsonObject &user)
+{
+    QJsonObject record;
+    record["op"] = "put";
+    record["user"] = user;
+
+    if (!journal_.append(record)) {
+        // 日志不可写时退回到整体保存，保证数据不丢
+        return checkpoint();
+    }
+
+    if (journal_.recordCount() >= checkpointMaxRecords_ ||
+        journal_.sizeInBytes() >= checkpointMaxBytes_) {
+        return checkpoint();
+    }
+    return true;
+}
+
+bool UserStore::writeSnapshot() const
+{
+    // 使用QSaveFile保证原子替换，写入中途失败不会破坏旧的users.json
+    QSaveFile file(filePath_);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Cannot open users file for writing:" << file.errorString();
+        return false;
+    }
+
+    file.write(QJsonDocument(toJsonArray()).toJson());
+    if (!file.commit()) {
+        qDebug() << "Failed to commit users file:" << file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+// userstore.h
+#ifndef USERSTORE_H
+#define USERSTORE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QJsonObject>
+#include <QJsonArray>
+#include "journal.h"
+
+// 用户数据存储（users.json）
+// - 文件只在open()时读取并解析一次，解析后的用户对象缓存在内存中，
+//   用户名 -> 行号的哈希索引让登录、查重都是O(1)
+// - 借阅记录不再保存在用户对象中，见 CirculationLog
+// - 修改只把改动的那一个用户对象追加到变更日志（users.journal），
+//   users.json只在检查点时整体重写；启动时先读users.json再重放日志
+// - 只在主线程使用，不加锁
+class UserStore
+{
+public:
+    static UserStore& instance();
+
+    // 打开用户文件；已经打开同一个文件时直接返回true
+    bool open(const QString &filePath);
+    bool isOpen() const;
+    QString filePath() const;
+
+    // 查询
+    bool contains(const QString &username) const;
+    // 口令按 PasswordHasher 验证，耗时较长，界面中应放到工作线程调用
+    bool validate(const QString &username, const QString &password) const;
+    // 用户角色，用户不存在时返回空字符串
+    QString roleOf(const QString &username) const;
+    // 缓存的用户对象，不存在时返回空对象
+    QJsonObject user(const QString &username) const;
+    int userCount() const;
+    QJsonArray toJsonArray() const;
+
+    // 新增或整体替换一个用户（按username匹配）；内容没有变化时不写日志
+    bool putUser(const QJsonObject &user);
+    // 只新增，用户名已存在时返回false
+    bool addUser(const QJsonObject &user);
+    // 批量导入分三步，计算哈希的一步可以放到工作线程：
+    // 1. newUsersIn(): 挑出用户名尚不存在的用户对象（同名只取第一个）
+    // 2. hashPasswords(): 把明文口令并行计算成哈希，不访问UserStore，线程安全
+    // 3. addUsers(): 加入这些用户（期间新出现的同名用户跳过）并写检查点，返回新增数，保存失败返回-1
+    QVector<QJsonObject> newUsersIn(const QJsonArray &users) const;
+    static QVector<QJsonObject> hashPasswords(QVector<QJsonObject> users);
+    int addUsers(const QVector<QJsonObject> &users);
+
+    // 旧版本保存在用户对象中的borrows数组（用户名, 数组），按用户在文件中的顺序
+    QVector<QPair<QString, QJsonArray>> legacyBorrows() const;
+    // 删除所有用户的borrows字段并写检查点
+    bool dropLegacyBorrows();
+
+    // 检查点：重写users.json并清空日志
+    bool checkpoint();
+
+private:
+    UserStore();
+    ~UserStore();
+    UserStore(const UserStore&) = delete;
+    UserStore& operator=(const UserStore&) = delete;
+
+    void clearUsers();
+    void applyPut(const QJsonObject &user);
+    bool logPut(const QJsonObject &user);
+    bool writeSnapshot() const;
+
+    QString filePath_;
+    QVector<QJsonObject> users_;     // 解析后的用户对象，按文件中的顺序
+    QHash<QString, int> rowByName_;  // 用户名 -> users_下标
+    Journal journal_;                // users.journal，记录自上次检查点以来改动的用户
+    int checkpointMaxRecords_;
+    qint64 checkpointMaxBytes_;
+};
+
+#endif // USERSTORE_H
@@ -0,0 +1,260 @@
+// booktablemodel.cpp
+#include "booktablemodel.h"
+#include "../utils/databasemanager.h"
+#include "../utils/bookcopymanager.h"
+#include <QTimer>
+#include <algorithm>
+
+namespace {
+
+const int kFirstPageRows = 200;   // 第一屏：足够填满表格视图
+const int kPageRows = 2000;       // 之后每个事件循环追加的行数
+
+} // namespace
+
+BookTableModel::BookTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , pendingOffset_(0)
+    , pageTimer_(new QTimer(this))
+    , rowIndexDirty_(true)
+    , showDueDate_(false)
+{
+    // 副本借还/续借/增删时只刷新对应的那一行
+    connect(&BookCopyManager::instance(), &BookCopyManager::copyChanged,
+            this, &BookTableModel::onCopyChanged);
+
+    pageTimer_->setSingleShot(true);
+    pageTimer_->setInterval(0);
+    connect(pageTimer_, &QTimer::timeout, this, &BookTableModel::appendPendingPage);
+}
+
+int BookTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rows_.size();
+}
+
+int BookTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant BookTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    const Book *book = bookAt(index.row());
+    if (!book) {
+        return QVariant();
+    }
+
+    const BookCopyManager &copyManager = BookCopyManager::instance();
+
+    switch (index.column()) {
+    case IndexIdColumn:
+        return book->indexId;
+    case NameColumn:
+        return book->name;
+    case AuthorColumn:
+        return book->author;
+    case PublisherColumn:
+        return book->publisher;
+    case LocationColumn:
+        return book->location;
+    case CategoryColumn:
+        return book->category;
+    case CopiesColumn:
+        return QString::number(copyManager.getTotalCopyCount(book->indexId));
+    case PriceColumn:
+        return QString::number(book->price, 'f', 2);
+    case InDateColumn:
+        return book->inDate.toString("yyyy-MM-dd");
+    case DueDateColumn:
+        return showDueDate_ ? dueDates_.value(book->indexId).toString("yyyy-MM-dd") : QString();
+    case BorrowCountColumn:
+        return QString::number(book->borrowCount);
+    case StatusColumn:
+        return copyManager.getAvailableCopyCount(book->indexId) > 0 ? QStringLiteral("可借")
+                                                                      : QStringLiteral("不可借");
+    default:
+        return QVariant();
+    }
+}
+
+QVariant BookTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        return headers_.value(section);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+bool BookTableModel::setHeaderData(int section, Qt::Orientation orientation, const QVariant &value, int role)
+{
+    if (orientation != Qt::Horizontal || (role != Qt::EditRole && role != Qt::DisplayRole) ||
+        section < 0 || section >= ColumnCount) {
+        return false;
+    }
+
+    while (headers_.size() <= section) {
+        headers_.append(QString());
+    }
+    headers_[section] = value.toString();
+    emit headerDataChanged(orientation, section, section);
+    return true;
+}
+
+void BookTableModel::setHorizontalHeaderLabels(const QStringList &labels)
+{
+    headers_ = labels;
+    emit headerDataChanged(Qt::Horizontal, 0, ColumnCount - 1);
+}
+
+void BookTableModel::setRows(const QVector<int> &slotList)
+{
+    pageTimer_->stop();
+    pendingRows_.clear();
+    pendingOffset_ = 0;
+
+    beginResetModel();
+    rows_ = slotList;
+    rowBySlot_.clear();
+    rowIndexDirty_ = true;
+    endResetModel();
+}
+
+void BookTableModel::setRowsPaged(const QVector<int> &slotList)
+{
+    if (slotList.size() <= kFirstPageRows) {
+        setRows(slotList);
+        return;
+    }
+
+    setRows(slotList.mid(0, kFirstPageRows));
+    pendingRows_ = slotList;
+    pendingOffset_ = kFirstPageRows;
+    pageTimer_->start();
+}
+
+void BookTableModel::appendPendingPage()
+{
+    const int count = std::min(kPageRows, int(pendingRows_.size()) - pendingOffset_);
+    if (count <= 0) {
+        pendingRows_.clear();
+        pendingOffset_ = 0;
+        return;
+    }
+
+    const int first = rows_.size();
+    beginInsertRows(QModelIndex(), first, first + count - 1);
+    rows_.append(pendingRows_.mid(pendingOffset_, count));
+    rowIndexDirty_ = true;
+    endInsertRows();
+
+    pendingOffset_ += count;
+    if (pendingOffset_ < pendingRows_.size()) {
+        pageTimer_->start();
+    } else {
+        pendingRows_.clear();
+        pendingOffset_ = 0;
+    }
+}
+
+void BookTableModel::setBooks(const QVector<Book> &books)
+{
+    DatabaseManager &db = DatabaseManager::instance();
+
+    QVector<int> slotList;
+    slotList.reserve(books.size());
+    for (const Book &book : books) {
+        const int slot = db.slotOf(book.indexId);
+        if (slot >= 0) {
+            slotList.append(slot);
+        }
+    }
+    setRows(slotList);
+}
+
+void BookTableModel::clear()
+{
+    setRows(QVector<int>());
+}
+
+void BookTableModel::setCurrentUser(const QString &username, bool showDueDate)
+{
+    username_ = username;
+    showDueDate_ = showDueDate && !username.isEmpty();
+    rebuildDueDates();
+
+    if (!rows_.isEmpty()) {
+        emit dataChanged(index(0, DueDateColumn), index(rows_.size() - 1, DueDateColumn));
+    }
+}
+
+const Book* BookTableModel::bookAt(int row) const
+{
+    if (row < 0 || row >= rows_.size()) {
+        return nullptr;
+    }
+    return DatabaseManager::instance().bookAt(rows_[row]);
+}
+
+QString BookTableModel::indexIdAt(int row) const
+{
+    const Book *book = bookAt(row);
+    return book ? book->indexId : QString();
+}
+
+int BookTableModel::rowOfIndexId(const QString &indexId) const
+{
+    const int slot = DatabaseManager::instance().slotOf(indexId);
+    if (slot < 0) {
+        return -1;
+    }
+
+    ensureRowIndex();
+    return rowBySlot_.value(slot, -1);
+}
+
+void BookTableModel::onCopyChanged(const QString &indexId)
+{
+    if (showDueDate_) {
+        rebuildDueDates();
+    }
+
+    const int row = rowOfIndexId(indexId);
+    if (row >= 0) {
+        emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+    }
+}
+
+void BookTableModel::rebuildDueDates()
+{
+    // 只涉及当前用户借出的副本，数量很少
+    dueDates_.clear();
+    if (!showDueDate_) {
+        return;
+    }
+
+    const QVector<BookCopy> borrowed = BookCopyManager::instance().getBorrowedCopies(username_);
+    for (const BookCopy &copy : borrowed) {
+        if (!dueDates_.contains(copy.indexId)) {
+            dueDates_.insert(copy.indexId, copy.dueDate);
+        }
+    }
+}
+
+void BookTableModel::ensureRowIndex() const
+{
+    if (!rowIndexDirty_) {
+        return;
+    }
+
+    rowBySlot_.clear();
+    rowBySlot_.reserve(rows_.size());
+    for (int row = 0; row < rows_.size(); ++row) {
+        rowBySlot_.insert(rows_[row], row);
+    }
+    rowIndexDirty_ = false;
+}
@@ -0,0 +1,83 @@
+// booktablemodel.h
+#ifndef BOOKTABLEMODEL_H
+#define BOOKTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include <QHash>
+#include <QDate>
+#include <QStringList>
+#include "../utils/book.h"
+
+class QTimer;
+
+// 主窗口图书表格的数据模型
+// 模型本身只保存一组DatabaseManager槽位号（每行一个），单元格内容在data()中
+// 按需从图书/副本存储读取，刷新表格时不再为每个单元格分配QStandardItem。
+// 副本借还时只对受影响的行发出dataChanged。
+class BookTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        IndexIdColumn = 0,  // 索引号
+        NameColumn,         // 名称
+        AuthorColumn,       // 作者
+        PublisherColumn,    // 出版社
+        LocationColumn,     // 馆藏地址
+        CategoryColumn,     // 类别
+        CopiesColumn,       // 数量（副本总数）
+        PriceColumn,        // 价格
+        InDateColumn,       // 入库日期
+        DueDateColumn,      // 归还日期（仅学生可见）
+        BorrowCountColumn,  // 借阅次数
+        StatusColumn,       // 状态
+        ColumnCount
+    };
+
+    explicit BookTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool setHeaderData(int section, Qt::Orientation orientation, const QVariant &value, int role = Qt::EditRole) override;
+    void setHorizontalHeaderLabels(const QStringList &labels);
+
+    // 设置要显示的行（DatabaseManager槽位号），整体重置模型
+    void setRows(const QVector<int> &slotList);
+    // 分页设置行：先显示第一屏，其余在后续事件循环中分批追加，避免一次插入大量行卡住界面
+    void setRowsPaged(const QVector<int> &slotList);
+    // 按图书列表设置行，内部换算成槽位号
+    void setBooks(const QVector<Book> &books);
+    void clear();
+
+    // 学生模式下显示当前用户借阅副本的归还日期
+    void setCurrentUser(const QString &username, bool showDueDate);
+
+    const Book* bookAt(int row) const;
+    QString indexIdAt(int row) const;
+    int rowOfIndexId(const QString &indexId) const;
+
+private slots:
+    void onCopyChanged(const QString &indexId);
+    void appendPendingPage();
+
+private:
+    void rebuildDueDates();
+    void ensureRowIndex() const;
+
+    QVector<int> rows_;                    // 行号 -> 槽位号
+    QVector<int> pendingRows_;             // 分页设置时尚未追加的槽位号
+    int pendingOffset_;
+    QTimer *pageTimer_;
+    mutable QHash<int, int> rowBySlot_;    // 槽位号 -> 行号，借还时才按需建立
+    mutable bool rowIndexDirty_;
+    QStringList headers_;
+    QString username_;
+    bool showDueDate_;
+    QHash<QString, QDate> dueDates_;       // 当前用户借阅的indexId -> 应还日期
+};
+
+#endif // BOOKTABLEMODEL_H
@@ -6,6 +6,10 @@
 #include "copymanagementdialog.h"
 #include "bookdetaildialog.h"
 #include "borrowdialog.h"
+#include "../utils/databasemanager.h"
+#include "../utils/userstore.h"
+#include "../utils/circulationlog.h"
+#include "../utils/passwordhasher.h"
 
 #include <QMenu>
 #include <QAction>
@@ -32,7 +36,13 @@
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QProgressDialog>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QApplication>
+#include <QTimer>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
@@ -59,6 +69,7 @@
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),
       ui(new Ui::MainWindow),
+      library_(LibraryManager::instance()),
       model_(nullptr),
       tableView_(nullptr),
       searchEdit_(nullptr),
@@ -113,7 +124,13 @@ MainWindow::MainWindow(QWidget *parent)
 // ============================================================================
 MainWindow::~MainWindow()
 {
+    // 后台搜索持有library_的引用，需在成员析构前先停下
+    delete asyncSearch_;
     delete ui;
+    // 主窗口关闭即本次登录结束，清除该用户的登录缓存
+    if (!currentUsername_.isEmpty()) {
+        PasswordHasher::instance().forgetUser(currentUsername_);
+    }
 }
 
 void MainWindow::loadData()
@@ -130,7 +147,7 @@ void MainWindow::loadData()
  * @brief 设置表格视图和数据模型
  *
  * 功能说明：
- * 1. 创建QStandardItemModel作为数据模型，管理表格数据
+ * 1. 创建BookTableModel作为数据模型，单元格内容按需从存储中读取
  * 2. 设置表格列标题，包含图书的所有重要信息字段
  * 3. 创建QTableView作为视图组件，用于显示数据
  * 4. 配置表格的各种显示属性和行为设置
@@ -153,8 +170,8 @@ void MainWindow::loadData()
  */
 void MainWindow::setupTable()
 {
-    // 创建数据模型：使用QStandardItemModel管理表格数据
-    model_ = new QStandardItemModel(this);
+    // 创建数据模型：模型只保存行对应的图书槽位，不为每个单元格分配对象
+    model_ = new BookTableModel(this);
 
     // 设置表格列标题：定义12个信息列，覆盖图书的完整信息
     model_->setHorizontalHeaderLabels({
@@ -237,9 +254,6 @@ void MainWindow::setupTable()
  */
 void MainWindow::refreshTable()
 {
-    // 清空表格：移除所有现有行，准备重新填充数据
-    model_->removeRows(0, model_->rowCount());
-
     // 智能数据源选择：根据当前状态决定数据来源
     if (isSearchActive_) {
         // 搜索模式：重新执行搜索并应用当前的筛选和排序
@@ -247,77 +261,31 @@ void MainWindow::refreshTable()
         return;
     }
 
-    // 普通模式：获取所有图书数据
-    const QVector<Book> &books = library_.getAll();
-
-    // 数据遍历和筛选：逐行处理图书数据
-    for (int row = 0; row < books.size(); ++row) {
-        const Book &b = books[row];
-
-        // 多维度筛选条件应用
-        // 1. 类别筛选：只显示指定类别的图书
-        if (!categoryFilter_.isEmpty() && b.category != categoryFilter_) {
-            continue;
-        }
-        // 2. 位置筛选：只显示指定馆藏地址的图书
-        if (!locationFilter_.isEmpty() && b.location != locationFilter_) {
-            continue;
-        }
-
-        // 副本状态获取：计算该图书的副本情况
-        int totalCopies = library_.getTotalCopyCount(b.indexId);
-        int availableCopies = library_.getAvailableCopyCount(b.indexId);
-
-        // 3. 状态筛选：根据可用性进行筛选
-        if (statusFilter_ == "available" && availableCopies <= 0) {
-            continue; // 只显示有可用副本的图书
-        }
-        if (statusFilter_ == "borrowed" && availableCopies >= totalCopies) {
-            continue; // 只显示没有可用副本的图书（即全部被借走）
-        }
-
-        // 创建表格行数据：按列顺序添加所有信息
-        QList<QStandardItem *> rowItems;
-        rowItems << new QStandardItem(b.indexId);                                           // 索引号
-        rowItems << new QStandardItem(b.name);                                               // 名称
-        rowItems << new QStandardItem(b.author);                                             // 作者
-        rowItems << new QStandardItem(b.publisher);                                          // 出版社
-        rowItems << new QStandardItem(b.location);                                           // 馆藏地址
-        rowItems << new QStandardItem(b.category);                                           // 类别
-        rowItems << new QStandardItem(QString::number(totalCopies));                         // 数量：总副本数
-        rowItems << new QStandardItem(QString::number(b.price, 'f', 2));                    // 价格：保留2位小数
-        rowItems << new QStandardItem(b.inDate.toString("yyyy-MM-dd"));                      // 入库日期
-
-        // 归还日期列：个性化显示逻辑
-        // 学生用户可以看到自己的借阅归还日期，管理员看不到
-        QString returnDateStr = "";
-        if (!currentUsername_.isEmpty() && !isAdminMode_) {  // 学生用户
-            // 获取该学生当前借阅的所有副本
-            QVector<BookCopy> borrowedCopies = library_.getUserBorrowedCopies(currentUsername_);
-            for (const BookCopy &copy : borrowedCopies) {
-                if (copy.indexId == b.indexId) {  // 找到该书的借阅记录
-                    returnDateStr = copy.dueDate.toString("yyyy-MM-dd");
-                    break;  // 找到一个即可（正常情况下学生不会重复借阅同一本书）
-                }
-            }
-        }
-        rowItems << new QStandardItem(returnDateStr);  // 归还日期
-
-        rowItems << new QStandardItem(QString::number(b.borrowCount));                       // 借阅次数
-
-        // 状态列：根据副本可用性动态显示状态
-        QString statusText = (availableCopies > 0) ? QStringLiteral("可借") : QStringLiteral("不可借");
-        rowItems << new QStandardItem(statusText);
-
-        // 将行数据添加到模型中
-        model_->appendRow(rowItems);
-    }
+    // 普通模式：按当前筛选和排序条件查询全部图书，得到各行对应的槽位号，
+    // 单元格内容由模型在显示时读取
+    model_->setRows(library_.query(currentFilterQuery()));
 
     // 界面状态更新
     updateStatusBar();      // 更新状态栏统计信息
     updateHeaderLabels();   // 更新表头显示当前筛选和排序状态
 }
 
+/**
+ * @brief 借还/续借后的轻量刷新
+ *
+ * 表格模型监听副本变更信号，只对受影响的行发出dataChanged，
+ * 因此这里一般只需更新状态栏；当启用了可借状态筛选时，
+ * 该行可能不再满足筛选条件，才需要重新生成行集合。
+ */
+void MainWindow::refreshAfterCirculation()
+{
+    if (statusFilter_.isEmpty()) {
+        updateStatusBar();
+    } else {
+        refreshTable();
+    }
+}
+
 // ============================================================================
 // 核心业务逻辑槽函数
 // ============================================================================
@@ -358,8 +326,8 @@ void MainWindow::onBorrow()
 
     // 获取选中图书的信息
     int row = selectedIndexes.first().row();
-    QString indexId = model_->item(row, 0)->text();
-    QString bookName = model_->item(row, 1)->text();
+    QString indexId = model_->indexIdAt(row);
+    QString bookName = model_->data(model_->index(row, BookTableModel::NameColumn)).toString();
 
     // 数据验证：检查图书是否存在
     const Book *book = library_.findByIndexId(indexId);
@@ -399,7 +367,12 @@ void MainWindow::onBorrow()
     // 业务处理：执行借书操作
     QString error;
     if (library_.borrowBook(indexId, currentUsername_, dueDate, &error)) {
-        refreshTable();  // 刷新表格显示
+        // 借出事件写入流通日志，借阅历史和统计都从日志读取
+        if (!CirculationLog::instance().recordBorrow(currentUsername_, indexId, bookName,
+                                                     QDate::currentDate(), dueDate)) {
+            qDebug() << "Failed to record borrow event for" << indexId;
+        }
+        refreshAfterCirculation();  // 刷新受影响的行和状态栏
         QMessageBox::information(this, "成功",
             QStringLiteral("成功借阅《%1》的副本%2，归还日期：%3")
             .arg(bookName, QString::number(selectedCopy.copyNumber), dueDate.toString("yyyy-MM-dd")));
@@ -505,7 +478,11 @@ void MainWindow::onReturn()
     // 业务处理：执行还书操作
     QString error;
     if (library_.returnBook(selectedCopyObj.copyId, currentUsername_, &error)) {
-        refreshTable();  // 刷新表格显示
+        if (!CirculationLog::instance().recordReturn(currentUsername_, selectedCopyObj.indexId,
+                                                     QDate::currentDate())) {
+            qDebug() << "Failed to record return event for" << selectedCopyObj.indexId;
+        }
+        refreshAfterCirculation();  // 刷新受影响的行和状态栏
         QMessageBox::information(this, "还书成功",
                                  QStringLiteral("成功归还《%1》的副本%2\n感谢您的使用！")
                                  .arg(book->name).arg(selectedCopyObj.copyNumber));
@@ -610,7 +587,7 @@ void MainWindow::onRenew()
     // 业务处理：执行续借操作
     QString error;
     if (library_.renewBook(selectedCopyObj.copyId, currentUsername_, 30, &error)) {
-        refreshTable();  // 刷新表格显示
+        refreshAfterCirculation();  // 刷新受影响的行和状态栏
         QMessageBox::information(this, "续借成功",
                                  QStringLiteral("成功续借《%1》的副本%2\n"
                                              "新应还日期：%3\n"
@@ -678,7 +655,7 @@ void MainWindow::onEditBook()
     }
 
     int row = selectedIndexes.first().row();
-    QString indexId = model_->item(row, 0)->text();
+    QString indexId = model_->indexIdAt(row);
 
     const Book *bookPtr = library_.findByIndexId(indexId);
     if (bookPtr) {
@@ -700,8 +677,8 @@ void MainWindow::onDeleteBook()
     }
 
     int row = selectedIndexes.first().row();
-    QString indexId = model_->item(row, 0)->text();
-    QString bookName = model_->item(row, 1)->text();
+    QString indexId = model_->indexIdAt(row);
+    QString bookName = model_->data(model_->index(row, BookTableModel::NameColumn)).toString();
 
     // 确认删除
     auto reply = QMessageBox::question(this, "确认删除",
@@ -733,7 +710,7 @@ void MainWindow::onManageCopies()
     }
 
     int row = selectedIndexes.first().row();
-    QString indexId = model_->item(row, 0)->text();
+    QString indexId = model_->indexIdAt(row);
 
     CopyManagementDialog dialog(indexId, this);
     dialog.exec();
@@ -756,7 +733,6 @@ void MainWindow::onShowAll()
 void MainWindow::onSortByBorrowCount()
 {
     currentSortType_ = "borrowCount";
-    library_.sortByBorrowCount();
     refreshTable();
     updateHeaderLabels();
     statusBar()->showMessage("已按借阅次数排序（从高到低）", 3000);
@@ -765,7 +741,6 @@ void MainWindow::onSortByBorrowCount()
 void MainWindow::onSortDefault()
 {
     currentSortType_ = "default";
-    library_.loadFromDatabase();
     refreshTable();
     updateHeaderLabels();
     statusBar()->showMessage("已恢复默认排序", 3000);
@@ -776,13 +751,7 @@ void MainWindow::onSortChanged(QAction *action)
     if (!action)
         return;
     QString sortType = action->data().toString();
-    currentSortType_ = sortType;
-
-    if (sortType == "borrowCount") {
-        library_.sortByBorrowCount();
-    } else if (sortType == "default") {
-        library_.loadFromDatabase();
-    }
+    currentSortType_ = sortType;   // 排序由查询执行，不再重排图书缓存
 
     refreshTable();
     updateHeaderLabels();
@@ -816,6 +785,14 @@ void MainWindow::onSearch()
         return;
     }
 
+    // 回车/按钮搜索立即同步执行，取消尚未触发或仍在后台运行的边输入边搜索
+    if (searchDebounceTimer_) {
+        searchDebounceTimer_->stop();
+    }
+    if (asyncSearch_) {
+        asyncSearch_->cancel();
+    }
+
     // 关键词获取和预处理：获取用户输入并去除首尾空格
     QString keyword = searchEdit_->text().trimmed();
     qDebug() << "Search keyword:" << keyword;
@@ -865,6 +842,8 @@ void MainWindow::onSearch()
  * - indexId模式：按索引号搜索，支持精确匹配和副本号搜索
  * - author模式：按作者搜索，支持模糊匹配
  * - publisher模式：按出版社搜索，支持模糊匹配
+ * - pinyin模式：按书名/作者的全拼或首字母搜索
+ * - typo模式：英文书名/作者容错搜索，允许一两处拼写错误
  *
  * 用户体验优化：
  * 动态更新搜索框的占位符文本，为用户提供清晰的输入提示
@@ -890,6 +869,10 @@ void MainWindow::onSearchModeChanged()
         placeholderText = "🔍 搜索作者...";  // 作者搜索提示
     } else if (searchMode == "publisher") {
         placeholderText = "🔍 搜索出版社...";  // 出版社搜索提示
+    } else if (searchMode == "pinyin") {
+        placeholderText = "🔍 输入书名或作者的拼音/首字母，如 hlm、honglou...";  // 拼音搜索提示
+    } else if (searchMode == "typo") {
+        placeholderText = "🔍 英文书名或作者，允许拼错一两个字母...";  // 容错搜索提示
     } else {
         placeholderText = "🔍 输入搜索关键词...";  // 默认搜索提示
     }
@@ -898,6 +881,44 @@ void MainWindow::onSearchModeChanged()
     searchEdit_->setPlaceholderText(placeholderText);
 }
 
+/**
+ * @brief 输入停顿后的边输入边搜索
+ *
+ * 由防抖定时器触发，查询提交到后台线程执行，仍在运行的旧查询随之作废。
+ * 关键词清空时按普通搜索处理，直接显示全部图书。
+ */
+void MainWindow::onSearchTextIdle()
+{
+    if (!searchEdit_ || !searchModeComboBox_ || !asyncSearch_) {
+        return;
+    }
+
+    const QString keyword = searchEdit_->text().trimmed();
+    if (keyword.isEmpty()) {
+        onSearch();
+        return;
+    }
+
+    const QString searchMode = searchModeComboBox_->currentData().toString();
+    isSearchActive_ = true;
+    currentSearchKeyword_ = keyword;
+    currentSearchMode_ = searchMode;
+
+    asyncSearch_->submit(keyword, searchMode, fieldMaskForSearchMode(searchMode));
+}
+
+/**
+ * @brief 后台搜索完成，结果分页送入表格
+ */
+void MainWindow::onAsyncSearchFinished(const QString &keyword, const QString &mode, const QVector<int> &slotList)
+{
+    // 期间用户可能已回车搜索或清空了搜索框
+    if (!isSearchActive_ || keyword != currentSearchKeyword_ || mode != currentSearchMode_) {
+        return;
+    }
+    showSearchResults(slotList, true);
+}
+
 /**
  * @brief 图书数据导入功能
  *
@@ -916,7 +937,9 @@ void MainWindow::onSearchModeChanged()
  * 错误处理：
  * - 文件路径为空时直接返回
  * - 文件格式错误时显示失败消息
- * - 导入失败时保持原有数据不变
+ * - 文件中途出错时保留出错位置之前已导入的记录
+ *
+ * 大文件按记录流式解析，进度对话框按已读字节数显示进度
  */
 void MainWindow::onOpen()
 {
@@ -925,11 +948,22 @@ void MainWindow::onOpen()
 
     // 路径验证：检查用户是否选择了文件
     if (!path.isEmpty()) {
+        // 进度对话框：按千分比显示，模态时setValue会处理界面事件
+        QProgressDialog progressDialog("正在导入图书数据...", QString(), 0, 1000, this);
+        progressDialog.setWindowTitle("导入");
+        progressDialog.setWindowModality(Qt::WindowModal);
+        progressDialog.setMinimumDuration(500);
+
         // 数据导入：尝试从JSON文件导入图书数据
-        if (library_.importFromJson(path)) {
-            // 界面更新：导入成功后更新相关UI组件
-            rebuildFilterMenus();  // 重新构建筛选菜单，反映新数据中的类别
-            refreshTable();        // 刷新表格显示新导入的数据
+        const bool imported = library_.importFromJson(path, [&progressDialog](qint64 bytesRead, qint64 totalBytes) {
+            progressDialog.setValue(totalBytes > 0 ? int(bytesRead * 1000 / totalBytes) : 0);
+        });
+        progressDialog.setValue(1000);
+
+        // 界面更新：中途出错时已导入的记录同样需要显示
+        rebuildFilterMenus();  // 重新构建筛选菜单，反映新数据中的类别
+        refreshTable();        // 刷新表格显示新导入的数据
+        if (imported) {
             QMessageBox::information(this, "成功", "数据导入成功！");
         } else {
             // 错误处理：导入失败时显示错误消息
@@ -1123,6 +1157,8 @@ void MainWindow::setupSearchBar()
     searchModeComboBox_ = new QComboBox();
     searchModeComboBox_->addItem("书名搜索", "name");
     searchModeComboBox_->addItem("索引号搜索", "indexId");
+    searchModeComboBox_->addItem("拼音搜索", "pinyin");
+    searchModeComboBox_->addItem("容错搜索", "typo");
     searchModeComboBox_->addItem("全文搜索", "all");
     searchModeComboBox_->setMinimumWidth(100);
     searchModeComboBox_->setToolTip("选择搜索方式");
@@ -1132,6 +1168,12 @@ void MainWindow::setupSearchBar()
 
     searchButton_ = new QPushButton("搜索");
 
+    // 边输入边搜索：输入停顿150ms后在后台线程查询，结果分页送入表格
+    searchDebounceTimer_ = new QTimer(this);
+    searchDebounceTimer_->setSingleShot(true);
+    searchDebounceTimer_->setInterval(150);
+    asyncSearch_ = new AsyncSearch(library_, this);
+
     themeToggleButton_ = new QPushButton("🌙");
     themeToggleButton_->setToolTip("切换深浅色模式");
 
@@ -1150,6 +1192,9 @@ void MainWindow::setupSearchBar()
 
     connect(searchButton_, &QPushButton::clicked, this, &MainWindow::onSearch);
     connect(searchEdit_, &QLineEdit::returnPressed, this, &MainWindow::onSearch);
+    connect(searchEdit_, &QLineEdit::textEdited, searchDebounceTimer_, qOverload<>(&QTimer::start));
+    connect(searchDebounceTimer_, &QTimer::timeout, this, &MainWindow::onSearchTextIdle);
+    connect(asyncSearch_, &AsyncSearch::finished, this, &MainWindow::onAsyncSearchFinished);
     connect(searchModeComboBox_, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onSearchModeChanged);
     connect(themeToggleButton_, &QPushButton::clicked, this, &MainWindow::toggleTheme);
 }
@@ -1180,16 +1225,14 @@ void MainWindow::setupStyles()
 
 void MainWindow::updateStatusBar()
 {
-    int totalBooks = library_.getTotalBooks();
-    int totalCopies = library_.getTotalCopies();
-    int availableCopies = library_.getAvailableCopies();
-    int borrowedCopies = totalCopies - availableCopies;
+    // 计数器由LibraryManager增量维护，这里不再扫描图书和副本
+    const LibraryStats stats = library_.stats();
 
     QString statusText = QStringLiteral("📊 图书种类: %1 | 📚 总副本: %2 | ✅ 可借: %3 | ❌ 已借: %4")
-                             .arg(totalBooks)
-                             .arg(totalCopies)
-                             .arg(availableCopies)
-                             .arg(borrowedCopies);
+                             .arg(stats.totalBooks)
+                             .arg(stats.totalCopies)
+                             .arg(stats.availableCopies)
+                             .arg(stats.borrowedCopies);
     statusBar()->showMessage(statusText);
 }
 
@@ -1198,9 +1241,26 @@ void MainWindow::updateStatusBar()
 // ============================================================================
 void MainWindow::setCurrentUser(const QString &username, bool isAdminMode, const QString &usersFilePath)
 {
+    // 换用户相当于上一个用户注销
+    if (!currentUsername_.isEmpty() && currentUsername_ != username) {
+        PasswordHasher::instance().forgetUser(currentUsername_);
+    }
     currentUsername_ = username;
     isAdminMode_ = isAdminMode;
     usersFilePath_ = usersFilePath;
+    // 登录对话框通常已经打开过同一个文件，此时不会重新读取
+    UserStore::instance().open(usersFilePath_);
+
+    // 借阅记录保存在users.json同目录下的流通日志中；首次运行时迁移旧的borrows数组，
+    // 超过保留期限的已还记录攒够一批后移入归档
+    CirculationLog &circulation = CirculationLog::instance();
+    if (circulation.open(QFileInfo(usersFilePath_).absolutePath() + "/circulation")) {
+        circulation.migrateLegacyBorrows(UserStore::instance());
+        circulation.archiveClosedRecords();
+    }
+
+    // 学生模式下表格显示本人借阅的归还日期
+    model_->setCurrentUser(username, !isAdminMode);
 
     if (isAdminMode_) {
         setWindowTitle(QStringLiteral("图书管理系统 - 管理员模式 (%1)").arg(username));
@@ -1412,35 +1472,30 @@ void MainWindow::onImportUsers()
             return;
         }
 
-        QJsonArray importedArray = doc.array();
-        QJsonArray currentArray = loadUsersJson();
-
-        QSet<QString> existingUsernames;
-        for (const QJsonValue &value : currentArray) {
-            if (value.isObject()) {
-                existingUsernames.insert(value.toObject().value("username").toString());
-            }
+        // 已存在的用户名通过用户索引跳过；新账号的明文口令在工作线程中并行计算哈希，
+        // 界面保持响应，算完后回到主线程加入用户并保存
+        const QVector<QJsonObject> added = UserStore::instance().newUsersIn(doc.array());
+        if (added.isEmpty()) {
+            QMessageBox::information(this, "成功", "没有需要导入的新学生数据。");
+            return;
         }
 
-        int addedCount = 0;
-        for (const QJsonValue &value : importedArray) {
-            if (!value.isObject())
-                continue;
-            QJsonObject userObj = value.toObject();
-            QString username = userObj.value("username").toString();
-            if (!existingUsernames.contains(username)) {
-                currentArray.append(userObj);
-                existingUsernames.insert(username);
-                addedCount++;
+        importUsersAct_->setEnabled(false);
+        statusBar()->showMessage(QStringLiteral("正在导入 %1 条学生数据...").arg(added.size()));
+        auto *watcher = new QFutureWatcher<QVector<QJsonObject>>(this);
+        connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+            watcher->deleteLater();
+            importUsersAct_->setEnabled(true);
+            statusBar()->clearMessage();
+            const int addedCount = UserStore::instance().addUsers(watcher->result());
+            if (addedCount >= 0) {
+                QMessageBox::information(this, "成功",
+                                         QStringLiteral("成功导入 %1 条学生数据！").arg(addedCount));
+            } else {
+                QMessageBox::warning(this, "失败", "保存学生数据失败！");
             }
-        }
-
-        if (saveUsersJson(currentArray)) {
-            QMessageBox::information(this, "成功",
-                                     QStringLiteral("成功导入 %1 条学生数据！").arg(addedCount));
-        } else {
-            QMessageBox::warning(this, "失败", "保存学生数据失败！");
-        }
+        });
+        watcher->setFuture(QtConcurrent::run(&UserStore::hashPasswords, added));
     }
 }
 
@@ -1453,8 +1508,7 @@ void MainWindow::onExportUsers()
 
     QString path = QFileDialog::getSaveFileName(this, "导出学生数据", "users_export.json", "JSON Files (*.json)");
     if (!path.isEmpty()) {
-        QJsonArray usersArray = loadUsersJson();
-        QJsonDocument doc(usersArray);
+        QJsonDocument doc(UserStore::instance().toJsonArray());
 
         QFile file(path);
         if (file.open(QIODevice::WriteOnly)) {
@@ -1998,19 +2052,11 @@ void MainWindow::rebuildFilterMenus()
         allCategoryAction->setChecked(true);
     }
 
-    QSet<QString> categorySet;
-    for (const Book &book : library_.getAll()) {
-        if (!book.category.isEmpty()) {
-            categorySet.insert(book.category);
-        }
-    }
-    if (!categoryFilter_.isEmpty() && !categorySet.contains(categoryFilter_)) {
+    // 分类列表只读类别编号列，不遍历图书记录；已按缓存的排序键排好
+    const QStringList categories = library_.getCategories();
+    if (!categoryFilter_.isEmpty() && !categories.contains(categoryFilter_)) {
         categoryFilter_.clear();
     }
-    QList<QString> categories = QList<QString>(categorySet.begin(), categorySet.end());
-    std::sort(categories.begin(), categories.end(), [](const QString &a, const QString &b) {
-        return a.localeAwareCompare(b) < 0;
-    });
 
     if (!categories.isEmpty()) {
         addCategoryAction(QString(), QString(), true);
@@ -2111,13 +2157,15 @@ void MainWindow::rebuildFilterMenus()
     };
 
     QAction *defaultSortAction = addSortAction(QStringLiteral("默认排序"), QStringLiteral("default"));
-    QAction *borrowCountSortAction = addSortAction(QStringLiteral("热门排序"), QStringLiteral("borrowCount"));
+    addSortAction(QStringLiteral("热门排序"), QStringLiteral("borrowCount"));
+    addSortAction(QStringLiteral("价格从高到低"), QStringLiteral("price"));
+    addSortAction(QStringLiteral("最新入库"), QStringLiteral("inDate"));
+    addSortAction(QStringLiteral("按书名排序"), QStringLiteral("name"));
+    addSortAction(QStringLiteral("按类别排序"), QStringLiteral("category"));
+    addSortAction(QStringLiteral("按馆藏地址排序"), QStringLiteral("location"));
 
-    if (currentSortType_.isEmpty() || currentSortType_ == "default") {
-        if (defaultSortAction)
-            defaultSortAction->setChecked(true);
-    } else if (currentSortType_ == "borrowCount" && borrowCountSortAction) {
-        borrowCountSortAction->setChecked(true);
+    if ((currentSortType_.isEmpty() || currentSortType_ == "default") && defaultSortAction) {
+        defaultSortAction->setChecked(true);
     }
 
     connect(sortActionGroup_, &QActionGroup::triggered, this, &MainWindow::onSortChanged);
@@ -2190,6 +2238,16 @@ void MainWindow::updateHeaderLabels()
     QString borrowCountLabel = QStringLiteral("借阅次数 ▼");  // 默认显示
     if (currentSortType_ == "borrowCount") {
         borrowCountLabel = QStringLiteral("借阅次数 ▼\n热门排序");    // 按借阅次数排序
+    } else if (currentSortType_ == "price") {
+        borrowCountLabel = QStringLiteral("借阅次数 ▼\n价格排序");    // 按价格排序
+    } else if (currentSortType_ == "inDate") {
+        borrowCountLabel = QStringLiteral("借阅次数 ▼\n最新入库");    // 按入库日期排序
+    } else if (currentSortType_ == "name") {
+        borrowCountLabel = QStringLiteral("借阅次数 ▼\n书名排序");    // 按书名排序
+    } else if (currentSortType_ == "category") {
+        borrowCountLabel = QStringLiteral("借阅次数 ▼\n类别排序");    // 按类别排序
+    } else if (currentSortType_ == "location") {
+        borrowCountLabel = QStringLiteral("借阅次数 ▼\n馆藏地址排序"); // 按馆藏地址排序
     } else if (currentSortType_ == "default") {
         borrowCountLabel = QStringLiteral("借阅次数 ▼\n默认排序");    // 默认排序方式
     }
@@ -2332,186 +2390,19 @@ void MainWindow::showFilterMenu(QMenu *menu, int section)
  */
 void MainWindow::displayBooks(const QVector<Book> &booksToShow)
 {
-    // 表格清空：移除所有现有行，准备重新填充数据
-    model_->removeRows(0, model_->rowCount());
-
-    // 数据填充：逐行处理图书数据
-    for (int row = 0; row < booksToShow.size(); ++row) {
-        const Book &b = booksToShow[row];  // 获取当前图书引用
-        QList<QStandardItem *> rowItems;   // 创建表格行数据容器
-
-        // 基础信息列：图书的核心属性信息
-        rowItems << new QStandardItem(b.indexId);                                    // 索引号
-        rowItems << new QStandardItem(b.name);                                      // 书名
-        rowItems << new QStandardItem(b.author);                                    // 作者
-        rowItems << new QStandardItem(b.publisher);                                 // 出版社
-        rowItems << new QStandardItem(b.location);                                  // 馆藏地址
-        rowItems << new QStandardItem(b.category);                                  // 类别
-
-        // 副本信息列：图书的数量和价格信息
-        int totalCopies = library_.getTotalCopyCount(b.indexId);                    // 计算总副本数
-        rowItems << new QStandardItem(QString::number(totalCopies));                // 副本数量
-
-        rowItems << new QStandardItem(QString::number(b.price, 'f', 2));           // 价格，保留2位小数
-        rowItems << new QStandardItem(b.inDate.toString("yyyy-MM-dd"));             // 入库日期
-
-        // 归还日期列：个性化显示，仅对学生用户显示其借阅信息
-        QString returnDateStr = "";
-        if (!currentUsername_.isEmpty() && !isAdminMode_) {                         // 学生用户条件判断
-            // 获取当前学生的所有借阅副本
-            QVector<BookCopy> borrowedCopies = library_.getUserBorrowedCopies(currentUsername_);
-            // 查找该书的借阅记录
-            for (const BookCopy &copy : borrowedCopies) {
-                if (copy.indexId == b.indexId) {                                   // 找到该书的借阅记录
-                    returnDateStr = copy.dueDate.toString("yyyy-MM-dd");            // 显示归还日期
-                    break;                                                          // 找到一个即可（正常情况下学生不会重复借阅同一本书）
-                }
-            }
-        }
-        rowItems << new QStandardItem(returnDateStr);                               // 归还日期（学生可见）
-
-        // 统计信息列：借阅次数和状态信息
-        rowItems << new QStandardItem(QString::number(b.borrowCount));              // 借阅次数
-
-        // 状态列：根据副本可用性动态计算状态
-        int availableCopies = library_.getAvailableCopyCount(b.indexId);            // 计算可用副本数
-        QString statusText = (availableCopies > 0) ? QStringLiteral("可借") : QStringLiteral("不可借");
-        rowItems << new QStandardItem(statusText);                                  // 状态
-
-        // 行数据添加：将完整行数据添加到表格模型中
-        model_->appendRow(rowItems);
-    }
+    // 数据填充：模型只记录每行对应的图书，单元格在显示时按需计算
+    model_->setBooks(booksToShow);
 
     // 状态栏更新：更新统计信息显示当前数据状态
     updateStatusBar();
 }
 
-QJsonArray MainWindow::loadUsersJson() const
-{
-    QJsonArray array;
-    if (usersFilePath_.isEmpty())
-        return array;
-
-    QFile file(usersFilePath_);
-    if (!file.open(QIODevice::ReadOnly)) {
-        return array;
-    }
-    const QByteArray data = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (doc.isArray()) {
-        array = doc.array();
-    }
-    return array;
-}
-
-bool MainWindow::saveUsersJson(const QJsonArray &array) const
-{
-    if (usersFilePath_.isEmpty())
-        return false;
-    QFile file(usersFilePath_);
-    if (!file.open(QIODevice::WriteOnly)) {
-        return false;
-    }
-    QJsonDocument doc(array);
-    file.write(doc.toJson());
-    file.close();
-    return true;
-}
-
-
 bool MainWindow::currentUserHasBorrowed(const QString &indexId) const
 {
     if (currentUsername_.isEmpty())
         return false;
 
-    QJsonArray array = loadUsersJson();
-    for (const QJsonValue &value : array) {
-        if (!value.isObject())
-            continue;
-        QJsonObject obj = value.toObject();
-        if (obj.value("username").toString() != currentUsername_)
-            continue;
-        QJsonArray borrows = obj.value("borrows").toArray();
-        for (const QJsonValue &bVal : borrows) {
-            if (!bVal.isObject())
-                continue;
-            QJsonObject bObj = bVal.toObject();
-            if (bObj.value("indexId").toString() == indexId &&
-                !bObj.value("returned").toBool(false)) {
-                return true;
-            }
-        }
-        break;
-    }
-    return false;
-}
-
-void MainWindow::addBorrowRecordForCurrentUser(const Book &book, const QDate &borrowDate, const QDate &dueDate)
-{
-    if (currentUsername_.isEmpty())
-        return;
-
-    QJsonArray array = loadUsersJson();
-    for (int i = 0; i < array.size(); ++i) {
-        if (!array.at(i).isObject())
-            continue;
-        QJsonObject obj = array.at(i).toObject();
-        if (obj.value("username").toString() != currentUsername_)
-            continue;
-
-        QJsonArray borrows = obj.value("borrows").toArray();
-        QJsonObject rec;
-        rec["indexId"] = book.indexId;
-        rec["bookName"] = book.name;
-        rec["borrowDate"] = borrowDate.toString(Qt::ISODate);
-        rec["dueDate"] = dueDate.toString(Qt::ISODate);
-        rec["returnDate"] = QString();
-        rec["returned"] = false;
-        borrows.append(rec);
-        obj["borrows"] = borrows;
-        array[i] = obj;
-        break;
-    }
-    saveUsersJson(array);
-}
-
-void MainWindow::markBorrowRecordReturnedForCurrentUser(const QString &indexId, const QDate &returnDate)
-{
-    if (currentUsername_.isEmpty())
-        return;
-
-    QJsonArray array = loadUsersJson();
-    for (int i = 0; i < array.size(); ++i) {
-        if (!array.at(i).isObject())
-            continue;
-        QJsonObject obj = array.at(i).toObject();
-        if (obj.value("username").toString() != currentUsername_)
-            continue;
-
-        QJsonArray borrows = obj.value("borrows").toArray();
-        bool changed = false;
-        for (int j = 0; j < borrows.size(); ++j) {
-            if (!borrows.at(j).isObject())
-                continue;
-            QJsonObject bObj = borrows.at(j).toObject();
-            if (bObj.value("indexId").toString() == indexId &&
-                !bObj.value("returned").toBool(false)) {
-                bObj["returned"] = true;
-                bObj["returnDate"] = returnDate.toString(Qt::ISODate);
-                borrows[j] = bObj;
-                changed = true;
-                break;
-            }
-        }
-        if (changed) {
-            obj["borrows"] = borrows;
-            array[i] = obj;
-            break;
-        }
-    }
-    saveUsersJson(array);
+    return CirculationLog::instance().hasOpenBorrow(currentUsername_, indexId);
 }
 
 QString MainWindow::borrowRecordsForCurrentUserText() const
@@ -2520,44 +2411,26 @@ QString MainWindow::borrowRecordsForCurrentUserText() const
         return QStringLiteral("当前未登录学生用户。");
     }
 
-    QJsonArray array = loadUsersJson();
-    for (const QJsonValue &value : array) {
-        if (!value.isObject())
-            continue;
-        QJsonObject obj = value.toObject();
-        if (obj.value("username").toString() != currentUsername_)
-            continue;
-
-        QJsonArray borrows = obj.value("borrows").toArray();
-        if (borrows.isEmpty()) {
-            return QStringLiteral("你还没有任何借阅记录。");
-        }
+    // 学生查看本人记录只读热日志（未还和近期记录）
+    const QVector<BorrowRecord> records = CirculationLog::instance().recordsForUser(currentUsername_);
+    if (records.isEmpty()) {
+        return QStringLiteral("你还没有任何借阅记录。");
+    }
 
-        QStringList lines;
-        for (const QJsonValue &bVal : borrows) {
-            if (!bVal.isObject())
-                continue;
-            QJsonObject bObj = bVal.toObject();
-            const QString bookName = bObj.value("bookName").toString();
-            const QString indexId = bObj.value("indexId").toString();
-            const QString borrowDate = bObj.value("borrowDate").toString();
-            const QString dueDate = bObj.value("dueDate").toString();
-            const QString returnDate = bObj.value("returnDate").toString();
-            const bool returned = bObj.value("returned").toBool(false);
-
-            QString line = QStringLiteral("《%1》(索引:%2)\n  借出: %3 | 应还: %4")
-                               .arg(bookName, indexId, borrowDate, dueDate);
-            if (returned) {
-                line += QStringLiteral(" | 实还: %1").arg(returnDate);
-            } else {
-                line += QStringLiteral(" | 状态: 未还");
-            }
-            lines << line;
+    QStringList lines;
+    for (const BorrowRecord &record : records) {
+        QString line = QStringLiteral("《%1》(索引:%2)\n  借出: %3 | 应还: %4")
+                           .arg(record.bookName, record.indexId,
+                                record.borrowDate.toString(Qt::ISODate),
+                                record.dueDate.toString(Qt::ISODate));
+        if (record.returned) {
+            line += QStringLiteral(" | 实还: %1").arg(record.returnDate.toString(Qt::ISODate));
+        } else {
+            line += QStringLiteral(" | 状态: 未还");
         }
-        return lines.join("\n\n");
+        lines << line;
     }
-
-    return QStringLiteral("未找到当前用户的借阅记录。");
+    return lines.join("\n\n");
 }
 
 QString MainWindow::borrowHistoryForBookText(const QString &indexId) const
@@ -2566,42 +2439,24 @@ QString MainWindow::borrowHistoryForBookText(const QString &indexId) const
         return QStringLiteral("未选择图书。");
     }
 
-    QJsonArray array = loadUsersJson();
-    QStringList lines;
-
-    for (const QJsonValue &value : array) {
-        if (!value.isObject())
-            continue;
-        QJsonObject obj = value.toObject();
-        const QString username = obj.value("username").toString();
-        QJsonArray borrows = obj.value("borrows").toArray();
-
-        for (const QJsonValue &bVal : borrows) {
-            if (!bVal.isObject())
-                continue;
-            QJsonObject bObj = bVal.toObject();
-            if (bObj.value("indexId").toString() != indexId)
-                continue;
-
-            const QString bookName = bObj.value("bookName").toString();
-            const QString borrowDate = bObj.value("borrowDate").toString();
-            const QString dueDate = bObj.value("dueDate").toString();
-            const QString returnDate = bObj.value("returnDate").toString();
-            const bool returned = bObj.value("returned").toBool(false);
-
-            QString line = QStringLiteral("用户: %1\n《%2》(索引:%3)\n  借出: %4 | 应还: %5")
-                               .arg(username, bookName, indexId, borrowDate, dueDate);
-            if (returned) {
-                line += QStringLiteral(" | 实还: %1").arg(returnDate);
-            } else {
-                line += QStringLiteral(" | 状态: 未还");
-            }
-            lines << line;
-        }
+    // 管理员查看的是完整历史，需要合并归档
+    const QVector<BorrowRecord> records = CirculationLog::instance().recordsForBook(indexId, true);
+    if (records.isEmpty()) {
+        return QStringLiteral("该图书暂无任何借阅记录。");
     }
 
-    if (lines.isEmpty()) {
-        return QStringLiteral("该图书暂无任何借阅记录。");
+    QStringList lines;
+    for (const BorrowRecord &record : records) {
+        QString line = QStringLiteral("用户: %1\n《%2》(索引:%3)\n  借出: %4 | 应还: %5")
+                           .arg(record.username, record.bookName, indexId,
+                                record.borrowDate.toString(Qt::ISODate),
+                                record.dueDate.toString(Qt::ISODate));
+        if (record.returned) {
+            line += QStringLiteral(" | 实还: %1").arg(record.returnDate.toString(Qt::ISODate));
+        } else {
+            line += QStringLiteral(" | 状态: 未还");
+        }
+        lines << line;
     }
     return lines.join("\n\n");
 }
@@ -2684,8 +2539,8 @@ void MainWindow::onShowBookBorrowHistory()
     }
 
     int row = selectedIndexes.first().row();
-    QString indexId = model_->item(row, 0)->text();
-    QString bookName = model_->item(row, 1)->text();
+    QString indexId = model_->indexIdAt(row);
+    QString bookName = model_->data(model_->index(row, BookTableModel::NameColumn)).toString();
 
     // 获取所有副本
     QVector<BookCopy> allCopies = library_.getBookCopies(indexId);
@@ -2777,11 +2632,13 @@ void MainWindow::onShowBookBorrowHistory()
  * - name: 在书名中搜索，支持模糊匹配
  * - author: 在作者名中搜索，支持模糊匹配
  * - publisher: 在出版社中搜索，支持模糊匹配
- * - all: 在所有字段中搜索，实现全局搜索
+ * - pinyin: 按全拼或首字母前缀搜索书名和作者（如 hlm、honglou 找到"红楼梦"）
+ * - typo: 容错搜索英文书名和作者，按编辑距离、借阅次数排序（如 Silberchatz）
+ * - all: 在所有字段（含内容简介）中搜索，实现全局搜索
  *
  * 搜索特性：
- * - 不区分大小写：使用小写比较实现大小写不敏感搜索
- * - 模糊匹配：使用contains函数实现部分匹配
+ * - 不区分大小写：索引和查询都统一转为小写
+ * - 倒排索引：中文按单字/双字、英文按单词前缀匹配，多个关键词求交集并按相关度排序
  * - 多字段搜索：支持在不同字段中进行搜索
  * - 筛选保持：搜索结果会应用当前的筛选条件
  * - 排序保持：搜索结果会应用当前的排序设置
@@ -2791,120 +2648,71 @@ void MainWindow::onShowBookBorrowHistory()
  */
 void MainWindow::performFuzzySearch(const QString &keyword, const QString &searchMode)
 {
-
-    // 搜索准备：清空现有表格，准备显示搜索结果
-    model_->removeRows(0, model_->rowCount());
-
-    // 数据源获取：获取所有图书数据作为搜索范围
-    QVector<Book> allBooks = library_.getAll();
-    QVector<Book> matchedBooks;     // 存储匹配的图书
-
-    // 关键词预处理：转换为小写以实现不区分大小写的搜索
-    QString lowerKeyword = keyword.toLower();
-
-    // 搜索匹配：遍历所有图书，根据搜索模式进行匹配
-    for (const Book &book : allBooks) {
-        bool match = false;
-
-        // 根据搜索模式进行不同的匹配逻辑
-        if (searchMode == "indexId") {
-            // 索引号搜索：在索引号中进行匹配
-            match = book.indexId.toLower().contains(lowerKeyword);
-        } else if (searchMode == "name") {
-            // 书名搜索：在书名中进行匹配
-            match = book.name.toLower().contains(lowerKeyword);
-        } else if (searchMode == "author") {
-            // 作者搜索：在作者名中进行匹配
-            match = book.author.toLower().contains(lowerKeyword);
-        } else if (searchMode == "publisher") {
-            // 出版社搜索：在出版社中进行匹配
-            match = book.publisher.toLower().contains(lowerKeyword);
-        } else if (searchMode == "all") {
-            // 全局搜索：在所有字段中进行匹配
-            match = (book.name.toLower().contains(lowerKeyword) ||
-                    book.indexId.toLower().contains(lowerKeyword) ||
-                    book.author.toLower().contains(lowerKeyword) ||
-                    book.publisher.toLower().contains(lowerKeyword) ||
-                    book.category.toLower().contains(lowerKeyword) ||
-                    book.location.toLower().contains(lowerKeyword));
-        }
-
-        // 添加匹配结果：如果匹配则添加到结果列表
-        if (match) {
-            matchedBooks.append(book);
-        }
-    }
-
-    // 排序应用：根据当前的排序设置对搜索结果进行排序
-    if (currentSortType_ == "borrowCount") {
-        std::sort(matchedBooks.begin(), matchedBooks.end(), [](const Book &a, const Book &b) {
-            return a.borrowCount > b.borrowCount; // 按借阅次数从高到低排序
-        });
+    // 索引检索：结果已按相关度排序，无需扫描全部图书
+    QVector<int> matchedSlots;
+    if (searchMode == "pinyin") {
+        matchedSlots = library_.searchPinyinSlots(keyword);
+    } else if (searchMode == "typo") {
+        matchedSlots = library_.searchFuzzySlots(keyword);
+    } else {
+        matchedSlots = library_.searchSlots(keyword, fieldMaskForSearchMode(searchMode));
     }
 
-    // 对搜索结果应用筛选条件并显示
-    for (const Book &book : matchedBooks) {
-        QList<QStandardItem *> rowItems;
-
-        // 索引号列
-        QStandardItem *indexItem = new QStandardItem(book.indexId);
-        rowItems << indexItem;
-
-        // 书名列
-        QStandardItem *nameItem = new QStandardItem(book.name);
-        rowItems << nameItem;
-
-        // 先获取副本数量用于筛选条件判断
-        int totalCopies = library_.getTotalCopyCount(book.indexId);
-        int availableCopies = library_.getAvailableCopyCount(book.indexId);
-
-        // 应用筛选条件
-        if (!categoryFilter_.isEmpty() && book.category != categoryFilter_) {
-            continue;
-        }
-        if (!locationFilter_.isEmpty() && book.location != locationFilter_) {
-            continue;
-        }
-        // 修复筛选逻辑
-        if (statusFilter_ == "available" && availableCopies <= 0) {
-            continue; // 只显示有可用副本的图书
-        }
-        if (statusFilter_ == "borrowed" && availableCopies >= totalCopies) {
-            continue; // 只显示没有可用副本的图书（即全部被借走）
-        }
+    showSearchResults(matchedSlots, false);
+}
 
-        // 其他列
-        rowItems << new QStandardItem(book.author);
-        rowItems << new QStandardItem(book.publisher);
-        rowItems << new QStandardItem(book.location);
-        rowItems << new QStandardItem(book.category);
-        rowItems << new QStandardItem(QString::number(totalCopies));
-
-        rowItems << new QStandardItem(QString::number(book.price, 'f', 2));
-        rowItems << new QStandardItem(book.inDate.toString("yyyy-MM-dd"));
-
-        // 归还日期：根据当前用户显示
-        QString returnDateStr = "";
-        if (!currentUsername_.isEmpty() && !isAdminMode_) {
-            QVector<BookCopy> borrowedCopies = library_.getUserBorrowedCopies(currentUsername_);
-            for (const BookCopy &copy : borrowedCopies) {
-                if (copy.indexId == book.indexId) {
-                    returnDateStr = copy.dueDate.toString("yyyy-MM-dd");
-                    break;
-                }
-            }
-        }
-        rowItems << new QStandardItem(returnDateStr);
+/**
+ * @brief 由当前的类别、馆藏地址、可借状态筛选和排序方式生成查询条件
+ */
+LibraryQuery MainWindow::currentFilterQuery() const
+{
+    LibraryQuery query;
+    query.category = categoryFilter_;
+    query.location = locationFilter_;
+    query.status = LibraryQuery::statusFromString(statusFilter_);
+    query.sort = LibraryQuery::sortFromString(currentSortType_);
+    return query;
+}
 
-        rowItems << new QStandardItem(QString::number(book.borrowCount));
+/**
+ * @brief 搜索模式映射到全文索引的字段
+ */
+int MainWindow::fieldMaskForSearchMode(const QString &searchMode)
+{
+    if (searchMode == "indexId") {
+        return SearchIndex::IndexIdField;      // 索引号搜索
+    } else if (searchMode == "name") {
+        return SearchIndex::NameField;         // 书名搜索
+    } else if (searchMode == "author") {
+        return SearchIndex::AuthorField;       // 作者搜索
+    } else if (searchMode == "publisher") {
+        return SearchIndex::PublisherField;    // 出版社搜索
+    } else if (searchMode == "pinyin" || searchMode == "typo") {
+        return SearchIndex::NameField | SearchIndex::AuthorField;
+    }
+    return SearchIndex::AllFields;
+}
 
-        QString statusText = (availableCopies > 0) ? QStringLiteral("可借") : QStringLiteral("不可借");
-        rowItems << new QStandardItem(statusText);
+/**
+ * @brief 对已排好相关度的搜索结果应用排序和筛选条件并显示
+ *
+ * @param matchedSlots 按相关度排序的槽位号
+ * @param paged 是否分页送入表格（边输入边搜索时使用，先显示第一屏）
+ */
+void MainWindow::showSearchResults(const QVector<int> &matchedSlots, bool paged)
+{
+    // 在搜索结果中应用当前的筛选和排序条件（借阅次数相同时保持相关度顺序）
+    LibraryQuery query = currentFilterQuery();
+    query.setCandidates(matchedSlots);
+    const QVector<int> rows = library_.query(query);
 
-        model_->appendRow(rowItems);
+    if (paged) {
+        model_->setRowsPaged(rows);
+    } else {
+        model_->setRows(rows);
     }
 
-    QString resultText = QStringLiteral("找到 %1 本匹配的图书").arg(matchedBooks.size());
+    QString resultText = QStringLiteral("找到 %1 本匹配的图书").arg(matchedSlots.size());
     statusBar()->showMessage(resultText, 5000);
 
     // 更新表头以显示当前排序状态
@@ -3005,25 +2813,11 @@ void MainWindow::onTableDoubleClicked(const QModelIndex &index)
     // 获取行号
     int row = index.row();
 
-    // 获取索引号（第0列）
-    QModelIndex indexIdIndex = model_->index(row, 0);
-    QString indexId = model_->data(indexIdIndex).toString();
-
-    // 根据索引号查找图书
-    const QVector<Book> &allBooks = library_.getAll();
-    Book targetBook;
-    bool found = false;
-
-    for (const Book &book : allBooks) {
-        if (book.indexId == indexId) {
-            targetBook = book;
-            found = true;
-            break;
-        }
-    }
-
-    if (found) {
-        // 显示图书详情对话框
+    // 模型行直接对应存储中的图书
+    const Book *book = model_->bookAt(row);
+    if (book) {
+        // 显示图书详情对话框（传入副本，避免对话框期间存储变化导致指针失效）
+        Book targetBook = *book;
         BookDetailDialog dialog(targetBook, this);
         dialog.exec();
     }
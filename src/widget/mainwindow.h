@@ -14,7 +14,6 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QStandardItemModel>
 #include <QTableView>
 #include <QPushButton>
 #include <QMenu>
@@ -23,13 +22,16 @@
 #include "../utils/librarymanager.h"
 #include "../utils/bookcopy.h"
 #include "bookdetaildialog.h"
+#include "booktablemodel.h"
 #include "../utils/bookdisplay.h"
+#include "../utils/asyncsearch.h"
 
 // Qt组件前向声明，减少编译依赖
 QT_BEGIN_NAMESPACE
 class QToolBar;
 class QScrollArea;
 class QDockWidget;
+class QTimer;
 namespace Ui
 {
     class MainWindow;
@@ -79,6 +81,8 @@ private slots:
     void toggleTheme();
     void onSearch();
     void onSearchModeChanged();
+    void onSearchTextIdle();     // 输入停顿后在后台执行搜索
+    void onAsyncSearchFinished(const QString &keyword, const QString &mode, const QVector<int> &slotList);
     void onAddBook();
     void onEditBook();
     void onDeleteBook();
@@ -130,12 +134,16 @@ private:
     // 数据与显示
     void loadData();     // 加载数据
     void refreshTable(); // 刷新表格显示
+    void refreshAfterCirculation(); // 借还/续借后的轻量刷新
 
     // --- 新增：筛选并显示特定图书列表的辅助函数 ---
     void displayBooks(const QVector<Book> &booksToShow);
 
     // 搜索功能增强
     void performFuzzySearch(const QString &keyword, const QString &searchMode);
+    void showSearchResults(const QVector<int> &matchedSlots, bool paged);
+    static int fieldMaskForSearchMode(const QString &searchMode);
+    LibraryQuery currentFilterQuery() const;   // 当前筛选与排序条件
     // void highlightMatchingText(const QString &text, const QString &keyword, QStandardItem *item);
     // QVector<BookCopy> searchCopiesByKeyword(const QString &keyword);
 
@@ -144,18 +152,14 @@ private:
     void showBookDialog(const Book &book = Book(), bool isEdit = false);
 
     // 用户与借阅相关的辅助函数
-    QJsonArray loadUsersJson() const;
-    bool saveUsersJson(const QJsonArray &array) const;
     bool currentUserHasBorrowed(const QString &indexId) const;
-    void addBorrowRecordForCurrentUser(const Book &book, const QDate &borrowDate, const QDate &dueDate);
-    void markBorrowRecordReturnedForCurrentUser(const QString &indexId, const QDate &returnDate);
     QString borrowRecordsForCurrentUserText() const;
     QString borrowHistoryForBookText(const QString &indexId) const;
 
     // UI成员
     Ui::MainWindow *ui;
-    LibraryManager library_;    // 核心数据管理器
-    QStandardItemModel *model_; // 表格模型
+    LibraryManager &library_;   // 核心数据管理器（全局单例，图书只在DatabaseManager中存一份）
+    BookTableModel *model_;     // 表格模型（按需读取数据的虚拟模型）
     QTableView *tableView_;     // 表格视图
     QLineEdit *searchEdit_;
     QPushButton *searchButton_;
@@ -178,6 +182,8 @@ private:
     QString currentSearchKeyword_;   // 当前搜索关键词
     QString currentSearchMode_;      // 当前搜索模式
     bool isSearchActive_ = false;    // 是否处于搜索状态
+    AsyncSearch *asyncSearch_ = nullptr;        // 边输入边搜索的后台执行器
+    QTimer *searchDebounceTimer_ = nullptr;     // 输入防抖定时器
 
     // 状态和主题
     bool isDarkMode_;